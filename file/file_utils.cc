@@ -16,10 +16,14 @@
 #include "file/file_utils.h"
 
 #include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <string>
 #include <vector>
 
@@ -31,13 +35,32 @@ string ReadFileOrDie(const string& path) {
   FILE* file = fopen(path.c_str(), "r");
   PCHECK(file) << ": opening " << path;
 
-  string result;
-  size_t bytes_read;
-  char buf[1 << 10];
-  while ((bytes_read = fread(buf, 1, arraysize(buf), file))) {
-    result += string(buf, bytes_read);
+  // Size the result up front using the file's current size, so that the
+  // common case is a single read with no reallocation. Keep reading until EOF
+  // in case the file grows in the meantime.
+  struct stat stat_buf;
+  PCHECK(fstat(fileno(file), &stat_buf) == 0) << ": stat-ing " << path;
+
+  string result(stat_buf.st_size, '\0');
+  size_t total_bytes_read = 0;
+  while (1) {
+    if (total_bytes_read == result.size()) {
+      result.resize(result.size() + (1 << 16));
+    }
+
+    const size_t bytes_read =
+        fread(
+            &result[total_bytes_read],
+            1,
+            result.size() - total_bytes_read,
+            file);
+
+    if (!bytes_read) break;
+    total_bytes_read += bytes_read;
   }
 
+  result.resize(total_bytes_read);
+
   // Make sure we stopped because of EOF, not an error.
   CHECK_EQ(ferror(file), 0) << "Error reading file: " << path;
   CHECK_NE(feof(file), 0) << "Expected eof.";
@@ -70,6 +93,76 @@ void WriteStringToFileOrDie(const string& s, const string& path) {
   CHECK_ERR(fclose(file));
 }
 
+MappedFile::MappedFile()
+    : data_(""),
+      size_(0) {
+}
+
+MappedFile::MappedFile(const string& path)
+    : data_(""),
+      size_(0) {
+  string error;
+  CHECK(Map(path, false, &error)) << error;
+}
+
+MappedFile* MappedFile::Open(
+    const string& path,
+    bool copy_on_write,
+    string* error) {
+  MappedFile* const file = new MappedFile;
+  if (!file->Map(path, copy_on_write, error)) {
+    delete file;
+    return NULL;
+  }
+
+  return file;
+}
+
+bool MappedFile::Map(
+    const string& path,
+    bool copy_on_write,
+    string* error) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    *error = "Error opening " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) != 0) {
+    *error = "Error stat-ing " + path + ": " + strerror(errno);
+    PCHECK(close(fd) == 0);
+    return false;
+  }
+
+  // mmap refuses to create empty mappings, so leave empty files pointing at
+  // the empty string above. Private writable mappings are copied on write.
+  if (stat_buf.st_size > 0) {
+    const int prot = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* const mapping =
+        mmap(NULL, stat_buf.st_size, prot, MAP_PRIVATE, fd, 0);
+
+    if (mapping == MAP_FAILED) {
+      *error = "Error mapping " + path + ": " + strerror(errno);
+      PCHECK(close(fd) == 0);
+      return false;
+    }
+
+    data_ = static_cast<const char*>(mapping);
+    size_ = stat_buf.st_size;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  PCHECK(close(fd) == 0);
+  return true;
+}
+
+MappedFile::~MappedFile() {
+  if (size_) {
+    PCHECK(munmap(const_cast<char*>(data_), size_) == 0);
+  }
+}
+
 string Basename(const string& path) {
   const char* c_str = path.c_str();
   const char* sep = strrchr(c_str, '/');
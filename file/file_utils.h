@@ -19,10 +19,46 @@
 #define FILE_FILE_UTILS_H_
 
 #include "base/basictypes.h"
+#include "base/macros.h"
 
 // Return the contents of the file at the given path, crashing on failure.
 string ReadFileOrDie(const string& path);
 
+// A read-only memory mapping of the contents of a file, valid for as long as
+// the object exists. Use this instead of ReadFileOrDie to avoid copying large
+// files.
+class MappedFile {
+ public:
+  // Map the file at the given path, crashing on failure.
+  explicit MappedFile(const string& path);
+  ~MappedFile();
+
+  // Map the file at the given path, returning NULL and filling in *error on
+  // failure. If copy_on_write is true, the mapping may be modified through
+  // mutable_data without affecting the file.
+  static MappedFile* Open(
+      const string& path,
+      bool copy_on_write,
+      string* error);
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // The contents of a non-empty copy-on-write mapping.
+  char* mutable_data() { return const_cast<char*>(data_); }
+
+ private:
+  MappedFile();
+
+  // Map the file, returning false and filling in *error on failure.
+  bool Map(const string& path, bool copy_on_write, string* error);
+
+  const char* data_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
 // Write the supplied string to the given path, crashing on failure.
 void WriteStringToFileOrDie(const string& str, const string& path);
 
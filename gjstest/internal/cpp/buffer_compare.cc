@@ -0,0 +1,132 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/buffer_compare.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace gjstest {
+
+// Buffers are compared a block at a time with memcmp, which the C library
+// implements with vector instructions. Only a block that differs is searched
+// more carefully.
+static const size_t kBlockSize = 256;
+
+size_t FindFirstByteDifference(const void* a, const void* b, size_t length) {
+  const uint8* const a_bytes = static_cast<const uint8*>(a);
+  const uint8* const b_bytes = static_cast<const uint8*>(b);
+
+  size_t offset = 0;
+  while (offset < length) {
+    const size_t block = std::min(kBlockSize, length - offset);
+    if (memcmp(a_bytes + offset, b_bytes + offset, block) != 0) break;
+    offset += block;
+  }
+
+  // Narrow down to the word containing the difference, then the byte.
+  for (; offset + sizeof(uint64) <= length; offset += sizeof(uint64)) {
+    uint64 a_word;
+    uint64 b_word;
+    memcpy(&a_word, a_bytes + offset, sizeof(a_word));
+    memcpy(&b_word, b_bytes + offset, sizeof(b_word));
+    if (a_word != b_word) break;
+  }
+
+  for (; offset < length; ++offset) {
+    if (a_bytes[offset] != b_bytes[offset]) break;
+  }
+
+  return offset;
+}
+
+// Map the bits of a float to an unsigned integer such that the order of the
+// integers matches the order of the floats, and adjacent floats map to adjacent
+// integers. Both zeroes map to the same integer.
+template <typename Bits>
+static Bits SignAndMagnitudeToBiased(Bits bits) {
+  const Bits sign = static_cast<Bits>(1) << (sizeof(Bits) * 8 - 1);
+  return (bits & sign) ? ~bits + 1 : sign | bits;
+}
+
+template <typename Float, typename Bits>
+static uint64 UlpDistanceImpl(Float a, Float b) {
+  if (a != a || b != b) return kuint64max;
+
+  Bits a_bits;
+  Bits b_bits;
+  memcpy(&a_bits, &a, sizeof(a_bits));
+  memcpy(&b_bits, &b, sizeof(b_bits));
+
+  const Bits a_biased = SignAndMagnitudeToBiased(a_bits);
+  const Bits b_biased = SignAndMagnitudeToBiased(b_bits);
+  return a_biased >= b_biased ? a_biased - b_biased : b_biased - a_biased;
+}
+
+uint64 UlpDistance(float a, float b) {
+  return UlpDistanceImpl<float, uint32>(a, b);
+}
+
+uint64 UlpDistance(double a, double b) {
+  return UlpDistanceImpl<double, uint64>(a, b);
+}
+
+template <typename Float>
+static size_t FindFirstFloatDifferenceImpl(
+    const Float* a,
+    const Float* b,
+    size_t count,
+    uint64 max_ulps) {
+  const size_t elements_per_block = kBlockSize / sizeof(Float);
+
+  size_t index = 0;
+  while (index < count) {
+    const size_t block = std::min(elements_per_block, count - index);
+
+    // Elements with the same bits always match.
+    if (memcmp(a + index, b + index, block * sizeof(Float)) == 0) {
+      index += block;
+      continue;
+    }
+
+    for (const size_t end = index + block; index < end; ++index) {
+      if (memcmp(a + index, b + index, sizeof(Float)) == 0) continue;
+
+      // UlpDistance is kuint64max for NaNs, which never match anything else.
+      const uint64 distance = UlpDistance(a[index], b[index]);
+      if (distance == kuint64max || distance > max_ulps) return index;
+    }
+  }
+
+  return count;
+}
+
+size_t FindFirstFloatDifference(
+    const float* a,
+    const float* b,
+    size_t count,
+    uint64 max_ulps) {
+  return FindFirstFloatDifferenceImpl(a, b, count, max_ulps);
+}
+
+size_t FindFirstDoubleDifference(
+    const double* a,
+    const double* b,
+    size_t count,
+    uint64 max_ulps) {
+  return FindFirstFloatDifferenceImpl(a, b, count, max_ulps);
+}
+
+}  // namespace gjstest
@@ -0,0 +1,57 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Kernels for comparing the contents of typed arrays and array buffers, used by
+// the bytesEqual and typedArrayEquals matchers. They find the first
+// difference without visiting elements one at a time through v8.
+
+#ifndef GJSTEST_INTERNAL_CPP_BUFFER_COMPARE_H_
+#define GJSTEST_INTERNAL_CPP_BUFFER_COMPARE_H_
+
+#include <stddef.h>
+
+#include "base/integral_types.h"
+
+namespace gjstest {
+
+// Return the offset of the first byte that differs between the supplied
+// buffers, each of which has the supplied length, or length if they are the
+// same.
+size_t FindFirstByteDifference(const void* a, const void* b, size_t length);
+
+// Return the index of the first element that differs between the supplied
+// arrays, each of which has the supplied number of elements, or count if there
+// is none. Elements match if they have the same bits, or if neither is NaN and
+// they are at most max_ulps units in the last place apart. In particular, 0
+// and -0 match.
+size_t FindFirstFloatDifference(
+    const float* a,
+    const float* b,
+    size_t count,
+    uint64 max_ulps);
+
+size_t FindFirstDoubleDifference(
+    const double* a,
+    const double* b,
+    size_t count,
+    uint64 max_ulps);
+
+// Return the number of representable values between a and b, or kuint64max if
+// either is NaN.
+uint64 UlpDistance(float a, float b);
+uint64 UlpDistance(double a, double b);
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_BUFFER_COMPARE_H_
@@ -0,0 +1,142 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/buffer_compare.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace gjstest {
+
+TEST(FindFirstByteDifferenceTest, EmptyBuffers) {
+  EXPECT_EQ(0, FindFirstByteDifference(NULL, NULL, 0));
+}
+
+TEST(FindFirstByteDifferenceTest, IdenticalBuffers) {
+  std::vector<uint8> a(10000);
+  for (size_t i = 0; i < a.size(); ++i) a[i] = i * 7;
+
+  const std::vector<uint8> b = a;
+  EXPECT_EQ(a.size(), FindFirstByteDifference(a.data(), b.data(), a.size()));
+}
+
+TEST(FindFirstByteDifferenceTest, EveryOffset) {
+  // Try every offset in a buffer spanning several blocks, with lengths that
+  // don't divide evenly into blocks or words.
+  const size_t length = 1000;
+  std::vector<uint8> a(length + 1, 0x5a);
+
+  for (size_t offset = 0; offset < length; ++offset) {
+    std::vector<uint8> b = a;
+    b[offset] ^= 0x01;
+
+    // Compare starting from an unaligned address too.
+    EXPECT_EQ(offset, FindFirstByteDifference(a.data(), b.data(), length));
+    if (offset > 0) {
+      EXPECT_EQ(
+          offset - 1,
+          FindFirstByteDifference(a.data() + 1, b.data() + 1, length - 1));
+    }
+  }
+}
+
+TEST(FindFirstByteDifferenceTest, ReportsFirstOfSeveralDifferences) {
+  std::vector<uint8> a(5000);
+  std::vector<uint8> b = a;
+  b[4000] = 1;
+  b[3001] = 1;
+  b[3000] = 1;
+
+  EXPECT_EQ(3000, FindFirstByteDifference(a.data(), b.data(), a.size()));
+}
+
+TEST(UlpDistanceTest, Floats) {
+  EXPECT_EQ(0, UlpDistance(1.0f, 1.0f));
+  EXPECT_EQ(0, UlpDistance(0.0f, -0.0f));
+  EXPECT_EQ(1, UlpDistance(1.0f, nextafterf(1.0f, 2.0f)));
+  EXPECT_EQ(1, UlpDistance(nextafterf(1.0f, 0.0f), 1.0f));
+  EXPECT_EQ(2, UlpDistance(-std::numeric_limits<float>::denorm_min(),
+                           std::numeric_limits<float>::denorm_min()));
+
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  EXPECT_EQ(kuint64max, UlpDistance(nan, nan));
+  EXPECT_EQ(kuint64max, UlpDistance(1.0f, nan));
+}
+
+TEST(UlpDistanceTest, Doubles) {
+  EXPECT_EQ(0, UlpDistance(1.0, 1.0));
+  EXPECT_EQ(0, UlpDistance(0.0, -0.0));
+  EXPECT_EQ(3, UlpDistance(1.0, nextafter(nextafter(nextafter(1.0, 2), 2), 2)));
+  EXPECT_EQ(2, UlpDistance(-std::numeric_limits<double>::denorm_min(),
+                           std::numeric_limits<double>::denorm_min()));
+
+  const double infinity = std::numeric_limits<double>::infinity();
+  EXPECT_EQ(1, UlpDistance(infinity, std::numeric_limits<double>::max()));
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(kuint64max, UlpDistance(nan, 0.0));
+}
+
+TEST(FindFirstFloatDifferenceTest, ExactMatch) {
+  std::vector<float> a(1000);
+  for (size_t i = 0; i < a.size(); ++i) a[i] = i / 3.0f;
+
+  std::vector<float> b = a;
+  EXPECT_EQ(a.size(), FindFirstFloatDifference(a.data(), b.data(), 1000, 0));
+
+  b[700] = nextafterf(b[700], 1000.0f);
+  EXPECT_EQ(700, FindFirstFloatDifference(a.data(), b.data(), 1000, 0));
+  EXPECT_EQ(1000, FindFirstFloatDifference(a.data(), b.data(), 1000, 1));
+}
+
+TEST(FindFirstFloatDifferenceTest, Tolerance) {
+  std::vector<float> a(100, 1.0f);
+  std::vector<float> b = a;
+
+  // Many small differences within tolerance, then one larger one.
+  for (size_t i = 0; i < b.size(); i += 3) b[i] = nextafterf(1.0f, 2.0f);
+  b[90] = nextafterf(nextafterf(nextafterf(1.0f, 0.0f), 0.0f), 0.0f);
+
+  EXPECT_EQ(0, FindFirstFloatDifference(a.data(), b.data(), 100, 0));
+  EXPECT_EQ(90, FindFirstFloatDifference(a.data(), b.data(), 100, 2));
+  EXPECT_EQ(100, FindFirstFloatDifference(a.data(), b.data(), 100, 3));
+}
+
+TEST(FindFirstFloatDifferenceTest, ZeroesAndNaNs) {
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float a[] = { 0.0f, nan, 1.0f };
+  const float b[] = { -0.0f, nan, nan };
+
+  // Identical NaNs match, but a NaN never matches a number.
+  EXPECT_EQ(2, FindFirstFloatDifference(a, b, 3, 0));
+  EXPECT_EQ(2, FindFirstFloatDifference(a, b, 3, kuint64max));
+}
+
+TEST(FindFirstDoubleDifferenceTest, Tolerance) {
+  std::vector<double> a(1000);
+  for (size_t i = 0; i < a.size(); ++i) a[i] = sqrt(i);
+
+  std::vector<double> b = a;
+  b[999] = nextafter(b[999], 0);
+
+  EXPECT_EQ(999, FindFirstDoubleDifference(a.data(), b.data(), 1000, 0));
+  EXPECT_EQ(1000, FindFirstDoubleDifference(a.data(), b.data(), 1000, 1));
+}
+
+}  // namespace gjstest
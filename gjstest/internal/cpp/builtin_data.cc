@@ -56,7 +56,7 @@ bool GetBuiltinScripts(
 
     NamedScript* script = scripts->add_script();
     script->set_name(Basename(path));
-    script->set_source(ReadFileOrDie(path));
+    script->set_path(path);
   }
 
   return true;
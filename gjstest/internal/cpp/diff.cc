@@ -0,0 +1,179 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/diff.h"
+
+#include <algorithm>
+
+namespace gjstest {
+
+namespace {
+
+// A single insertion or deletion in an edit script, at the point (x, y) in
+// the edit graph, where x is an index into the first sequence and y an index
+// into the second.
+struct Edit {
+  int64 x;
+  int64 y;
+  bool insertion;
+};
+
+// Group the supplied edits, which must be in order, into hunks, offsetting
+// them by the supplied amount.
+std::vector<DiffHunk> MakeHunks(const std::vector<Edit>& edits, size_t offset) {
+  std::vector<DiffHunk> hunks;
+
+  for (const Edit& edit : edits) {
+    const size_t x = offset + edit.x;
+    const size_t y = offset + edit.y;
+
+    // Start a new hunk unless this edit begins where the last one ended.
+    if (hunks.empty() || hunks.back().a_end != x || hunks.back().b_end != y) {
+      hunks.push_back(DiffHunk{x, x, y, y});
+    }
+
+    if (edit.insertion) {
+      ++hunks.back().b_end;
+    } else {
+      ++hunks.back().a_end;
+    }
+  }
+
+  return hunks;
+}
+
+template <typename T>
+std::vector<DiffHunk> ComputeDiffImpl(
+    const T* a,
+    size_t a_length,
+    const T* b,
+    size_t b_length,
+    const DiffBudget& budget,
+    bool* complete) {
+  *complete = true;
+
+  // Skip the common prefix and suffix, which costs nothing but a comparison
+  // each and is often most of the input.
+  size_t prefix = 0;
+  while (prefix < a_length && prefix < b_length && a[prefix] == b[prefix]) {
+    ++prefix;
+  }
+
+  size_t suffix = 0;
+  while (suffix < a_length - prefix &&
+         suffix < b_length - prefix &&
+         a[a_length - suffix - 1] == b[b_length - suffix - 1]) {
+    ++suffix;
+  }
+
+  const T* const a_middle = a + prefix;
+  const T* const b_middle = b + prefix;
+  const int64 n = a_length - prefix - suffix;
+  const int64 m = b_length - prefix - suffix;
+
+  const std::vector<DiffHunk> everything(
+      1,
+      DiffHunk{prefix, prefix + n, prefix, prefix + m});
+
+  if (n == 0 && m == 0) return std::vector<DiffHunk>();
+  if (n == 0 || m == 0) return everything;
+
+  // Myers' greedy algorithm. v[max_d + k] is the furthest x reached so far
+  // on diagonal k = x - y. trace holds a copy of v[max_d - d, max_d + d] after
+  // each round d, for walking the path backwards once the end is reached.
+  const int64 max_d =
+      std::min(n + m, static_cast<int64>(budget.max_edits));
+  std::vector<int64> v(2 * max_d + 3, 0);
+  std::vector<std::vector<int64>> trace;
+
+  uint64 comparisons = 0;
+  for (int64 d = 0; d <= max_d; ++d) {
+    for (int64 k = -d; k <= d; k += 2) {
+      // Extend the furthest path on a neighbouring diagonal by one insertion
+      // or deletion, then follow the diagonal as far as it goes.
+      int64 x;
+      if (k == -d || (k != d && v[max_d + k - 1] < v[max_d + k + 1])) {
+        x = v[max_d + k + 1];
+      } else {
+        x = v[max_d + k - 1] + 1;
+      }
+
+      const int64 x_start = x;
+      int64 y = x - k;
+      while (x < n && y < m && a_middle[x] == b_middle[y]) {
+        ++x;
+        ++y;
+      }
+
+      comparisons += x - x_start + 1;
+      v[max_d + k] = x;
+
+      if (x < n || y < m) continue;
+
+      // We've reached the end. Walk back through the rounds to find the
+      // edits that got us here.
+      std::vector<Edit> edits;
+      for (int64 back_d = d; back_d > 0; --back_d) {
+        const std::vector<int64>& prev = trace[back_d - 1];
+        const int64 prev_offset = back_d - 1;
+        const int64 back_k = x - y;
+
+        const bool insertion =
+            back_k == -back_d ||
+            (back_k != back_d &&
+             prev[prev_offset + back_k - 1] < prev[prev_offset + back_k + 1]);
+        const int64 prev_k = insertion ? back_k + 1 : back_k - 1;
+        const int64 prev_x = prev[prev_offset + prev_k];
+        const int64 prev_y = prev_x - prev_k;
+
+        edits.push_back(Edit{prev_x, prev_y, insertion});
+        x = prev_x;
+        y = prev_y;
+      }
+
+      std::reverse(edits.begin(), edits.end());
+      return MakeHunks(edits, prefix);
+    }
+
+    if (comparisons > budget.max_comparisons) break;
+    trace.emplace_back(v.begin() + max_d - d, v.begin() + max_d + d + 1);
+  }
+
+  *complete = false;
+  return everything;
+}
+
+}  // namespace
+
+std::vector<DiffHunk> ComputeDiff(
+    const uint16* a,
+    size_t a_length,
+    const uint16* b,
+    size_t b_length,
+    const DiffBudget& budget,
+    bool* complete) {
+  return ComputeDiffImpl(a, a_length, b, b_length, budget, complete);
+}
+
+std::vector<DiffHunk> ComputeDiff(
+    const int32* a,
+    size_t a_length,
+    const int32* b,
+    size_t b_length,
+    const DiffBudget& budget,
+    bool* complete) {
+  return ComputeDiffImpl(a, a_length, b, b_length, budget, complete);
+}
+
+}  // namespace gjstest
@@ -0,0 +1,73 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A diff engine for the failure messages of matchers that compare large strings
+// and arrays. It finds the shortest edit script with Myers' algorithm, but
+// gives up after a fixed amount of work so that a failing test can't take
+// minutes to report its failure.
+
+#ifndef GJSTEST_INTERNAL_CPP_DIFF_H_
+#define GJSTEST_INTERNAL_CPP_DIFF_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/integral_types.h"
+
+namespace gjstest {
+
+// A maximal run of differences between two sequences: elements
+// [a_begin, a_end) of the first were replaced by elements [b_begin, b_end) of
+// the second. One of the ranges may be empty.
+struct DiffHunk {
+  size_t a_begin;
+  size_t a_end;
+  size_t b_begin;
+  size_t b_end;
+};
+
+// Limits on the work that ComputeDiff does before giving up.
+struct DiffBudget {
+  // The largest number of insertions plus deletions to look for. The memory
+  // used grows with the square of this.
+  size_t max_edits;
+
+  // The largest number of element comparisons to make.
+  uint64 max_comparisons;
+};
+
+// Compute the hunks of a shortest edit script turning a into b, in order. If
+// the budget runs out first, return a single hunk spanning everything between
+// the common prefix and the common suffix of the sequences, and set *complete
+// to false. Otherwise set it to true.
+std::vector<DiffHunk> ComputeDiff(
+    const uint16* a,
+    size_t a_length,
+    const uint16* b,
+    size_t b_length,
+    const DiffBudget& budget,
+    bool* complete);
+
+std::vector<DiffHunk> ComputeDiff(
+    const int32* a,
+    size_t a_length,
+    const int32* b,
+    size_t b_length,
+    const DiffBudget& budget,
+    bool* complete);
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_DIFF_H_
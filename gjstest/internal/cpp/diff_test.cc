@@ -0,0 +1,226 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/diff.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "base/stringprintf.h"
+
+namespace gjstest {
+
+static const DiffBudget kUnlimited = { 1000000, kuint64max };
+
+static std::vector<uint16> ToCodeUnits(const std::string& s) {
+  return std::vector<uint16>(s.begin(), s.end());
+}
+
+// Diff the supplied strings, describing the hunks like "[2,3)->[2,5)".
+static std::string Diff(
+    const std::string& a,
+    const std::string& b,
+    const DiffBudget& budget,
+    bool* complete) {
+  const std::vector<uint16> a_units = ToCodeUnits(a);
+  const std::vector<uint16> b_units = ToCodeUnits(b);
+  const std::vector<DiffHunk> hunks =
+      ComputeDiff(
+          a_units.data(),
+          a_units.size(),
+          b_units.data(),
+          b_units.size(),
+          budget,
+          complete);
+
+  std::string result;
+  for (const DiffHunk& hunk : hunks) {
+    if (!result.empty()) result += " ";
+    result +=
+        StringPrintf(
+            "[%zu,%zu)->[%zu,%zu)",
+            hunk.a_begin,
+            hunk.a_end,
+            hunk.b_begin,
+            hunk.b_end);
+  }
+
+  return result;
+}
+
+static std::string Diff(const std::string& a, const std::string& b) {
+  bool complete = false;
+  const std::string result = Diff(a, b, kUnlimited, &complete);
+  EXPECT_TRUE(complete);
+  return result;
+}
+
+// Return the length of the shortest edit script turning a into b.
+static size_t EditDistance(const std::string& a, const std::string& b) {
+  std::vector<std::vector<size_t>> lcs(
+      a.size() + 1,
+      std::vector<size_t>(b.size() + 1, 0));
+
+  for (size_t i = 1; i <= a.size(); ++i) {
+    for (size_t j = 1; j <= b.size(); ++j) {
+      lcs[i][j] =
+          a[i - 1] == b[j - 1] ?
+              lcs[i - 1][j - 1] + 1 :
+              std::max(lcs[i - 1][j], lcs[i][j - 1]);
+    }
+  }
+
+  return a.size() + b.size() - 2 * lcs[a.size()][b.size()];
+}
+
+TEST(ComputeDiffTest, IdenticalSequences) {
+  EXPECT_EQ("", Diff("", ""));
+  EXPECT_EQ("", Diff("taco", "taco"));
+}
+
+TEST(ComputeDiffTest, EmptySequences) {
+  EXPECT_EQ("[0,0)->[0,4)", Diff("", "taco"));
+  EXPECT_EQ("[0,4)->[0,0)", Diff("taco", ""));
+}
+
+TEST(ComputeDiffTest, SingleHunks) {
+  EXPECT_EQ("[2,3)->[2,3)", Diff("abcde", "abXde"));
+  EXPECT_EQ("[2,2)->[2,4)", Diff("abcde", "abXYcde"));
+  EXPECT_EQ("[1,3)->[1,1)", Diff("abcde", "ade"));
+  EXPECT_EQ("[0,1)->[0,1)", Diff("abc", "Xbc"));
+  EXPECT_EQ("[2,3)->[2,3)", Diff("abc", "abX"));
+}
+
+TEST(ComputeDiffTest, SeveralHunks) {
+  EXPECT_EQ(
+      "[2,3)->[2,3) [6,7)->[6,8)",
+      Diff("abcdefgh", "abXdefYZh"));
+
+  EXPECT_EQ(
+      "[0,1)->[0,0) [4,4)->[3,4)",
+      Diff("abcd", "bcdX"));
+}
+
+TEST(ComputeDiffTest, FindsShortestEditScripts) {
+  srand(17);
+
+  for (int i = 0; i < 500; ++i) {
+    // Use a small alphabet so that there's plenty in common.
+    std::string a;
+    std::string b;
+    for (int j = rand() % 20; j > 0; --j) a += 'a' + rand() % 3;
+    for (int j = rand() % 20; j > 0; --j) b += 'a' + rand() % 3;
+
+    const std::vector<uint16> a_units = ToCodeUnits(a);
+    const std::vector<uint16> b_units = ToCodeUnits(b);
+    bool complete = false;
+    const std::vector<DiffHunk> hunks =
+        ComputeDiff(
+            a_units.data(),
+            a_units.size(),
+            b_units.data(),
+            b_units.size(),
+            kUnlimited,
+            &complete);
+
+    ASSERT_TRUE(complete);
+
+    // Applying the hunks to a should give b, and they should be no bigger
+    // than they need to be.
+    std::string patched;
+    size_t a_pos = 0;
+    size_t edits = 0;
+    for (const DiffHunk& hunk : hunks) {
+      ASSERT_LE(a_pos, hunk.a_begin);
+      patched += a.substr(a_pos, hunk.a_begin - a_pos);
+      patched += b.substr(hunk.b_begin, hunk.b_end - hunk.b_begin);
+      a_pos = hunk.a_end;
+      edits += hunk.a_end - hunk.a_begin + hunk.b_end - hunk.b_begin;
+    }
+
+    patched += a.substr(a_pos);
+    EXPECT_EQ(b, patched) << a << " -> " << b;
+    EXPECT_EQ(EditDistance(a, b), edits) << a << " -> " << b;
+  }
+}
+
+TEST(ComputeDiffTest, GivesUpAfterTooManyEdits) {
+  const DiffBudget budget = { 2, kuint64max };
+  bool complete = true;
+
+  // Two edits are fine.
+  EXPECT_EQ(
+      "[2,3)->[2,3)",
+      Diff("abcdefgh", "abXdefgh", budget, &complete));
+  EXPECT_TRUE(complete);
+
+  // Four aren't. Everything between the common prefix and suffix is
+  // reported.
+  EXPECT_EQ(
+      "[2,6)->[2,6)",
+      Diff("abcdefgh", "abXdeYgh", budget, &complete));
+  EXPECT_FALSE(complete);
+}
+
+TEST(ComputeDiffTest, GivesUpAfterTooManyComparisons) {
+  const DiffBudget budget = { 1000000, 100 };
+
+  std::string a(1000, 'a');
+  std::string b = a;
+  for (size_t i = 0; i < b.size(); i += 100) b[i] = 'b';
+
+  bool complete = true;
+  EXPECT_EQ("[0,901)->[0,901)", Diff(a, b, budget, &complete));
+  EXPECT_FALSE(complete);
+}
+
+TEST(ComputeDiffTest, LargeArraysWithFewDifferences) {
+  std::vector<int32> a(50000);
+  for (size_t i = 0; i < a.size(); ++i) a[i] = i;
+
+  std::vector<int32> b = a;
+  b[100] = -1;
+  b.erase(b.begin() + 20000);
+  b.insert(b.begin() + 40000, -2);
+
+  const DiffBudget budget = { 1000, 10000000 };
+  bool complete = false;
+  const std::vector<DiffHunk> hunks =
+      ComputeDiff(a.data(), a.size(), b.data(), b.size(), budget, &complete);
+
+  EXPECT_TRUE(complete);
+  ASSERT_EQ(3, hunks.size());
+
+  EXPECT_EQ(100, hunks[0].a_begin);
+  EXPECT_EQ(101, hunks[0].a_end);
+  EXPECT_EQ(100, hunks[0].b_begin);
+  EXPECT_EQ(101, hunks[0].b_end);
+
+  EXPECT_EQ(20000, hunks[1].a_begin);
+  EXPECT_EQ(20001, hunks[1].a_end);
+  EXPECT_EQ(20000, hunks[1].b_begin);
+  EXPECT_EQ(20000, hunks[1].b_end);
+
+  EXPECT_EQ(40001, hunks[2].a_begin);
+  EXPECT_EQ(40001, hunks[2].a_end);
+  EXPECT_EQ(40000, hunks[2].b_begin);
+  EXPECT_EQ(40001, hunks[2].b_end);
+}
+
+}  // namespace gjstest
@@ -0,0 +1,796 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/event_loop.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "base/logging.h"
+#include "base/stringprintf.h"
+
+using v8::Context;
+using v8::Function;
+using v8::Isolate;
+using v8::Local;
+using v8::Object;
+using v8::Promise;
+using v8::String;
+using v8::TryCatch;
+using v8::Value;
+
+namespace gjstest {
+
+// The isolate data slot in which the event loop is found by OnPromiseEvent.
+static const uint32 kIsolateDataSlot = 0;
+
+// The most timers that gjstest.clock.runAll runs before concluding that they
+// will never run out, e.g. because an interval was never cleared.
+static const uint32 kMaxRunAllTimers = 100000;
+
+// The shortest period of an interval, so that time passes between its runs.
+static const double kMinIntervalMs = 1;
+
+// Return the current time in whole milliseconds since the epoch.
+static double GetWallTimeMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Set a property of an object, which must succeed.
+static void SetProperty(
+    Isolate* const isolate,
+    const Local<Object>& object,
+    const char* name,
+    const Local<Value>& value) {
+  CHECK(
+      object->Set(
+          isolate->GetCurrentContext(),
+          String::NewFromUtf8(isolate, name),
+          value).FromJust());
+}
+
+// Get a property of an object, which must succeed.
+static Local<Value> GetProperty(
+    Isolate* const isolate,
+    const Local<Object>& object,
+    const char* name) {
+  return object->Get(
+      isolate->GetCurrentContext(),
+      String::NewFromUtf8(isolate, name)).ToLocalChecked();
+}
+
+EventLoop::EventLoop(
+    Isolate* const isolate,
+    Local<Context> context)
+    : isolate_(CHECK_NOTNULL(isolate)),
+      context_(isolate, context),
+      start_time_(GetWallTimeMs()) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Context::Scope context_scope(context);
+
+  CHECK(isolate_->GetData(kIsolateDataSlot) == NULL);
+  isolate_->SetData(kIsolateDataSlot, this);
+  isolate_->SetMicrotasksPolicy(v8::MicrotasksPolicy::kExplicit);
+
+  test_key_.Reset(
+      isolate_,
+      v8::Private::ForApi(
+          isolate_,
+          String::NewFromUtf8(isolate_, "gjstest::testEnvironment")));
+
+  clock_key_.Reset(
+      isolate_,
+      v8::Private::ForApi(
+          isolate_,
+          String::NewFromUtf8(isolate_, "gjstest::clock")));
+
+  current_test_name_.Reset(
+      isolate_,
+      String::NewFromUtf8(isolate_, "currentTestEnvironment"));
+
+  clocks_[0].now = start_time_;
+
+  const Local<Object> global = context->Global();
+
+  // Timers.
+  SetProperty(
+      isolate_,
+      global,
+      "setTimeout",
+      AddFunction(
+          "setTimeout",
+          std::bind(
+              &EventLoop::AddTimer,
+              this,
+              std::placeholders::_1,
+              false)));
+
+  SetProperty(
+      isolate_,
+      global,
+      "setInterval",
+      AddFunction(
+          "setInterval",
+          std::bind(
+              &EventLoop::AddTimer,
+              this,
+              std::placeholders::_1,
+              true)));
+
+  const Local<Function> clear_timer =
+      AddFunction(
+          "clearTimeout",
+          std::bind(&EventLoop::ClearTimer, this, std::placeholders::_1));
+
+  SetProperty(isolate_, global, "clearTimeout", clear_timer);
+  SetProperty(isolate_, global, "clearInterval", clear_timer);
+
+  // Replace Date with a constructor that takes the current time from the
+  // clocks. Dates for other times, and the methods of Date.prototype, are
+  // v8's own.
+  const Local<Value> real_date_value = GetProperty(isolate_, global, "Date");
+  CHECK(real_date_value->IsFunction());
+  const Local<Function> real_date = Local<Function>::Cast(real_date_value);
+  real_date_.Reset(isolate_, real_date);
+
+  const Local<Function> date =
+      AddFunction(
+          "Date",
+          std::bind(&EventLoop::NewDate, this, std::placeholders::_1));
+  date_.Reset(isolate_, date);
+
+  const Local<Value> date_prototype =
+      GetProperty(isolate_, real_date, "prototype");
+  CHECK(date_prototype->IsObject());
+
+  SetProperty(isolate_, date, "prototype", date_prototype);
+  SetProperty(
+      isolate_,
+      Local<Object>::Cast(date_prototype),
+      "constructor",
+      date);
+
+  SetProperty(isolate_, date, "UTC", GetProperty(isolate_, real_date, "UTC"));
+  SetProperty(
+      isolate_,
+      date,
+      "parse",
+      GetProperty(isolate_, real_date, "parse"));
+
+  SetProperty(
+      isolate_,
+      date,
+      "now",
+      AddFunction(
+          "now",
+          std::bind(&EventLoop::DateNow, this, std::placeholders::_1)));
+
+  SetProperty(isolate_, global, "Date", date);
+
+  // performance.now.
+  const Local<Object> performance = Object::New(isolate_);
+  SetProperty(
+      isolate_,
+      performance,
+      "now",
+      AddFunction(
+          "now",
+          std::bind(&EventLoop::PerformanceNow, this, std::placeholders::_1)));
+
+  SetProperty(isolate_, global, "performance", performance);
+
+  // The functions behind gjstest.clock. See gjstest/public/clock.js.
+  const Local<Object> clock = Object::New(isolate_);
+  SetProperty(
+      isolate_,
+      clock,
+      "tick",
+      AddFunction(
+          "tick",
+          std::bind(&EventLoop::Tick, this, std::placeholders::_1)));
+
+  SetProperty(
+      isolate_,
+      clock,
+      "runAll",
+      AddFunction(
+          "runAll",
+          std::bind(&EventLoop::RunAll, this, std::placeholders::_1)));
+
+  SetProperty(isolate_, global, "gjstestClock", clock);
+}
+
+EventLoop::~EventLoop() {
+  isolate_->SetPromiseHook(NULL);
+  isolate_->SetData(kIsolateDataSlot, NULL);
+}
+
+void EventLoop::TrackPromises(Local<Value> test_environment) {
+  if (tracking_promises_) return;
+  tracking_promises_ = true;
+
+  if (test_environment->IsObject()) {
+    untracked_test_.Reset(isolate_, test_environment);
+  }
+
+  isolate_->SetPromiseHook(&EventLoop::OnPromiseEvent);
+}
+
+void EventLoop::RunMicrotasks() {
+  isolate_->RunMicrotasks();
+}
+
+bool EventLoop::RunNextTask(const double deadline_ms) {
+  const v8::HandleScope handle_scope(isolate_);
+
+  // Tasks posted from other threads have already waited in real time, so run
+  // them first. Otherwise run a timer, or failing that wait for a task.
+  std::function<void()> task;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (posted_tasks_.empty() && timers_.empty() && task_sources_ > 0) {
+      const std::chrono::steady_clock::time_point deadline(
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double, std::milli>(deadline_ms)));
+
+      task_posted_.wait_until(lock, deadline);
+    }
+
+    if (!posted_tasks_.empty()) {
+      task = std::move(posted_tasks_.front());
+      posted_tasks_.pop_front();
+    }
+  }
+
+  if (task) {
+    task();
+  } else if (!RunNextTimer()) {
+    return false;
+  }
+
+  RunMicrotasks();
+  return true;
+}
+
+bool EventLoop::HasPendingWork() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return !timers_.empty() || task_sources_ > 0 || !posted_tasks_.empty();
+}
+
+void EventLoop::PostTask(const std::function<void()>& task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  posted_tasks_.push_back(task);
+  task_posted_.notify_one();
+}
+
+void EventLoop::AddTaskSource() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++task_sources_;
+}
+
+void EventLoop::RemoveTaskSource() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CHECK_GT(task_sources_, 0);
+  --task_sources_;
+}
+
+bool EventLoop::RunNextTimer() {
+  // Every clock starts at the same time, so running the timer that is due
+  // earliest on any of them interleaves the tests fairly.
+  const Clock* next_clock = NULL;
+  uint32 next_clock_id = 0;
+  for (const auto& entry : clocks_) {
+    const Clock& clock = entry.second;
+    if (clock.queue.empty()) continue;
+
+    if (next_clock == NULL ||
+        clock.queue.begin()->first < next_clock->queue.begin()->first ||
+        (clock.queue.begin()->first == next_clock->queue.begin()->first &&
+         entry.first < next_clock_id)) {
+      next_clock = &clock;
+      next_clock_id = entry.first;
+    }
+  }
+
+  if (next_clock == NULL) return false;
+
+  RunTimer(next_clock_id);
+  return true;
+}
+
+void EventLoop::DiscardTest(Local<Value> test_environment) {
+  if (!test_environment->IsObject()) return;
+
+  if (!untracked_test_.IsEmpty() &&
+      untracked_test_ == Local<Object>::Cast(test_environment)) {
+    untracked_test_.Reset();
+  }
+
+  Local<Value> clock_id;
+  if (!Local<Object>::Cast(test_environment)
+          ->GetPrivate(
+              Local<Context>::New(isolate_, context_),
+              Local<v8::Private>::New(isolate_, clock_key_))
+          .ToLocal(&clock_id) ||
+      !clock_id->IsUint32()) {
+    return;
+  }
+
+  const auto it = clocks_.find(clock_id.As<v8::Uint32>()->Value());
+  if (it == clocks_.end()) return;
+
+  for (const auto& entry : it->second.queue) {
+    timers_.erase(entry.second);
+  }
+
+  clocks_.erase(it);
+}
+
+void EventLoop::OnPromiseEvent(
+    const v8::PromiseHookType type,
+    const Local<Promise> promise,
+    const Local<Value> parent) {
+  EventLoop* const loop =
+      static_cast<EventLoop*>(
+          promise->GetIsolate()->GetData(kIsolateDataSlot));
+
+  Isolate* const isolate = loop->isolate_;
+  const Local<Context> context = isolate->GetCurrentContext();
+  const Local<v8::Private> test_key =
+      Local<v8::Private>::New(isolate, loop->test_key_);
+
+  switch (type) {
+    // File new promises under the current test, or under null if there's
+    // none.
+    case v8::PromiseHookType::kInit: {
+      CHECK(
+          promise->SetPrivate(
+              context,
+              test_key,
+              loop->GetCurrentTest()).FromJust());
+
+      break;
+    }
+
+    // Make the promise's test current while its reactions run. A promise
+    // created before promises were tracked belongs to the test that started
+    // the tracking.
+    case v8::PromiseHookType::kBefore: {
+      loop->saved_tests_.emplace_back(isolate, loop->GetCurrentTest());
+
+      Local<Value> test_environment;
+      if (promise->HasPrivate(context, test_key).FromMaybe(false)) {
+        test_environment =
+            promise->GetPrivate(context, test_key)
+                .FromMaybe(Local<Value>());
+      } else {
+        test_environment = Local<Value>::New(isolate, loop->untracked_test_);
+      }
+
+      if (!test_environment.IsEmpty() && test_environment->IsObject()) {
+        loop->SetCurrentTest(test_environment);
+      }
+
+      break;
+    }
+
+    case v8::PromiseHookType::kAfter: {
+      if (!loop->saved_tests_.empty()) {
+        loop->SetCurrentTest(
+            Local<Value>::New(isolate, loop->saved_tests_.back()));
+        loop->saved_tests_.pop_back();
+      }
+
+      break;
+    }
+
+    case v8::PromiseHookType::kResolve:
+      break;
+  }
+}
+
+Local<Object> EventLoop::GetInternalNamespace() {
+  if (internal_.IsEmpty()) {
+    const Local<Context> context = Local<Context>::New(isolate_, context_);
+    const TryCatch try_catch(isolate_);
+
+    Local<Value> gjstest;
+    Local<Value> internal;
+    if (!context->Global()
+            ->Get(context, String::NewFromUtf8(isolate_, "gjstest"))
+            .ToLocal(&gjstest) ||
+        !gjstest->IsObject() ||
+        !Local<Object>::Cast(gjstest)
+            ->Get(context, String::NewFromUtf8(isolate_, "internal"))
+            .ToLocal(&internal) ||
+        !internal->IsObject()) {
+      return Local<Object>();
+    }
+
+    internal_.Reset(isolate_, Local<Object>::Cast(internal));
+  }
+
+  return Local<Object>::New(isolate_, internal_);
+}
+
+Local<Value> EventLoop::GetCurrentTest() {
+  const Local<Object> internal = GetInternalNamespace();
+  Local<Value> result;
+  if (internal.IsEmpty() ||
+      !internal->Get(
+          Local<Context>::New(isolate_, context_),
+          Local<String>::New(isolate_, current_test_name_)).ToLocal(&result)) {
+    return v8::Null(isolate_);
+  }
+
+  return result;
+}
+
+void EventLoop::SetCurrentTest(Local<Value> test_environment) {
+  const Local<Object> internal = GetInternalNamespace();
+  if (internal.IsEmpty()) return;
+
+  // This fails only if execution is being terminated, in which case nothing
+  // will look at the current test before the next one starts.
+  internal->Set(
+      Local<Context>::New(isolate_, context_),
+      Local<String>::New(isolate_, current_test_name_),
+      test_environment->IsObject() ?
+          test_environment :
+          Local<Value>(v8::Null(isolate_))).FromMaybe(false);
+}
+
+EventLoop::Clock* EventLoop::GetCurrentClock(uint32* const clock_id) {
+  *clock_id = 0;
+
+  const Local<Value> test_environment = GetCurrentTest();
+  if (test_environment->IsObject()) {
+    const Local<Context> context = Local<Context>::New(isolate_, context_);
+    const Local<Object> test_object = Local<Object>::Cast(test_environment);
+    const Local<v8::Private> clock_key =
+        Local<v8::Private>::New(isolate_, clock_key_);
+
+    // Has the test already got a clock?
+    Local<Value> id;
+    if (test_object->GetPrivate(context, clock_key).ToLocal(&id) &&
+        id->IsUint32()) {
+      *clock_id = id.As<v8::Uint32>()->Value();
+      const auto it = clocks_.find(*clock_id);
+      return it == clocks_.end() ? NULL : &it->second;
+    }
+
+    // Give it a new one.
+    *clock_id = next_clock_id_++;
+    if (!test_object->SetPrivate(
+            context,
+            clock_key,
+            v8::Integer::NewFromUnsigned(isolate_, *clock_id))
+            .FromMaybe(false)) {
+      return NULL;
+    }
+
+    clocks_[*clock_id].now = start_time_;
+  }
+
+  return &clocks_[*clock_id];
+}
+
+double EventLoop::CurrentTime() {
+  uint32 clock_id;
+  const Clock* const clock = GetCurrentClock(&clock_id);
+  return clock ? clock->now : start_time_;
+}
+
+bool EventLoop::RunTimer(const uint32 clock_id) {
+  const auto clock_it = clocks_.find(clock_id);
+  CHECK(clock_it != clocks_.end());
+  Clock& clock = clock_it->second;
+  CHECK(!clock.queue.empty());
+
+  const auto front = clock.queue.begin();
+  const uint32 timer_id = front->second;
+  clock.now = std::max(clock.now, front->first);
+  clock.queue.erase(front);
+
+  const auto timer_it = timers_.find(timer_id);
+  CHECK(timer_it != timers_.end());
+  Timer& timer = timer_it->second;
+
+  const Local<Function> callback =
+      Local<Function>::New(isolate_, timer.callback);
+  const Local<Value> test_environment =
+      Local<Value>::New(isolate_, timer.test_environment);
+
+  std::vector<Local<Value>> args;
+  for (const auto& arg : timer.args) {
+    args.push_back(Local<Value>::New(isolate_, arg));
+  }
+
+  // Schedule the next run of an interval before running it, so that the
+  // callback can clear it.
+  if (timer.interval > 0) {
+    timer.due = clock.now + timer.interval;
+    clock.queue.insert(std::make_pair(timer.due, timer_id));
+  } else {
+    timers_.erase(timer_it);
+  }
+
+  // Run the callback as part of the test that set it.
+  const Local<Context> context = Local<Context>::New(isolate_, context_);
+  return CallInTest(
+      test_environment,
+      callback,
+      context->Global(),
+      args.size(),
+      args.data());
+}
+
+bool EventLoop::RunTimersUntil(const double time, const uint32 max_timers) {
+  uint32 clock_id;
+  if (GetCurrentClock(&clock_id) == NULL) return true;
+
+  for (uint32 timers_run = 0; ; ++timers_run) {
+    // Look the clock up afresh, since timers may create others or discard
+    // this one.
+    const auto clock_it = clocks_.find(clock_id);
+    if (clock_it == clocks_.end()) return true;
+
+    Clock& clock = clock_it->second;
+    if (clock.queue.empty() || clock.queue.begin()->first > time) {
+      if (std::isfinite(time)) clock.now = std::max(clock.now, time);
+      return true;
+    }
+
+    if (timers_run == max_timers) {
+      ThrowError(
+          StringPrintf(
+              "gjstest.clock.runAll gave up after running %u timers. Is "
+              "there an interval that is never cleared?",
+              max_timers).c_str());
+      return false;
+    }
+
+    if (!RunTimer(clock_id)) return false;
+  }
+}
+
+bool EventLoop::CallInTest(
+    Local<Value> test_environment,
+    Local<Function> function,
+    Local<Value> receiver,
+    const int argc,
+    Local<Value> argv[]) {
+  const Local<Context> context = Local<Context>::New(isolate_, context_);
+  const Local<Value> previous_test = GetCurrentTest();
+  SetCurrentTest(test_environment);
+
+  bool terminated = false;
+  {
+    const TryCatch try_catch(isolate_);
+    if (function->Call(context, receiver, argc, argv).IsEmpty()) {
+      terminated = try_catch.HasTerminated();
+      if (!terminated) ReportError(test_environment, try_catch.Exception());
+    }
+  }
+
+  SetCurrentTest(previous_test);
+  return !terminated;
+}
+
+void EventLoop::ReportError(
+    Local<Value> test_environment,
+    Local<Value> error) {
+  const Local<Context> context = Local<Context>::New(isolate_, context_);
+  const Local<Object> internal = GetInternalNamespace();
+
+  Local<Value> report;
+  if (test_environment->IsObject() &&
+      !internal.IsEmpty() &&
+      internal->Get(
+          context,
+          String::NewFromUtf8(isolate_, "reportException")).ToLocal(&report) &&
+      report->IsFunction()) {
+    Local<Value> args[] = { error, test_environment };
+    const TryCatch report_try_catch(isolate_);
+    if (!Local<Function>::Cast(report)
+            ->Call(context, internal, arraysize(args), args).IsEmpty()) {
+      return;
+    }
+  }
+
+  // There's no test to blame.
+  LOG(ERROR)
+      << "Uncaught exception outside of any test: "
+      << ConvertToString(isolate_, error);
+}
+
+void EventLoop::ThrowError(const char* message) {
+  isolate_->ThrowException(
+      v8::Exception::Error(String::NewFromUtf8(isolate_, message)));
+}
+
+Local<Function> EventLoop::AddFunction(
+    const char* name,
+    const V8FunctionCallback& callback) {
+  callbacks_.emplace_back(new V8FunctionCallback(callback));
+  return MakeFunction(isolate_, name, callbacks_.back().get());
+}
+
+Local<Value> EventLoop::AddTimer(
+    const v8::FunctionCallbackInfo<Value>& cb_info,
+    const bool repeat) {
+  const Local<Context> context = isolate_->GetCurrentContext();
+
+  if (cb_info.Length() < 1 || !cb_info[0]->IsFunction()) {
+    ThrowError(
+        repeat ?
+            "setInterval requires a function." :
+            "setTimeout requires a function.");
+    return Local<Value>();
+  }
+
+  // Like browsers, treat negative and unparseable delays as zero.
+  double delay = 0;
+  if (cb_info.Length() >= 2 &&
+      !cb_info[1]->NumberValue(context).To(&delay)) {
+    return Local<Value>();
+  }
+
+  if (!(delay > 0) || !std::isfinite(delay)) delay = 0;
+
+  // Timer callbacks may create promises that outlive the test's own code.
+  TrackPromises(GetCurrentTest());
+
+  const uint32 id = next_timer_id_++;
+
+  // The timers of a test that has been discarded never run.
+  uint32 clock_id;
+  Clock* const clock = GetCurrentClock(&clock_id);
+  if (clock == NULL) return v8::Integer::NewFromUnsigned(isolate_, id);
+
+  Timer& timer = timers_[id];
+  timer.clock_id = clock_id;
+  timer.due = clock->now + delay;
+  timer.interval = repeat ? std::max(delay, kMinIntervalMs) : 0;
+  timer.callback.Reset(isolate_, Local<Function>::Cast(cb_info[0]));
+  timer.test_environment.Reset(isolate_, GetCurrentTest());
+
+  for (int i = 2; i < cb_info.Length(); ++i) {
+    timer.args.emplace_back(isolate_, cb_info[i]);
+  }
+
+  clock->queue.insert(std::make_pair(timer.due, id));
+
+  return v8::Integer::NewFromUnsigned(isolate_, id);
+}
+
+Local<Value> EventLoop::ClearTimer(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  if (cb_info.Length() >= 1 && cb_info[0]->IsUint32()) {
+    const uint32 id = cb_info[0].As<v8::Uint32>()->Value();
+
+    const auto it = timers_.find(id);
+    if (it != timers_.end()) {
+      const Timer& timer = it->second;
+      const auto clock_it = clocks_.find(timer.clock_id);
+      if (clock_it != clocks_.end()) {
+        clock_it->second.queue.erase(std::make_pair(timer.due, id));
+      }
+
+      timers_.erase(it);
+    }
+  }
+
+  return v8::Undefined(isolate_);
+}
+
+Local<Value> EventLoop::NewDate(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  const Local<Context> context = isolate_->GetCurrentContext();
+  const double now = std::floor(CurrentTime());
+
+  // Called as a function, Date ignores its arguments and returns a string.
+  if (!cb_info.IsConstructCall()) {
+    Local<Value> date;
+    Local<String> result;
+    if (!v8::Date::New(context, now).ToLocal(&date) ||
+        !date->ToString(context).ToLocal(&result)) {
+      return Local<Value>();
+    }
+
+    return result;
+  }
+
+  // Construct the date with v8's Date, using the current time unless other
+  // arguments were supplied.
+  Local<Object> result;
+  if (cb_info.Length() == 0) {
+    Local<Value> date;
+    if (!v8::Date::New(context, now).ToLocal(&date)) return Local<Value>();
+    result = Local<Object>::Cast(date);
+  } else {
+    std::vector<Local<Value>> args;
+    for (int i = 0; i < cb_info.Length(); ++i) {
+      args.push_back(cb_info[i]);
+    }
+
+    if (!Local<Function>::New(isolate_, real_date_)
+            ->NewInstance(context, args.size(), args.data())
+            .ToLocal(&result)) {
+      return Local<Value>();
+    }
+  }
+
+  // Give instances of subclasses of Date the right prototype.
+  const Local<Value> new_target = cb_info.NewTarget();
+  if (new_target->IsObject() &&
+      !new_target->StrictEquals(Local<Function>::New(isolate_, date_))) {
+    Local<Value> prototype;
+    if (!Local<Object>::Cast(new_target)
+            ->Get(context, String::NewFromUtf8(isolate_, "prototype"))
+            .ToLocal(&prototype) ||
+        !result->SetPrototype(context, prototype).FromMaybe(false)) {
+      return Local<Value>();
+    }
+  }
+
+  return result;
+}
+
+Local<Value> EventLoop::DateNow(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  return v8::Number::New(isolate_, std::floor(CurrentTime()));
+}
+
+Local<Value> EventLoop::PerformanceNow(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  return v8::Number::New(isolate_, CurrentTime() - start_time_);
+}
+
+Local<Value> EventLoop::Tick(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  double ms = 0;
+  if (cb_info.Length() != 1 ||
+      !cb_info[0]->IsNumber() ||
+      !((ms = cb_info[0].As<v8::Number>()->Value()) >= 0) ||
+      !std::isfinite(ms)) {
+    ThrowError(
+        "gjstest.clock.tick requires a non-negative number of milliseconds.");
+    return Local<Value>();
+  }
+
+  if (!RunTimersUntil(
+          CurrentTime() + ms,
+          std::numeric_limits<uint32>::max())) {
+    return Local<Value>();
+  }
+
+  return v8::Undefined(isolate_);
+}
+
+Local<Value> EventLoop::RunAll(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  if (!RunTimersUntil(
+          std::numeric_limits<double>::infinity(),
+          kMaxRunAllTimers)) {
+    return Local<Value>();
+  }
+
+  return v8::Undefined(isolate_);
+}
+
+}  // namespace gjstest
@@ -0,0 +1,254 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The timers, virtual clocks and promise reactions that tests wait on.
+
+#ifndef GJSTEST_INTERNAL_CPP_EVENT_LOOP_H_
+#define GJSTEST_INTERNAL_CPP_EVENT_LOOP_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <v8.h>
+
+#include "base/integral_types.h"
+#include "base/macros.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+
+namespace gjstest {
+
+// Installs setTimeout, setInterval and their clear functions in a context,
+// and runs the timers they set and the microtasks that promises queue when
+// asked to, rather than v8 running microtasks whenever a call into JS returns.
+//
+// Timers, Date and performance.now all use virtual clocks, on which time
+// passes only when timers are run: by gjstest.clock.tick and
+// gjstest.clock.runAll, or by RunNextTimer when a test is waiting for a
+// timer. So a test can simulate an hour of timers without waiting for them.
+// Each test has its own clock, starting at the time at which the event loop
+// was created, so tests don't see each other's time or timers.
+//
+// Each timer and promise is filed under the test that was current (see
+// gjstest.internal.currentTestEnvironment) when it was created, and that test
+// is made current again whenever it runs. So failures reported by code that
+// runs after an await or a timeout are attributed to the right test, even when
+// the runner interleaves several asynchronous tests. Filing promises slows
+// down every promise, so it begins only once a test returns a thenable or sets
+// a timer (see TrackPromises).
+//
+// Other threads, such as those running workers, may post tasks to the loop,
+// which runs them as soon as it can.
+class EventLoop {
+ public:
+  // Install the functions in the supplied context, which must not have run any
+  // scripts yet. There may be only one event loop per isolate, and it must
+  // outlive any use of the functions.
+  EventLoop(v8::Isolate* isolate, v8::Local<v8::Context> context);
+  ~EventLoop();
+
+  // Start filing promises under the tests that create them, if that hasn't
+  // already begun. Promises created before then are filed under the supplied
+  // test, which should be the one about to wait on them.
+  void TrackPromises(v8::Local<v8::Value> test_environment);
+
+  // Run microtasks until there are none left.
+  void RunMicrotasks();
+
+  // Run the next task, followed by the microtasks it queues. That's a task
+  // posted from another thread if there is one, or else the pending timer that
+  // is due earliest, whose clock is advanced to the time at which it's due.
+  // If there are neither but some task source may still post tasks, wait for
+  // one until the supplied deadline, in milliseconds on std::chrono's steady
+  // clock. Return false if no task ran.
+  bool RunNextTask(double deadline_ms);
+
+  // Is there a pending timer or posted task, or a source that may post one?
+  bool HasPendingWork();
+
+  // Queue a task to be run by RunNextTask. May be called from any thread.
+  void PostTask(const std::function<void()>& task);
+
+  // Tell the loop that a source of posted tasks, such as a worker, has started
+  // or stopped, so that RunNextTask knows whether to wait for it.
+  void AddTaskSource();
+  void RemoveTaskSource();
+
+  // Call the supplied function as part of the supplied test, reporting any
+  // exception it throws as a failure of the test. Return false if execution
+  // was terminated.
+  bool CallInTest(
+      v8::Local<v8::Value> test_environment,
+      v8::Local<v8::Function> function,
+      v8::Local<v8::Value> receiver,
+      int argc,
+      v8::Local<v8::Value> argv[]);
+
+  // Report an error as a failure of the supplied test, or log it if there's
+  // no test.
+  void ReportError(
+      v8::Local<v8::Value> test_environment,
+      v8::Local<v8::Value> error);
+
+  // Return gjstest.internal.currentTestEnvironment.
+  v8::Local<v8::Value> GetCurrentTest();
+
+  // Cancel the pending timers of the supplied test environment, and discard
+  // its clock.
+  void DiscardTest(v8::Local<v8::Value> test_environment);
+
+ private:
+  struct Timer {
+    uint32 clock_id;
+    double due;
+
+    // The period of a timer set by setInterval, or zero for one set by
+    // setTimeout.
+    double interval;
+
+    v8::Global<v8::Function> callback;
+    std::vector<v8::Global<v8::Value>> args;
+    v8::Global<v8::Value> test_environment;
+  };
+
+  struct Clock {
+    // The current time, in milliseconds since the epoch.
+    double now;
+
+    // The IDs of the clock's pending timers, in the order in which they're
+    // due.
+    std::set<std::pair<double, uint32>> queue;
+  };
+
+  static void OnPromiseEvent(
+      v8::PromiseHookType type,
+      v8::Local<v8::Promise> promise,
+      v8::Local<v8::Value> parent);
+
+  // Return gjstest.internal, or an empty handle if it hasn't been defined.
+  v8::Local<v8::Object> GetInternalNamespace();
+
+  void SetCurrentTest(v8::Local<v8::Value> test_environment);
+
+  // Return the clock of the current test, creating it if need be, or NULL if
+  // the test has been discarded. Code that runs outside of any test uses a
+  // clock of its own.
+  Clock* GetCurrentClock(uint32* clock_id);
+
+  // Run the pending timer that is due earliest. Return false if there are no
+  // pending timers.
+  bool RunNextTimer();
+
+  // Run the pending timer of the supplied clock that is due earliest,
+  // advancing the clock to the time at which it's due. Return false if the
+  // timer's callback was terminated.
+  bool RunTimer(uint32 clock_id);
+
+  // Run the timers of the current test's clock that are due by the supplied
+  // time, if finite, then advance the clock to that time. Otherwise run
+  // timers until there are none left, or max_timers have run, in which case
+  // throw an error. Return false if an exception is pending.
+  bool RunTimersUntil(double time, uint32 max_timers);
+
+  // The time on the current test's clock.
+  double CurrentTime();
+
+  void ThrowError(const char* message);
+
+  // Add a pending timer for setTimeout or setInterval.
+  v8::Local<v8::Value> AddTimer(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info,
+      bool repeat);
+
+  v8::Local<v8::Value> ClearTimer(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Implementations of the Date constructor, Date.now and performance.now.
+  v8::Local<v8::Value> NewDate(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> DateNow(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> PerformanceNow(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Implementations of gjstest.clock.tick and gjstest.clock.runAll.
+  v8::Local<v8::Value> Tick(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> RunAll(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Create a function wrapping the supplied callback.
+  v8::Local<v8::Function> AddFunction(
+      const char* name,
+      const V8FunctionCallback& callback);
+
+  v8::Isolate* const isolate_;
+  const v8::Global<v8::Context> context_;
+
+  // The time at which each clock starts, in milliseconds since the epoch.
+  const double start_time_;
+
+  // The private properties under which promises are filed and test
+  // environments record their clocks, and gjstest.internal once it has been
+  // found.
+  v8::Global<v8::Private> test_key_;
+  v8::Global<v8::Private> clock_key_;
+  v8::Global<v8::Object> internal_;
+  v8::Global<v8::String> current_test_name_;
+
+  // The Date constructor that v8 provides, and the one that replaces it.
+  v8::Global<v8::Function> real_date_;
+  v8::Global<v8::Function> date_;
+
+  // The tests that were current before the promise reactions now running,
+  // innermost last.
+  std::vector<v8::Global<v8::Value>> saved_tests_;
+
+  // Whether promises are being filed under tests, and the test that promises
+  // created before then belong to, until it's discarded.
+  bool tracking_promises_ = false;
+  v8::Global<v8::Value> untracked_test_;
+
+  // Pending timers by ID, and clocks by ID. Clock zero is used by code that
+  // runs outside of any test.
+  std::unordered_map<uint32, Timer> timers_;
+  std::unordered_map<uint32, Clock> clocks_;
+  uint32 next_timer_id_ = 1;
+  uint32 next_clock_id_ = 1;
+
+  // Tasks posted from other threads, and the number of sources that may post
+  // more, guarded by mutex_.
+  std::mutex mutex_;
+  std::condition_variable task_posted_;
+  std::deque<std::function<void()>> posted_tasks_;
+  uint32 task_sources_ = 0;
+
+  // The callbacks wrapped by the functions.
+  std::vector<std::unique_ptr<V8FunctionCallback>> callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(EventLoop);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_EVENT_LOOP_H_
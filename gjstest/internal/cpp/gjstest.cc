@@ -24,6 +24,9 @@
 //
 // (The relative order of bar.js and baz.js does not matter in this example.)
 //
+// ES modules given with --js_modules are evaluated after the JS files. The
+// modules they import are found automatically, so need not be listed.
+//
 // Dependencies common to all gjstest tests (e.g. built-in matchers and the
 // mocking framework) are added automatically, and should not be specified.
 
@@ -46,6 +49,15 @@
 DEFINE_string(js_files, "",
               "The list of JS files to execute, comma separated.");
 
+DEFINE_string(js_modules, "",
+              "A list of ES modules to evaluate after --js_files, comma "
+              "separated. The modules they import are loaded automatically.");
+
+DEFINE_string(module_root, "",
+              "The directory relative to which import specifiers not "
+              "beginning with './' or '../' are resolved. Defaults to the "
+              "current directory.");
+
 DEFINE_string(xml_output_file, "", "An XML file to write results to.");
 
 DEFINE_string(coverage_output_file, "",
@@ -53,6 +65,12 @@ DEFINE_string(coverage_output_file, "",
               "specified, it is assumed that the input JS files are "
               "instrumented using jscoverage.");
 
+DEFINE_string(stats_output_file, "",
+              "A file to which an XML report of framework-level counters "
+              "(scripts compiled, expectations evaluated, mock calls, stack "
+              "captures, ...) for each test and for the whole run should be "
+              "written.");
+
 DEFINE_string(filter, "", "Regular expression for test names to run.");
 
 // Browser support
@@ -87,9 +105,24 @@ static bool GetScripts(
 
     NamedScript* script = scripts->add_script();
     script->set_name(Basename(path));
-    script->set_source(ReadFileOrDie(path));
+    script->set_path(path);
+  }
+
+  // Likewise the modules.
+  std::vector<string> module_paths;
+  SplitStringUsing(FLAGS_js_modules, ",", &module_paths);
+
+  for (uint32 i = 0; i < module_paths.size(); ++i) {
+    const string& path = module_paths[i];
+
+    NamedScript* script = scripts->add_script();
+    script->set_name(Basename(path));
+    script->set_path(path);
+    script->set_module(true);
   }
 
+  scripts->set_module_root(FLAGS_module_root);
+
   return true;
 }
 
@@ -128,6 +161,19 @@ static bool GenerateHtml() {
             path.c_str());
   }
 
+  // Likewise each module. Browsers resolve their imports themselves.
+  std::vector<string> module_paths;
+  SplitStringUsing(FLAGS_js_modules, ",", &module_paths);
+
+  for (uint32 i = 0; i < module_paths.size(); ++i) {
+    const string& path = module_paths[i];
+    html +=
+        StringPrintf(
+            "  <script type=\"module\" src=\"%s%s\"></script>\n",
+            FLAGS_html_script_path_prefix.c_str(),
+            path.c_str());
+  }
+
   // Pull in the CSS file.
   html +=
       StringPrintf(
@@ -166,6 +212,7 @@ static bool Run() {
   string output;
   string xml;
   string coverage_info;
+  string stats;
 
   const bool success =
       RunTests(
@@ -173,7 +220,8 @@ static bool Run() {
           FLAGS_filter,
           &output,
           &xml,
-          FLAGS_coverage_output_file.empty() ? NULL : &coverage_info);
+          FLAGS_coverage_output_file.empty() ? NULL : &coverage_info,
+          FLAGS_stats_output_file.empty() ? NULL : &stats);
 
   // Log the output.
   std::cout << output;
@@ -188,6 +236,11 @@ static bool Run() {
     WriteStringToFileOrDie(coverage_info, FLAGS_coverage_output_file);
   }
 
+  // Write out the stats report to the appropriate place.
+  if (!FLAGS_stats_output_file.empty()) {
+    WriteStringToFileOrDie(stats, FLAGS_stats_output_file);
+  }
+
   return success;
 }
 
@@ -0,0 +1,61 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/heap_guard.h"
+
+#include "base/logging.h"
+
+namespace gjstest {
+
+HeapGuard::HeapGuard(v8::Isolate* const isolate)
+    : isolate_(CHECK_NOTNULL(isolate)) {
+  isolate_->AddNearHeapLimitCallback(&NearHeapLimit, this);
+}
+
+HeapGuard::~HeapGuard() {
+  isolate_->RemoveNearHeapLimitCallback(&NearHeapLimit, 0);
+}
+
+size_t HeapGuard::NearHeapLimit(
+    void* const data,
+    const size_t current_heap_limit,
+    const size_t initial_heap_limit) {
+  HeapGuard* const guard = static_cast<HeapGuard*>(data);
+
+  // Termination takes effect only once control gets back to JS, so the script
+  // may keep allocating for a while. Give it enough room to get there; if that
+  // isn't enough we'll be called again.
+  guard->terminated_ = true;
+  guard->initial_heap_limit_ = initial_heap_limit;
+  guard->isolate_->TerminateExecution();
+
+  return current_heap_limit + initial_heap_limit / 2;
+}
+
+bool HeapGuard::Recover() {
+  if (!terminated_) return false;
+  terminated_ = false;
+
+  isolate_->CancelTerminateExecution();
+
+  // Collect whatever the terminated script left behind before lowering the
+  // limit again, then start watching for the next time.
+  isolate_->LowMemoryNotification();
+  isolate_->RemoveNearHeapLimitCallback(&NearHeapLimit, initial_heap_limit_);
+  isolate_->AddNearHeapLimitCallback(&NearHeapLimit, this);
+
+  return true;
+}
+
+}  // namespace gjstest
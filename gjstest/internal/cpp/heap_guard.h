@@ -0,0 +1,62 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A class that keeps a test that allocates too much from taking the whole
+// process down with it.
+
+#ifndef GJSTEST_INTERNAL_CPP_HEAP_GUARD_H_
+#define GJSTEST_INTERNAL_CPP_HEAP_GUARD_H_
+
+#include <stddef.h>
+
+#include <v8.h>
+
+#include "base/macros.h"
+
+namespace gjstest {
+
+// Watches an isolate's heap, terminating JS execution when it nears the heap
+// limit instead of letting v8 abort with an out of memory error. The limit is
+// raised for as long as it takes the terminated script to unwind, and restored
+// by Recover.
+class HeapGuard {
+ public:
+  explicit HeapGuard(v8::Isolate* isolate);
+  ~HeapGuard();
+
+  // If execution has been terminated since the last call, allow JS to run
+  // again, reclaim what memory can be reclaimed, restore the original heap
+  // limit, and return true. Otherwise do nothing and return false.
+  bool Recover();
+
+  // The heap limit in bytes that v8 started with. Valid only once Recover has
+  // returned true.
+  size_t initial_heap_limit() const { return initial_heap_limit_; }
+
+ private:
+  static size_t NearHeapLimit(
+      void* data,
+      size_t current_heap_limit,
+      size_t initial_heap_limit);
+
+  v8::Isolate* const isolate_;
+  bool terminated_ = false;
+  size_t initial_heap_limit_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapGuard);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_HEAP_GUARD_H_
@@ -0,0 +1,259 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/module_loader.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "file/file_utils.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+#include "strings/strutil.h"
+#include "util/gtl/map_util.h"
+
+using v8::Context;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::Module;
+using v8::ScriptCompiler;
+using v8::ScriptOrigin;
+using v8::String;
+using v8::Value;
+
+namespace gjstest {
+
+// The loader instantiating modules, for the use of ResolveImport, to which v8
+// gives no other way to find it.
+static ModuleLoader* instantiating_loader = NULL;
+
+// Return the absolute path of the supplied file with symbolic links and "."
+// and ".." components resolved, or an empty string if there's no such file.
+static string GetCanonicalPath(const string& path) {
+  char* const canonical = realpath(path.c_str(), NULL);
+  if (!canonical) return "";
+
+  const string result = canonical;
+  free(canonical);
+  return result;
+}
+
+// Return the path of the file that the supplied specifier, imported by the
+// module at the supplied canonical path, refers to.
+static string ResolveSpecifier(
+    const string& root,
+    const string& importer,
+    const string& specifier) {
+  if (HasPrefixString(specifier, "./") || HasPrefixString(specifier, "../")) {
+    return importer.substr(0, importer.rfind('/') + 1) + specifier;
+  }
+
+  return root + "/" + StripPrefixString(specifier, "/");
+}
+
+struct ModuleLoader::Entry {
+  // The canonical path of the module's file.
+  string path;
+
+  // The compiled module, once it has been read and compiled.
+  v8::Global<Module> module;
+
+  // The modules it imports, by specifier.
+  std::unordered_map<string, Entry*> imports;
+};
+
+// The reading of a single file. Members are destroyed in reverse order, so
+// the thread must be joined before the rest go away.
+struct ModuleLoader::ReadJob {
+  Entry* entry = NULL;
+  std::shared_ptr<const MappedFile> file;
+  string error;
+  std::thread thread;
+};
+
+ModuleLoader::ModuleLoader(
+    Isolate* const isolate,
+    const string& root,
+    const uint32 lookahead)
+    : isolate_(isolate),
+      root_(root.empty() ? "." : root),
+      lookahead_(lookahead) {
+}
+
+ModuleLoader::~ModuleLoader() {
+  for (const auto& job : jobs_) {
+    if (job->thread.joinable()) job->thread.join();
+  }
+}
+
+bool ModuleLoader::Compile(const std::vector<string>& paths) {
+  for (const string& path : paths) {
+    if (!GetEntry(path, path)) return false;
+  }
+
+  while (!queued_.empty() || !jobs_.empty()) {
+    // Keep the background reads going while we compile.
+    while (!queued_.empty() && jobs_.size() < std::max(lookahead_, 1U)) {
+      StartNext();
+    }
+
+    const std::unique_ptr<ReadJob> job = std::move(jobs_.front());
+    jobs_.pop_front();
+
+    if (job->thread.joinable()) {
+      job->thread.join();
+    } else {
+      Read(job.get());
+    }
+
+    if (!CompileRead(job.get())) return false;
+  }
+
+  return true;
+}
+
+MaybeLocal<Value> ModuleLoader::Evaluate(
+    const Local<Context> context,
+    const string& path) {
+  const auto it = entries_.find(GetCanonicalPath(path));
+  CHECK(it != entries_.end()) << "Module not compiled: " << path;
+  const Local<Module> module = Local<Module>::New(isolate_, it->second->module);
+
+  CHECK(instantiating_loader == NULL);
+  instantiating_loader = this;
+  const v8::Maybe<bool> instantiated =
+      module->InstantiateModule(context, &ModuleLoader::ResolveImport);
+  instantiating_loader = NULL;
+
+  if (instantiated.IsNothing()) return MaybeLocal<Value>();
+  return module->Evaluate(context);
+}
+
+MaybeLocal<Module> ModuleLoader::ResolveImport(
+    const Local<Context> context,
+    const Local<String> specifier,
+    const Local<Module> referrer) {
+  ModuleLoader* const loader = CHECK_NOTNULL(instantiating_loader);
+  Isolate* const isolate = loader->isolate_;
+
+  // Every import was resolved when its importer was compiled.
+  const auto range =
+      loader->entries_by_hash_.equal_range(referrer->GetIdentityHash());
+  for (auto it = range.first; it != range.second; ++it) {
+    const Entry& entry = *it->second;
+    if (entry.module != referrer) continue;
+
+    const Entry& imported =
+        *FindOrDie(entry.imports, ConvertToString(isolate, specifier));
+    return Local<Module>::New(isolate, imported.module);
+  }
+
+  LOG(FATAL) << "Unknown module: " << ConvertToString(isolate, specifier);
+  return MaybeLocal<Module>();
+}
+
+void ModuleLoader::Read(ReadJob* const job) {
+  job->file.reset(MappedFile::Open(job->entry->path, false, &job->error));
+}
+
+ModuleLoader::Entry* ModuleLoader::GetEntry(
+    const string& path,
+    const string& description) {
+  const string canonical_path = GetCanonicalPath(path);
+  if (canonical_path.empty()) {
+    ThrowError("Cannot find module " + description);
+    return NULL;
+  }
+
+  std::unique_ptr<Entry>& entry = entries_[canonical_path];
+  if (!entry) {
+    entry.reset(new Entry);
+    entry->path = canonical_path;
+    queued_.push_back(entry.get());
+  }
+
+  return entry.get();
+}
+
+void ModuleLoader::StartNext() {
+  std::unique_ptr<ReadJob> job(new ReadJob);
+  job->entry = queued_.front();
+  queued_.pop_front();
+
+  if (lookahead_ > 0) {
+    job->thread = std::thread(&ModuleLoader::Read, job.get());
+  }
+
+  jobs_.push_back(std::move(job));
+}
+
+bool ModuleLoader::CompileRead(ReadJob* const job) {
+  Entry* const entry = job->entry;
+  if (!job->file) {
+    ThrowError(job->error);
+    return false;
+  }
+
+  // Name modules as the runner names scripts, by their file names.
+  const ScriptOrigin origin(
+      String::NewFromUtf8(isolate_, Basename(entry->path).c_str()),
+      Local<v8::Integer>(),
+      Local<v8::Integer>(),
+      Local<v8::Boolean>(),
+      Local<v8::Integer>(),
+      Local<Value>(),
+      Local<v8::Boolean>(),
+      Local<v8::Boolean>(),
+      v8::True(isolate_));
+
+  ScriptCompiler::Source source(
+      MakeExternalString(isolate_, job->file),
+      origin);
+
+  Local<Module> module;
+  if (!ScriptCompiler::CompileModule(isolate_, &source).ToLocal(&module)) {
+    return false;
+  }
+
+  ++modules_compiled_;
+  source_bytes_compiled_ += job->file->size();
+
+  entry->module.Reset(isolate_, module);
+  entries_by_hash_.emplace(module->GetIdentityHash(), entry);
+
+  // Queue the modules it imports.
+  for (int i = 0; i < module->GetModuleRequestsLength(); ++i) {
+    const string specifier =
+        ConvertToString(isolate_, module->GetModuleRequest(i));
+
+    Entry* const imported =
+        GetEntry(
+            ResolveSpecifier(root_, entry->path, specifier),
+            "'" + specifier + "' imported by " + entry->path);
+
+    if (!imported) return false;
+    entry->imports[specifier] = imported;
+  }
+
+  return true;
+}
+
+void ModuleLoader::ThrowError(const string& message) {
+  isolate_->ThrowException(
+      v8::Exception::Error(String::NewFromUtf8(isolate_, message.c_str())));
+}
+
+}  // namespace gjstest
@@ -0,0 +1,123 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A class that loads ES modules along with the modules they import. The files
+// in a module graph are read on background threads as their imports are
+// discovered, so that reading overlaps with compiling the modules already
+// read, and the whole graph is compiled before any of it is evaluated.
+
+#ifndef GJSTEST_INTERNAL_CPP_MODULE_LOADER_H_
+#define GJSTEST_INTERNAL_CPP_MODULE_LOADER_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <v8.h>
+
+#include "base/integral_types.h"
+#include "base/macros.h"
+
+class MappedFile;
+
+namespace gjstest {
+
+// Import specifiers beginning with "./" or "../" are resolved relative to the
+// importing module. Any others, such as "lib/foo.js" or "/lib/foo.js", are
+// resolved relative to the root directory. Each file is loaded once however
+// it's reached, so a module imported by many others, including through
+// symbolic links, is instantiated and evaluated only once.
+class ModuleLoader {
+ public:
+  // Prepare to load modules, resolving imports relative to the supplied root
+  // directory, or the current directory if it's empty. At most lookahead files
+  // are read in the background at any one time; with a lookahead of zero, each
+  // file is read on the calling thread when it's about to be compiled.
+  ModuleLoader(v8::Isolate* isolate, const std::string& root, uint32 lookahead);
+
+  // Wait for any outstanding background work. The isolate must still exist.
+  ~ModuleLoader();
+
+  // Read and compile the modules at the supplied paths, which are relative to
+  // the current directory, and every module they import. Return false in the
+  // event of an error, which can be recovered by creating a TryCatch object on
+  // the stack first, exactly as with CompileJs.
+  bool Compile(const std::vector<std::string>& paths);
+
+  // Instantiate and evaluate the module at the supplied path, which must have
+  // been passed to Compile, along with any modules it imports that haven't
+  // been evaluated yet. Return an empty handle in the event of an error, as
+  // above.
+  v8::MaybeLocal<v8::Value> Evaluate(
+      v8::Local<v8::Context> context,
+      const std::string& path);
+
+  // The number of modules compiled so far, and the size of their source.
+  uint32 modules_compiled() const { return modules_compiled_; }
+  size_t source_bytes_compiled() const { return source_bytes_compiled_; }
+
+ private:
+  struct Entry;
+  struct ReadJob;
+
+  // Find the module the supplied module imports by the supplied specifier.
+  // Used as v8's resolve callback while instantiating.
+  static v8::MaybeLocal<v8::Module> ResolveImport(
+      v8::Local<v8::Context> context,
+      v8::Local<v8::String> specifier,
+      v8::Local<v8::Module> referrer);
+
+  // Read the file for the supplied job, recording any error.
+  static void Read(ReadJob* job);
+
+  // Return the entry for the file at the supplied path, creating it and
+  // queueing the file to be read if it hasn't been seen before. Return NULL,
+  // having thrown an exception, if there's no such file.
+  Entry* GetEntry(const std::string& path, const std::string& description);
+
+  // Start reading the next queued file.
+  void StartNext();
+
+  // Compile the module read by the supplied job, and queue the modules it
+  // imports. Return false if an exception is pending.
+  bool CompileRead(ReadJob* job);
+
+  void ThrowError(const std::string& message);
+
+  v8::Isolate* const isolate_;
+  const std::string root_;
+  const uint32 lookahead_;
+
+  // Every module seen so far, by canonical path, and the compiled ones by
+  // their identity hashes so that ResolveImport can find them.
+  std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+  std::unordered_multimap<int, Entry*> entries_by_hash_;
+
+  // Modules waiting to be read, and background reads started but not yet
+  // consumed, in the order in which they were queued.
+  std::deque<Entry*> queued_;
+  std::deque<std::unique_ptr<ReadJob>> jobs_;
+
+  uint32 modules_compiled_ = 0;
+  size_t source_bytes_compiled_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleLoader);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_MODULE_LOADER_H_
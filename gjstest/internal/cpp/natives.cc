@@ -0,0 +1,722 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/natives.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include <re2/re2.h>
+
+#include "base/integral_types.h"
+#include "base/logging.h"
+#include "file/file_utils.h"
+#include "gjstest/internal/cpp/buffer_compare.h"
+#include "gjstest/internal/cpp/diff.h"
+
+using v8::Context;
+using v8::Isolate;
+using v8::Local;
+using v8::Object;
+using v8::String;
+using v8::Value;
+
+namespace gjstest {
+
+// The most patterns that Natives::MatchRe2 keeps compiled at once, and the
+// shortest string whose encoding it keeps.
+static const size_t kMaxCachedRe2Patterns = 1000;
+static const int kMinCachedRe2TextLength = 4096;
+
+// Is the supplied value an array buffer, shared array buffer, or view of one?
+static bool HasBytes(const Local<Value>& value) {
+  return
+      value->IsArrayBufferView() ||
+      value->IsArrayBuffer() ||
+      value->IsSharedArrayBuffer();
+}
+
+// Find the bytes held by an array buffer, shared array buffer, or view of one.
+static void GetBytes(
+    Local<Value> value,
+    const uint8** data,
+    size_t* length) {
+  v8::ArrayBuffer::Contents contents;
+  size_t offset = 0;
+
+  if (value->IsArrayBufferView()) {
+    const Local<v8::ArrayBufferView> view =
+        Local<v8::ArrayBufferView>::Cast(value);
+    contents = view->Buffer()->GetContents();
+    offset = view->ByteOffset();
+    *length = view->ByteLength();
+  } else if (value->IsArrayBuffer()) {
+    contents = Local<v8::ArrayBuffer>::Cast(value)->GetContents();
+    *length = contents.ByteLength();
+  } else {
+    CHECK(value->IsSharedArrayBuffer());
+    const v8::SharedArrayBuffer::Contents shared_contents =
+        Local<v8::SharedArrayBuffer>::Cast(value)->GetContents();
+    *data = static_cast<const uint8*>(shared_contents.Data());
+    *length = shared_contents.ByteLength();
+    return;
+  }
+
+  *data = static_cast<const uint8*>(contents.Data()) + offset;
+}
+
+// A mapping of a test data file that backs an array buffer, which is kept
+// until the buffer has been garbage collected.
+struct MappedBuffer {
+  std::unique_ptr<MappedFile> file;
+  v8::Global<v8::ArrayBuffer> buffer;
+};
+
+static void DeleteMappedBuffer(const v8::WeakCallbackInfo<MappedBuffer>& info) {
+  MappedBuffer* const mapped = info.GetParameter();
+  info.GetIsolate()->AdjustAmountOfExternalAllocatedMemory(
+      -static_cast<int64>(mapped->file->size()));
+
+  delete mapped;
+}
+
+// V8 only allows handles to be reset in the first pass, so leave the mapping
+// itself to the second.
+static void ReleaseMappedBuffer(
+    const v8::WeakCallbackInfo<MappedBuffer>& info) {
+  info.GetParameter()->buffer.Reset();
+  info.SetSecondPassCallback(&DeleteMappedBuffer);
+}
+
+Natives::Natives(
+    Isolate* const isolate,
+    Local<Context> context,
+    const string& test_data_dir)
+    : isolate_(CHECK_NOTNULL(isolate)),
+      stringifier_(isolate, context),
+      test_data_dir_(test_data_dir) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Context::Scope context_scope(context);
+
+  const Local<Object> natives = Object::New(isolate_);
+
+  AddFunction(
+      natives,
+      "stringifyToDepth",
+      std::bind(&Natives::StringifyToDepth, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "findByteDifference",
+      std::bind(&Natives::FindByteDifference, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "findElementDifference",
+      std::bind(&Natives::FindElementDifference, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "computeDiff",
+      std::bind(&Natives::ComputeDiff, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "captureStack",
+      std::bind(&Natives::CaptureStack, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "serializeValue",
+      std::bind(&Natives::SerializeValue, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "deserializeValue",
+      std::bind(&Natives::DeserializeValue, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "mapFile",
+      std::bind(&Natives::MapFile, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "readFile",
+      std::bind(&Natives::ReadFile, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "decodeUtf8",
+      std::bind(&Natives::DecodeUtf8, this, std::placeholders::_1));
+
+  AddFunction(
+      natives,
+      "matchRe2",
+      std::bind(&Natives::MatchRe2, this, std::placeholders::_1));
+
+  CHECK(
+      context->Global()->Set(
+          context,
+          String::NewFromUtf8(isolate_, "gjstestNatives"),
+          natives).FromJust());
+}
+
+Natives::~Natives() {}
+
+void Natives::AddFunction(
+    Local<Object> natives,
+    const char* name,
+    const V8FunctionCallback& callback) {
+  callbacks_.emplace_back(new V8FunctionCallback(callback));
+
+  const Local<Context> context = isolate_->GetCurrentContext();
+  CHECK(
+      natives->Set(
+          context,
+          String::NewFromUtf8(isolate_, name),
+          MakeFunction(isolate_, name, callbacks_.back().get())).FromJust());
+}
+
+void Natives::ThrowError(const string& message) {
+  isolate_->ThrowException(
+      v8::Exception::Error(String::NewFromUtf8(isolate_, message.c_str())));
+}
+
+void Natives::ThrowTypeError(const string& message) {
+  isolate_->ThrowException(
+      v8::Exception::TypeError(
+          String::NewFromUtf8(isolate_, message.c_str())));
+}
+
+bool Natives::GetTestDataPath(Local<Value> path_value, string* full_path) {
+  if (test_data_dir_.empty()) {
+    ThrowError("No test data directory was configured. See --test_data_dir.");
+    return false;
+  }
+
+  // Keep tests from depending on files outside the directory.
+  const string path = ConvertToString(isolate_, path_value);
+  bool escapes = path.empty() || path[0] == '/';
+  for (size_t begin = 0; begin <= path.size() && !escapes;) {
+    size_t end = path.find('/', begin);
+    if (end == string::npos) end = path.size();
+
+    escapes = path.compare(begin, end - begin, "..") == 0;
+    begin = end + 1;
+  }
+
+  if (escapes) {
+    ThrowError("Test data paths must be relative and within the directory: " +
+               path);
+    return false;
+  }
+
+  *full_path = test_data_dir_ + "/" + path;
+  return true;
+}
+
+Local<Value> Natives::StringifyToDepth(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(2, cb_info.Length());
+  const int depth =
+      cb_info[1]->Int32Value(isolate_->GetCurrentContext()).FromMaybe(0);
+
+  // Leave any exception thrown by user code to propagate.
+  Local<String> result;
+  if (!stringifier_.StringifyToDepth(cb_info[0], depth).ToLocal(&result)) {
+    return Local<Value>();
+  }
+
+  return result;
+}
+
+Local<Value> Natives::FindByteDifference(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(2, cb_info.Length());
+
+  if (!HasBytes(cb_info[0]) || !HasBytes(cb_info[1])) {
+    ThrowTypeError(
+        "findByteDifference requires array buffers or views of them.");
+    return Local<Value>();
+  }
+
+  const uint8* a = NULL;
+  const uint8* b = NULL;
+  size_t a_length = 0;
+  size_t b_length = 0;
+  GetBytes(cb_info[0], &a, &a_length);
+  GetBytes(cb_info[1], &b, &b_length);
+
+  const size_t length = std::min(a_length, b_length);
+  const size_t offset = gjstest::FindFirstByteDifference(a, b, length);
+
+  return v8::Number::New(
+      isolate_,
+      offset == length ? -1 : static_cast<double>(offset));
+}
+
+Local<Value> Natives::FindElementDifference(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(3, cb_info.Length());
+
+  if (!cb_info[0]->IsTypedArray() || !cb_info[1]->IsTypedArray()) {
+    ThrowTypeError("findElementDifference requires two typed arrays.");
+    return Local<Value>();
+  }
+
+  const Local<v8::TypedArray> a_array = Local<v8::TypedArray>::Cast(cb_info[0]);
+  const Local<v8::TypedArray> b_array = Local<v8::TypedArray>::Cast(cb_info[1]);
+  if (a_array->IsFloat32Array() != b_array->IsFloat32Array() ||
+      a_array->IsFloat64Array() != b_array->IsFloat64Array()) {
+    ThrowTypeError(
+        "findElementDifference requires typed arrays of the same type.");
+    return Local<Value>();
+  }
+
+  const size_t count = std::min(a_array->Length(), b_array->Length());
+
+  const uint8* a = NULL;
+  const uint8* b = NULL;
+  size_t a_length = 0;
+  size_t b_length = 0;
+  GetBytes(a_array, &a, &a_length);
+  GetBytes(b_array, &b, &b_length);
+
+  // Only floats have a tolerance. Other elements match iff their bytes do.
+  size_t index = count;
+  if (a_array->IsFloat32Array() || a_array->IsFloat64Array()) {
+    double max_ulps;
+    if (!cb_info[2]->NumberValue(isolate_->GetCurrentContext())
+             .To(&max_ulps)) {
+      return Local<Value>();
+    }
+
+    if (!(max_ulps >= 0)) {
+      ThrowTypeError(
+          "findElementDifference requires a non-negative ULP tolerance.");
+      return Local<Value>();
+    }
+
+    const uint64 max_ulps_int =
+        max_ulps >= kuint64max ? kuint64max : static_cast<uint64>(max_ulps);
+
+    if (a_array->IsFloat32Array()) {
+      index =
+          gjstest::FindFirstFloatDifference(
+              reinterpret_cast<const float*>(a),
+              reinterpret_cast<const float*>(b),
+              count,
+              max_ulps_int);
+    } else {
+      index =
+          gjstest::FindFirstDoubleDifference(
+              reinterpret_cast<const double*>(a),
+              reinterpret_cast<const double*>(b),
+              count,
+              max_ulps_int);
+    }
+  } else if (count > 0) {
+    const size_t element_size = a_length / a_array->Length();
+    if (element_size != b_length / b_array->Length()) {
+      ThrowTypeError(
+          "findElementDifference requires typed arrays of the same type.");
+      return Local<Value>();
+    }
+
+    index =
+        gjstest::FindFirstByteDifference(a, b, count * element_size) /
+        element_size;
+  }
+
+  return v8::Number::New(
+      isolate_,
+      index == count ? -1 : static_cast<double>(index));
+}
+
+Local<Value> Natives::ComputeDiff(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(4, cb_info.Length());
+  const Local<Context> context = isolate_->GetCurrentContext();
+
+  const bool strings = cb_info[0]->IsString() && cb_info[1]->IsString();
+  if (!strings &&
+      !(cb_info[0]->IsInt32Array() && cb_info[1]->IsInt32Array())) {
+    ThrowTypeError("computeDiff requires two strings or two Int32Arrays.");
+    return Local<Value>();
+  }
+
+  // Conversion may run user code; pass on anything it throws.
+  uint32 max_edits = 0;
+  double max_comparisons = 0;
+  if (!cb_info[2]->Uint32Value(context).To(&max_edits) ||
+      !cb_info[3]->NumberValue(context).To(&max_comparisons)) {
+    return Local<Value>();
+  }
+
+  DiffBudget budget;
+  budget.max_edits = max_edits;
+  budget.max_comparisons = max_comparisons;
+
+  bool complete = false;
+  std::vector<DiffHunk> hunks;
+
+  if (strings) {
+    // Diff the UTF-16 code units of two strings.
+    const Local<String> a_string = Local<String>::Cast(cb_info[0]);
+    const Local<String> b_string = Local<String>::Cast(cb_info[1]);
+
+    std::vector<uint16> a(a_string->Length());
+    std::vector<uint16> b(b_string->Length());
+    a_string->Write(
+        isolate_,
+        a.data(),
+        0,
+        a.size(),
+        String::NO_NULL_TERMINATION);
+    b_string->Write(
+        isolate_,
+        b.data(),
+        0,
+        b.size(),
+        String::NO_NULL_TERMINATION);
+
+    hunks =
+        gjstest::ComputeDiff(
+            a.data(),
+            a.size(),
+            b.data(),
+            b.size(),
+            budget,
+            &complete);
+  } else {
+    // Diff two arrays of tokens.
+    const uint8* a = NULL;
+    const uint8* b = NULL;
+    size_t a_length = 0;
+    size_t b_length = 0;
+    GetBytes(cb_info[0], &a, &a_length);
+    GetBytes(cb_info[1], &b, &b_length);
+
+    hunks =
+        gjstest::ComputeDiff(
+            reinterpret_cast<const int32*>(a),
+            a_length / sizeof(int32),
+            reinterpret_cast<const int32*>(b),
+            b_length / sizeof(int32),
+            budget,
+            &complete);
+  }
+
+  // Return { hunks: [[aBegin, aEnd, bBegin, bEnd], ...], complete: bool }.
+  const Local<v8::Array> hunk_array = v8::Array::New(isolate_, hunks.size());
+  for (size_t i = 0; i < hunks.size(); ++i) {
+    const double bounds[] = {
+      static_cast<double>(hunks[i].a_begin),
+      static_cast<double>(hunks[i].a_end),
+      static_cast<double>(hunks[i].b_begin),
+      static_cast<double>(hunks[i].b_end),
+    };
+
+    const Local<v8::Array> hunk = v8::Array::New(isolate_, arraysize(bounds));
+    for (size_t j = 0; j < arraysize(bounds); ++j) {
+      CHECK(hunk->Set(context, j, v8::Number::New(isolate_, bounds[j]))
+                .FromJust());
+    }
+
+    CHECK(hunk_array->Set(context, i, hunk).FromJust());
+  }
+
+  const Local<Object> result = Object::New(isolate_);
+  CHECK(
+      result->Set(
+          context,
+          String::NewFromUtf8(isolate_, "hunks"),
+          hunk_array).FromJust());
+  CHECK(
+      result->Set(
+          context,
+          String::NewFromUtf8(isolate_, "complete"),
+          v8::Boolean::New(isolate_, complete)).FromJust());
+
+  return result;
+}
+
+Local<Value> Natives::CaptureStack(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(1, cb_info.Length());
+  const Local<Context> context = isolate_->GetCurrentContext();
+  const int limit = cb_info[0]->Int32Value(context).FromMaybe(0);
+
+  // Only ask for the locations, so that V8 doesn't need to work out function
+  // names or columns.
+  const Local<v8::StackTrace> stack_trace =
+      v8::StackTrace::CurrentStackTrace(
+          isolate_,
+          std::max(limit, 0),
+          static_cast<v8::StackTrace::StackTraceOptions>(
+              v8::StackTrace::kScriptNameOrSourceURL |
+              v8::StackTrace::kLineNumber));
+
+  const int frame_count = stack_trace->GetFrameCount();
+  const Local<v8::Array> result = v8::Array::New(isolate_, 2 * frame_count);
+  for (int i = 0; i < frame_count; ++i) {
+    const Local<v8::StackFrame> frame = stack_trace->GetFrame(isolate_, i);
+
+    // Eval'd code without a source URL has no name.
+    Local<Value> file_name = frame->GetScriptNameOrSourceURL();
+    if (file_name.IsEmpty() ||
+        !file_name->IsString() ||
+        Local<String>::Cast(file_name)->Length() == 0) {
+      file_name = v8::Null(isolate_);
+    }
+
+    const int line_number = frame->GetLineNumber();
+    const Local<Value> line =
+        line_number == v8::Message::kNoLineNumberInfo
+            ? Local<Value>(v8::Null(isolate_))
+            : Local<Value>(v8::Integer::New(isolate_, line_number));
+
+    CHECK(result->Set(context, 2 * i, file_name).FromJust());
+    CHECK(result->Set(context, 2 * i + 1, line).FromJust());
+  }
+
+  return result;
+}
+
+Local<Value> Natives::SerializeValue(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(1, cb_info.Length());
+  const Local<Context> context = isolate_->GetCurrentContext();
+
+  // Leave the DataCloneError thrown for values that can't be cloned to
+  // propagate.
+  v8::ValueSerializer serializer(isolate_);
+  serializer.WriteHeader();
+  if (serializer.WriteValue(context, cb_info[0]).IsNothing()) {
+    return Local<Value>();
+  }
+
+  // The serializer's buffer was allocated with realloc.
+  const std::pair<uint8_t*, size_t> bytes = serializer.Release();
+  const Local<v8::ArrayBuffer> result =
+      v8::ArrayBuffer::New(isolate_, bytes.second);
+  memcpy(result->GetContents().Data(), bytes.first, bytes.second);
+  free(bytes.first);
+
+  return result;
+}
+
+Local<Value> Natives::DeserializeValue(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(1, cb_info.Length());
+  const Local<Context> context = isolate_->GetCurrentContext();
+
+  if (!cb_info[0]->IsArrayBuffer()) {
+    ThrowError("Serialized values must be ArrayBuffers.");
+    return Local<Value>();
+  }
+
+  const uint8* data = NULL;
+  size_t length = 0;
+  GetBytes(cb_info[0], &data, &length);
+
+  v8::ValueDeserializer deserializer(isolate_, data, length);
+  Local<Value> result;
+  if (deserializer.ReadHeader(context).IsNothing() ||
+      !deserializer.ReadValue(context).ToLocal(&result)) {
+    return Local<Value>();
+  }
+
+  return result;
+}
+
+Local<Value> Natives::MapFile(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(1, cb_info.Length());
+
+  string path;
+  string error;
+  if (!GetTestDataPath(cb_info[0], &path)) {
+    return Local<Value>();
+  }
+
+  std::unique_ptr<MappedFile> file(MappedFile::Open(path, true, &error));
+  if (!file) {
+    ThrowError(error);
+    return Local<Value>();
+  }
+
+  // There's nothing to map for an empty file.
+  if (file->size() == 0) {
+    return v8::ArrayBuffer::New(isolate_, 0);
+  }
+
+  // Let the buffer use the mapping directly, unmapping it once the buffer has
+  // been collected. The mapping is private, so writes to the buffer don't
+  // reach the file.
+  const Local<v8::ArrayBuffer> result =
+      v8::ArrayBuffer::New(
+          isolate_,
+          file->mutable_data(),
+          file->size(),
+          v8::ArrayBufferCreationMode::kExternalized);
+
+  isolate_->AdjustAmountOfExternalAllocatedMemory(file->size());
+
+  MappedBuffer* const mapped = new MappedBuffer;
+  mapped->file = std::move(file);
+  mapped->buffer.Reset(isolate_, result);
+  mapped->buffer.SetWeak(
+      mapped,
+      &ReleaseMappedBuffer,
+      v8::WeakCallbackType::kParameter);
+
+  return result;
+}
+
+Local<Value> Natives::ReadFile(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(1, cb_info.Length());
+
+  string path;
+  string error;
+  if (!GetTestDataPath(cb_info[0], &path)) {
+    return Local<Value>();
+  }
+
+  const std::shared_ptr<const MappedFile> file(
+      MappedFile::Open(path, false, &error));
+  if (!file) {
+    ThrowError(error);
+    return Local<Value>();
+  }
+
+  if (file->size() > static_cast<size_t>(String::kMaxLength)) {
+    ThrowError("Test data file is too large for a string: " + path);
+    return Local<Value>();
+  }
+
+  return MakeExternalString(isolate_, file);
+}
+
+Local<Value> Natives::DecodeUtf8(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(3, cb_info.Length());
+  const Local<Context> context = isolate_->GetCurrentContext();
+
+  if (!cb_info[0]->IsArrayBuffer()) {
+    ThrowError("Only ArrayBuffers can be decoded.");
+    return Local<Value>();
+  }
+
+  const uint8* data = NULL;
+  size_t length = 0;
+  GetBytes(cb_info[0], &data, &length);
+
+  // The buffer may have shrunk since the range was computed, e.g. by being
+  // transferred to a worker.
+  uint32 begin;
+  uint32 end;
+  if (!cb_info[1]->Uint32Value(context).To(&begin) ||
+      !cb_info[2]->Uint32Value(context).To(&end)) {
+    return Local<Value>();
+  }
+
+  if (begin > end || end > length) {
+    ThrowError("The byte range to decode is outside of the buffer.");
+    return Local<Value>();
+  }
+
+  Local<String> result;
+  if (!String::NewFromUtf8(
+          isolate_,
+          reinterpret_cast<const char*>(data + begin),
+          v8::NewStringType::kNormal,
+          end - begin).ToLocal(&result)) {
+    ThrowError("Decoded string is too long.");
+    return Local<Value>();
+  }
+
+  return result;
+}
+
+Local<Value> Natives::MatchRe2(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  CHECK_EQ(3, cb_info.Length());
+  if (!cb_info[0]->IsString() || !cb_info[1]->IsString()) {
+    ThrowTypeError("matchRe2 requires a string pattern and string text.");
+    return Local<Value>();
+  }
+
+  // Compile the pattern the first time it's seen. Invalid patterns are kept
+  // too, so that they fail just as quickly the next time.
+  const string pattern = ConvertToString(isolate_, cb_info[0]);
+  auto it = re2_cache_.find(pattern);
+  if (it == re2_cache_.end()) {
+    if (re2_cache_.size() >= kMaxCachedRe2Patterns) {
+      re2_cache_.clear();
+    }
+
+    RE2::Options options;
+    options.set_log_errors(false);
+    it =
+        re2_cache_.emplace(
+            pattern,
+            std::unique_ptr<RE2>(new RE2(pattern, options))).first;
+  }
+
+  const RE2& re = *it->second;
+  if (!re.ok()) {
+    ThrowError("Invalid RE2 pattern " + pattern + ": " + re.error());
+    return Local<Value>();
+  }
+
+  // Encoding a large string can take longer than matching it, so keep the
+  // encoding of the last one around.
+  const Local<String> text = Local<String>::Cast(cb_info[1]);
+  string short_text_utf8;
+  const string* text_utf8 = &re2_text_utf8_;
+  if (text->Length() < kMinCachedRe2TextLength) {
+    short_text_utf8 = ConvertToString(isolate_, text);
+    text_utf8 = &short_text_utf8;
+  } else if (re2_text_ != text) {
+    re2_text_.Reset(isolate_, text);
+    re2_text_.SetWeak(
+        this,
+        &Natives::ReleaseRe2Text,
+        v8::WeakCallbackType::kParameter);
+    re2_text_utf8_ = ConvertToString(isolate_, text);
+  }
+
+  const Local<Context> context = isolate_->GetCurrentContext();
+  const bool full_match = cb_info[2]->BooleanValue(context).FromJust();
+  const bool matched =
+      full_match ?
+          RE2::FullMatch(*text_utf8, re) :
+          RE2::PartialMatch(*text_utf8, re);
+
+  return v8::Boolean::New(isolate_, matched);
+}
+
+void Natives::ReleaseRe2Text(const v8::WeakCallbackInfo<Natives>& info) {
+  Natives* const natives = info.GetParameter();
+  natives->re2_text_.Reset();
+  string().swap(natives->re2_text_utf8_);
+}
+
+}  // namespace gjstest
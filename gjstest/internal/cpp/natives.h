@@ -0,0 +1,174 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Functions that gjstest's JS code can use in place of slower JS
+// implementations when running under the gjstest binary.
+
+#ifndef GJSTEST_INTERNAL_CPP_NATIVES_H_
+#define GJSTEST_INTERNAL_CPP_NATIVES_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <v8.h>
+
+#include "base/macros.h"
+#include "gjstest/internal/cpp/stringify.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+
+namespace re2 {
+class RE2;
+}  // namespace re2
+
+namespace gjstest {
+
+// Installs the native functions as properties of a global object named
+// gjstestNatives, which namespace.js moves to gjstest.internal.natives. The
+// functions are:
+//
+//     stringifyToDepth(value, depth)
+//         Equivalent to gjstest.internal.stringifyToDepth.
+//
+//     findByteDifference(a, b)
+//         Equivalent to gjstest.internal.findByteDifference.
+//
+//     findElementDifference(a, b, maxUlps)
+//         Equivalent to gjstest.internal.findElementDifference.
+//
+//     computeDiff(a, b, maxEdits, maxComparisons)
+//         Equivalent to gjstest.internal.computeDiff.
+//
+//     captureStack(limit)
+//         Return the file name and line number of up to limit frames of the
+//         current stack, starting with the function that called captureStack,
+//         as a flat array [fileName, lineNumber, fileName, lineNumber, ...].
+//         Either may be null if unknown. Unlike error stacks, this doesn't
+//         include frames for built-in functions.
+//
+//     serializeValue(value)
+//         Return an ArrayBuffer holding a structured clone of value, as
+//         written by v8::ValueSerializer, or throw a DataCloneError if value
+//         contains something that can't be cloned, such as a function.
+//
+//     deserializeValue(buffer)
+//         Return a new copy of the value serialized into buffer by
+//         serializeValue.
+//
+//     mapFile(path)
+//         Return an ArrayBuffer backed directly by a copy-on-write mapping of
+//         the file at the supplied path, relative to the test data directory.
+//         The mapping is released when the buffer is garbage collected.
+//         Throws an error if the path is absolute, leaves the directory, or
+//         can't be mapped.
+//
+//     readFile(path)
+//         Like mapFile, but return the file's contents decoded as UTF-8.
+//         Files that are pure ASCII aren't copied.
+//
+//     decodeUtf8(buffer, begin, end)
+//         Return the bytes [begin, end) of an ArrayBuffer decoded as UTF-8.
+//
+//     matchRe2(pattern, text, fullMatch)
+//         Return whether the string text matches the RE2 pattern, either in
+//         full or in part. This takes time linear in the length of text.
+//         Throws an error if the pattern is invalid.
+//
+class Natives {
+ public:
+  // Install the functions in the supplied context, which must not have run any
+  // scripts yet. The object must outlive any use of the functions. Test data
+  // files are found in test_data_dir, or not at all if it's empty.
+  Natives(
+      v8::Isolate* isolate,
+      v8::Local<v8::Context> context,
+      const std::string& test_data_dir);
+  ~Natives();
+
+ private:
+  // Add a function with the supplied name to the natives object.
+  void AddFunction(
+      v8::Local<v8::Object> natives,
+      const char* name,
+      const V8FunctionCallback& callback);
+
+  v8::Local<v8::Value> StringifyToDepth(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> FindByteDifference(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> FindElementDifference(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> ComputeDiff(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> CaptureStack(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> SerializeValue(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> DeserializeValue(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> MapFile(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> ReadFile(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> DecodeUtf8(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> MatchRe2(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Find the full path of the test data file named by a JS value, returning
+  // false after throwing an error if it isn't a permitted path.
+  bool GetTestDataPath(v8::Local<v8::Value> path, std::string* full_path);
+
+  // Forget re2_text_ and its encoding once the string has been collected.
+  static void ReleaseRe2Text(const v8::WeakCallbackInfo<Natives>& info);
+
+  // Throw an error, or a TypeError, with the supplied message.
+  void ThrowError(const std::string& message);
+  void ThrowTypeError(const std::string& message);
+
+  v8::Isolate* const isolate_;
+  Stringifier stringifier_;
+  const std::string test_data_dir_;
+
+  // The patterns compiled by matchRe2, including invalid ones, keyed by
+  // source. This is cleared when it grows too large.
+  std::unordered_map<std::string, std::unique_ptr<re2::RE2>> re2_cache_;
+
+  // The last large string matched by matchRe2 and its UTF-8 encoding, which
+  // is reused when the same string is matched against several patterns. The
+  // string is held weakly, and the encoding is dropped along with it, so
+  // that neither outlives the test that matched it.
+  v8::Global<v8::String> re2_text_;
+  std::string re2_text_utf8_;
+
+  // The callbacks wrapped by the functions.
+  std::vector<std::unique_ptr<V8FunctionCallback>> callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(Natives);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_NATIVES_H_
@@ -15,10 +15,17 @@
 
 #include "gjstest/internal/cpp/run_tests.h"
 
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include <gflags/gflags.h>
 #include <re2/re2.h>
 #include <v8.h>
 
@@ -29,8 +36,15 @@
 #include "base/stl_decl.h"
 #include "base/stringprintf.h"
 #include "base/timer.h"
+#include "gjstest/internal/cpp/event_loop.h"
+#include "gjstest/internal/cpp/heap_guard.h"
+#include "gjstest/internal/cpp/module_loader.h"
+#include "gjstest/internal/cpp/natives.h"
+#include "gjstest/internal/cpp/script_pipeline.h"
 #include "gjstest/internal/cpp/test_case.h"
+#include "gjstest/internal/cpp/typed_arrays.h"
 #include "gjstest/internal/cpp/v8_utils.h"
+#include "gjstest/internal/cpp/workers.h"
 #include "gjstest/internal/proto/named_scripts.pb.h"
 #include "strings/strutil.h"
 #include "util/gtl/map_util.h"
@@ -46,11 +60,50 @@ using v8::MaybeLocal;
 using v8::Object;
 using v8::ObjectTemplate;
 using v8::Persistent;
-using v8::String;
 using v8::TryCatch;
 using v8::Undefined;
+using v8::UnboundScript;
 using v8::Value;
 
+DEFINE_int64(array_buffer_budget_bytes, 0,
+             "If positive, fail any test during which the array buffers "
+             "live at once total more than this many bytes.");
+
+DEFINE_int32(max_old_space_mb, 0,
+             "If positive, the size in MB of v8's old generation heap. A test "
+             "that nearly exhausts it is stopped and marked as failed, and "
+             "the remaining tests carry on.");
+
+DEFINE_int32(max_semi_space_kb, 0,
+             "If positive, the size in KB of each of v8's young generation "
+             "semi-spaces.");
+
+DEFINE_double(idle_time_ms, 1,
+              "The time in milliseconds to give v8 for garbage collection and "
+              "idle tasks after loading the scripts and after each test. Zero "
+              "disables idle-time work.");
+
+DEFINE_string(test_data_dir, "",
+              "The directory in which gjstest.readFile, gjstest.mapFile and "
+              "gjstest.readLines find test data files.");
+
+DEFINE_int32(compile_lookahead, 8,
+             "The number of scripts to read and compile in the background "
+             "while earlier scripts run, and of ES modules to read in the "
+             "background while others compile. Zero reads and compiles each "
+             "script or module only when it is needed.");
+
+DEFINE_int32(async_test_timeout_ms, 5000,
+             "The time in milliseconds that a test returning a promise has "
+             "for the promise to settle before it's marked as failed.");
+
+DEFINE_int32(async_test_concurrency, 8,
+             "The largest number of tests returning promises to keep running "
+             "at once; while the running tests wait for timers, the next one "
+             "is started. Ignored when collecting stats or enforcing "
+             "--array_buffer_budget_bytes, which need tests run one at a "
+             "time.");
+
 namespace gjstest {
 
 // JS code that can be executed to extract the information generated by
@@ -73,6 +126,10 @@ static const char kCoverageExtractionJs[] =
     "}"
     "_$coverageout;";
 
+// A map from counter names to values, as returned by
+// gjstest.internal.takeStats.
+typedef std::map<string, double> Counters;
+
 // Create XML output given an overall duration in seconds, a list of test names
 // in the order of execution, a map from test names to durations, and a map from
 // failed test names to failure messages.
@@ -119,6 +176,45 @@ static string MakeXml(
   return xml_writer.GetContent();
 }
 
+// Create an XML stats report given counters for the whole run, a list of test
+// names in the order of execution, and a map from test names to the counters
+// for that test.
+static string MakeStatsXml(
+    const Counters& run_counters,
+    const std::vector<string>& tests_run,
+    const std::unordered_map<std::string, Counters>& test_counters) {
+  webutil_xml::XmlWriter xml_writer("UTF-8", true);
+  xml_writer.StartDocument("UTF-8");
+
+  xml_writer.StartElement("stats");
+
+  xml_writer.StartElement("run");
+  for (const auto& counter : run_counters) {
+    xml_writer.AddAttribute(counter.first, SimpleDtoa(counter.second));
+  }
+  xml_writer.EndElement();  // run
+
+  for (uint32 i = 0; i < tests_run.size(); ++i) {
+    const string& name = tests_run[i];
+
+    // Skip the tests that weren't actually run.
+    if (!ContainsKey(test_counters, name)) continue;
+
+    xml_writer.StartElement("testcase");
+    xml_writer.AddAttribute("name", name);
+
+    for (const auto& counter : FindOrDie(test_counters, name)) {
+      xml_writer.AddAttribute(counter.first, SimpleDtoa(counter.second));
+    }
+
+    xml_writer.EndElement();  // testcase
+  }
+
+  xml_writer.EndElement();  // stats
+
+  return xml_writer.GetContent();
+}
+
 // Get a reference to the function of the supplied name.
 static Local<Function> GetFunctionNamed(
     v8::Isolate* const isolate,
@@ -131,80 +227,408 @@ static Local<Function> GetFunctionNamed(
   return Local<Function>::Cast(result);
 }
 
-static void ProcessTestCase(
+// Call gjstest.internal.takeStats (supplied as take_stats), adding the counters
+// it returns to *counters.
+static void TakeCounters(
     v8::Isolate* const isolate,
+    const Local<Function>& take_stats,
+    Counters* counters) {
+  const Local<Context> context = isolate->GetCurrentContext();
+  const Local<Value> stats_value =
+      take_stats->Call(context, context->Global(), 0, NULL).ToLocalChecked();
+  CHECK(stats_value->IsObject());
+  const Local<Object> stats = Local<Object>::Cast(stats_value);
+
+  const Local<Array> names = stats->GetPropertyNames();
+  for (uint32 i = 0; i < names->Length(); ++i) {
+    const Local<Value> name = names->Get(i);
+    const double value =
+        stats->Get(name)->NumberValue(context).FromMaybe(0);
+
+    (*counters)[ConvertToString(isolate, name)] += value;
+  }
+}
+
+// Return a failure message for code that was terminated by the supplied guard.
+static string DescribeHeapExhaustion(const HeapGuard& heap_guard) {
+  return StringPrintf(
+      "Terminated after nearly exhausting the JS heap limit of %zu MB. "
+      "See --max_old_space_mb.\n\n",
+      heap_guard.initial_heap_limit() >> 20);
+}
+
+// Let v8 finish up work posted while running scripts or a test, and then make
+// use of a short idle period before the next test.
+static void SettleIsolate(v8::Isolate* const isolate) {
+  RunPendingTasks(isolate);
+
+  if (FLAGS_idle_time_ms > 0) {
+    GiveIdleTime(isolate, FLAGS_idle_time_ms / 1000.0);
+  }
+}
+
+// The state of a run shared by the functions below.
+struct TestRun {
+  v8::Isolate* isolate;
+  EventLoop* event_loop;
+  Workers* workers;
+  Local<Function> take_stats;
+  ArrayBufferAllocator* allocator;
+  HeapGuard* heap_guard;
+  string* output;
+
+  // Whether every test reported so far has succeeded.
+  bool success = true;
+
+  // The names of the tests in the order they were reported, along with maps
+  // from test name to failure message (if the test failed) and duration in
+  // seconds.
+  std::vector<string> tests_run;
+  std::unordered_map<std::string, string> test_failure_messages;
+  std::unordered_map<std::string, double> test_durations;
+
+  // A map from test name to counters, if requested.
+  std::unordered_map<std::string, Counters>* test_counters = NULL;
+};
+
+// A test, or a suite-level hook, that has been started but not yet reported.
+struct RunningTest {
+  string name;
+
+  // The test case, which is destroyed once it has been reported.
+  std::unique_ptr<TestCase> test_case;
+
+  // The real time, in milliseconds on a monotonic clock, by which the test
+  // must finish.
+  double deadline;
+};
+
+// Return the current time in milliseconds on a monotonic clock. Unlike the
+// clocks that tests see, this one isn't virtual.
+static double GetMonotonicTimeMs() {
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Start running a test or suite-level hook, along with the microtasks it
+// queues.
+static RunningTest StartTestCase(
+    TestRun* run,
     const string& name,
-    const Local<Function>& test_function,
-    bool* success,
-    string* output,
-    std::unordered_map<std::string, string>* test_failure_messages,
-    std::unordered_map<std::string, double>* test_durations) {
-  // Run the test.
-  TestCase test_case(isolate, test_function);
-  test_case.Run();
+    const Local<Function>& test_function) {
+  // Keep track of the array buffer memory the test uses.
+  run->allocator->ResetPeak();
+
+  RunningTest result;
+  result.name = name;
+  result.test_case.reset(new TestCase(run->isolate, test_function));
+
+  result.test_case->Start();
+
+  // Promises need filing under tests only once a test waits on one. Until its
+  // microtasks run, an asynchronous test's promise can't have settled.
+  if (!result.test_case->Poll()) {
+    run->event_loop->TrackPromises(result.test_case->test_environment());
+  }
+
+  run->event_loop->RunMicrotasks();
+
+  result.deadline = GetMonotonicTimeMs() + FLAGS_async_test_timeout_ms;
+
+  return result;
+}
+
+// Stop waiting for a test that hasn't finished, failing it with the supplied
+// message and cancelling its timers and workers.
+static void AbandonTestCase(
+    TestRun* run,
+    const RunningTest& test,
+    const string& message) {
+  test.test_case->Abandon(message);
+  run->event_loop->DiscardTest(test.test_case->test_environment());
+  run->workers->DiscardTest(test.test_case->test_environment());
+}
+
+// If code was stopped for using too much memory, fail the tests that might
+// have been running it -- those in the supplied list that haven't finished,
+// plus the one just started, if any -- and make sure the next test can run.
+static void RecoverHeap(
+    TestRun* run,
+    const std::deque<RunningTest>& running,
+    const TestCase* just_started) {
+  if (!run->heap_guard->Recover()) return;
+
+  const string message = DescribeHeapExhaustion(*run->heap_guard);
+  for (const RunningTest& test : running) {
+    if (!test.test_case->Poll()) {
+      AbandonTestCase(run, test, message);
+    } else if (test.test_case.get() == just_started) {
+      test.test_case->Fail(message);
+    }
+  }
+}
+
+// Report a test or suite-level hook that has finished, returning true if it
+// succeeded.
+static bool ReportTestCase(TestRun* run, const RunningTest& test) {
+  const string& name = test.name;
+  TestCase* const test_case = test.test_case.get();
+
+  const size_t array_buffer_peak_bytes = run->allocator->peak_bytes();
+
+  // Don't let the test's leftover timers and workers run during later tests,
+  // and ignore anything else it reports from now on.
+  run->event_loop->DiscardTest(test_case->test_environment());
+  run->workers->DiscardTest(test_case->test_environment());
+  test_case->Close();
+
+  SettleIsolate(run->isolate);
+
+  // Fail the test if it went over the array buffer budget.
+  if (FLAGS_array_buffer_budget_bytes > 0 &&
+      array_buffer_peak_bytes >
+          static_cast<uint64>(FLAGS_array_buffer_budget_bytes)) {
+    test_case->Fail(
+        StringPrintf(
+            "Array buffers totalling %zu bytes were live at once, exceeding "
+            "the budget of %lld bytes.\n\n",
+            array_buffer_peak_bytes,
+            static_cast<long long>(FLAGS_array_buffer_budget_bytes)));
+  }
+
+  // Collect the counters for the test, if requested.
+  if (run->test_counters) {
+    Counters* const counters = &(*run->test_counters)[name];
+    TakeCounters(run->isolate, run->take_stats, counters);
+
+    (*counters)["arrayBufferPeakBytes"] = array_buffer_peak_bytes;
+    (*counters)["arrayBufferLiveBytes"] = run->allocator->live_bytes();
+  }
 
   // Append the appropriate stuff to our output.
-  StringAppendF(output, "[ RUN      ] %s\n", name.c_str());
+  run->tests_run.push_back(name);
+  StringAppendF(run->output, "[ RUN      ] %s\n", name.c_str());
 
   string status_message = "[       OK ]";
-  if (!test_case.succeeded) {
-    *success = false;
+  if (!test_case->succeeded) {
+    run->success = false;
     status_message = "[  FAILED  ]";
 
     // Record the failure output for use in the XML later. Strip any
     // surrounding whitespace first.
-    StripWhitespace(&test_case.failure_output);
-    InsertOrDie(test_failure_messages, name, test_case.failure_output);
+    StripWhitespace(&test_case->failure_output);
+    InsertOrDie(
+        &run->test_failure_messages,
+        name,
+        test_case->failure_output);
   }
 
   // Append the test output and the status message.
   StringAppendF(
-      output,
+      run->output,
       "%s%s %s (%u ms)\n",
-      test_case.output.c_str(),
+      test_case->output.c_str(),
       status_message.c_str(),
       name.c_str(),
-      test_case.duration_ms);
+      test_case->duration_ms);
 
   // Record test duration.
-  InsertOrDie(test_durations, name, test_case.duration_ms / 1000.0);
+  InsertOrDie(&run->test_durations, name, test_case->duration_ms / 1000.0);
+
+  return test_case->succeeded;
 }
 
-// Iterate over a map from test names to test functions, running each test
-// function.
-static void ProcessTestSuite(
+// Run the supplied tests, reporting each in the order in which they were
+// started, and return true if they all succeeded.
+//
+// Tests that return promises finish once their promises settle. While the
+// tests that are running wait for timers, the next test is started, so long
+// as no more than max_running are unfinished at once. Timers run as soon as
+// nothing else can, their tests' virtual clocks skipping ahead to the times
+// at which they're due. A test is failed if its promise doesn't settle within
+// --async_test_timeout_ms of real time, or if there's nothing left for it to
+// wait for.
+static bool RunTestCases(
+    TestRun* run,
+    const std::vector<string>& names,
+    const std::vector<Local<Function>>& test_functions,
+    const size_t max_running) {
+  CHECK_EQ(names.size(), test_functions.size());
+  CHECK_GT(max_running, 0);
+
+  bool succeeded = true;
+  std::deque<RunningTest> running;
+  size_t next = 0;
+
+  while (next < names.size() || !running.empty()) {
+    // Don't let handles created along the way keep finished tests' objects
+    // alive for the rest of the run.
+    const HandleScope handle_scope(run->isolate);
+
+    // Report the oldest test if it has finished.
+    if (!running.empty() && running.front().test_case->Poll()) {
+      succeeded &= ReportTestCase(run, running.front());
+      running.pop_front();
+      continue;
+    }
+
+    // Find the tests that haven't finished, and the earliest of their
+    // deadlines.
+    size_t unfinished = 0;
+    double deadline = std::numeric_limits<double>::infinity();
+    for (const RunningTest& test : running) {
+      if (test.test_case->Poll()) continue;
+
+      ++unfinished;
+      deadline = std::min(deadline, test.deadline);
+    }
+
+    // Start the next test if there's room for it.
+    if (next < names.size() && unfinished < max_running) {
+      running.push_back(StartTestCase(run, names[next], test_functions[next]));
+      ++next;
+
+      RecoverHeap(run, running, running.back().test_case.get());
+      continue;
+    }
+
+    // Otherwise let the running tests make progress, failing those that have
+    // run out of time. If nothing can happen at all, the unfinished tests are
+    // stuck.
+    const bool ran = run->event_loop->RunNextTask(deadline);
+    if (ran) RecoverHeap(run, running, NULL);
+
+    const bool stuck = !ran && !run->event_loop->HasPendingWork();
+
+    const double now = GetMonotonicTimeMs();
+    for (const RunningTest& test : running) {
+      if (test.test_case->Poll()) continue;
+
+      if (stuck) {
+        AbandonTestCase(
+            run,
+            test,
+            "The promise returned by the test never settled, and there are "
+            "no timers or workers left to settle it.\n\n");
+      } else if (test.deadline <= now) {
+        AbandonTestCase(
+            run,
+            test,
+            StringPrintf(
+                "The promise returned by the test didn't settle within %d ms. "
+                "See --async_test_timeout_ms.\n\n",
+                FLAGS_async_test_timeout_ms));
+      }
+    }
+  }
+
+  return succeeded;
+}
+
+// Return the value of the supplied property of a
+// gjstest.internal.TestSuiteInfo.
+static Local<Value> GetSuiteProperty(
     v8::Isolate* const isolate,
-    const RE2& test_filter,
-    const Local<Object>& test_functions,
-    bool* success,
-    string* output,
-    std::vector<string>* tests_run,
-    std::unordered_map<std::string, string>* test_failure_messages,
-    std::unordered_map<std::string, double>* test_durations) {
-  StringAppendF(output, "[----------]\n");
+    const Local<Object>& test_suite,
+    const char* name) {
+  const Local<Context> context = isolate->GetCurrentContext();
+  return test_suite->Get(context, v8::String::NewFromUtf8(isolate, name))
+      .ToLocalChecked();
+}
 
-  const Local<Array> test_names = test_functions->GetPropertyNames();
+// Run the suite-level hook of the supplied name (e.g. "setUpSuite") of a
+// gjstest.internal.TestSuiteInfo, reporting it as a test named after the suite
+// and the hook. Return true if the suite has no such hook or it succeeded.
+static bool ProcessSuiteHook(
+    TestRun* run,
+    const Local<Object>& test_suite,
+    const char* hook_name) {
+  v8::Isolate* const isolate = run->isolate;
+  const Local<Value> hook = GetSuiteProperty(isolate, test_suite, hook_name);
+  if (!hook->IsFunction()) return true;
+
+  const string name =
+      ConvertToString(isolate, GetSuiteProperty(isolate, test_suite, "name")) +
+      "." + hook_name;
+
+  // Hooks run on their own, since the tests depend on what they do.
+  return RunTestCases(
+      run,
+      std::vector<string>(1, name),
+      std::vector<Local<Function>>(1, Local<Function>::Cast(hook)),
+      1);
+}
+
+// Run each test of a gjstest.internal.TestSuiteInfo returned by
+// gjstest.internal.listTestSuites that matches the filter, surrounded by the
+// suite's setUpSuite and tearDownSuite hooks if it has any. The hooks are
+// reported like tests, but only run if at least one test matches.
+static void ProcessTestSuite(
+    TestRun* run,
+    const RE2& test_filter,
+    const Local<Object>& test_suite) {
+  v8::Isolate* const isolate = run->isolate;
+  StringAppendF(run->output, "[----------]\n");
+
+  const Local<Context> context = isolate->GetCurrentContext();
+  const Local<Value> test_names_value =
+      GetSuiteProperty(isolate, test_suite, "testNames");
+  const Local<Value> test_functions_value =
+      GetSuiteProperty(isolate, test_suite, "testFunctions");
+
+  CHECK(test_names_value->IsArray());
+  CHECK(test_functions_value->IsArray());
+  const Local<Array> test_names = Local<Array>::Cast(test_names_value);
+  const Local<Array> test_functions = Local<Array>::Cast(test_functions_value);
+  CHECK_EQ(test_names->Length(), test_functions->Length());
+
+  // Find the tests that match our filter.
+  std::vector<string> selected_names;
+  std::vector<Local<Function>> selected_functions;
   for (uint32 i = 0; i < test_names->Length(); ++i) {
-    const Local<Value> name = test_names->Get(i);
-    const Local<Value> test_function = test_functions->Get(name);
+    const Local<Value> name = test_names->Get(context, i).ToLocalChecked();
+    const Local<Value> test_function =
+        test_functions->Get(context, i).ToLocalChecked();
     CHECK(test_function->IsFunction());
 
-    // Skip this test if it doesn't match our filter.
     const string string_name = ConvertToString(isolate, name);
     if (!RE2::FullMatch(string_name, test_filter)) continue;
 
-    tests_run->push_back(string_name);
-    ProcessTestCase(
-        isolate,
-        string_name,
-        Local<Function>::Cast(test_function),
-        success,
-        output,
-        test_failure_messages,
-        test_durations);
+    selected_names.push_back(string_name);
+    selected_functions.push_back(Local<Function>::Cast(test_function));
   }
 
-  StringAppendF(output, "[----------]\n\n");
+  // Interleave tests that return promises, unless they need to be measured
+  // one at a time.
+  size_t max_running = std::max(FLAGS_async_test_concurrency, 1);
+  if (run->test_counters || FLAGS_array_buffer_budget_bytes > 0) {
+    max_running = 1;
+  }
+
+  // Don't set up suites none of whose tests will run.
+  if (!selected_names.empty()) {
+    // Skip the tests if their shared fixtures couldn't be set up, but still
+    // give the suite a chance to clean up after itself.
+    if (ProcessSuiteHook(run, test_suite, "setUpSuite")) {
+      RunTestCases(run, selected_names, selected_functions, max_running);
+    }
+
+    ProcessSuiteHook(run, test_suite, "tearDownSuite");
+  }
+
+  StringAppendF(run->output, "[----------]\n\n");
+}
+
+// Describe the error that stopped a script or module from loading.
+static void ReportLoadError(
+    v8::Isolate* const isolate,
+    const TryCatch& try_catch,
+    HeapGuard* const heap_guard,
+    string* const output) {
+  *output += DescribeError(isolate, try_catch) + "\n";
+  if (heap_guard->Recover()) {
+    *output += DescribeHeapExhaustion(*heap_guard);
+  }
 }
 
 bool RunTests(
@@ -212,13 +636,29 @@ bool RunTests(
     const string& test_filter_string,
     string* output,
     string* xml,
-    string* coverage_info) {
+    string* coverage_info,
+    string* stats) {
   const RE2 test_filter(test_filter_string.empty() ? ".*" : test_filter_string);
 
   // Set up an isolate to host all of the test execution.
-  const IsolateHandle isolate = CreateIsolate();
+  const std::shared_ptr<ArrayBufferAllocator> allocator(
+      new ArrayBufferAllocator);
+  v8::ResourceConstraints constraints;
+  if (FLAGS_max_old_space_mb > 0) {
+    constraints.set_max_old_space_size(FLAGS_max_old_space_mb);
+  }
+
+  if (FLAGS_max_semi_space_kb > 0) {
+    constraints.set_max_semi_space_size_in_kb(FLAGS_max_semi_space_kb);
+  }
+
+  const IsolateHandle isolate = CreateIsolate(allocator, constraints);
   const v8::Isolate::Scope isolate_scope(isolate.get());
 
+  // Stop tests that run out of memory rather than crashing, so that the
+  // remaining tests can still run.
+  HeapGuard heap_guard(isolate.get());
+
   // Take ownership of all handles created.
   HandleScope handle_owner(isolate.get());
 
@@ -227,82 +667,165 @@ bool RunTests(
   const Local<Context> context(Context::New(isolate.get()));
   const Context::Scope context_scope(context);
 
-  // Run all of the scripts.
-  for (uint32 i = 0; i < scripts.script_size(); ++i) {
-    const NamedScript& script = scripts.script(i);
+  // Install the functions the built-in scripts look for, before any of them
+  // run.
+  Natives natives(isolate.get(), context, FLAGS_test_data_dir);
+
+  // Likewise setTimeout and clearTimeout, whose timers asynchronous tests wait
+  // on. From here on microtasks run only when the event loop runs them.
+  EventLoop event_loop(isolate.get(), context);
+
+  // And the Worker constructor, whose workers share the allocator so that
+  // array buffers can move between them.
+  Workers workers(
+      isolate.get(), context, &event_loop, allocator, constraints);
+
+  // Counters for the run as a whole, including the work done by the scripts
+  // when they are first run.
+  Counters run_counters;
+
+  // Set aside the ES modules, which are loaded once the classic scripts have
+  // run.
+  NamedScripts classic_scripts;
+  std::vector<string> module_paths;
+  for (const NamedScript& script : scripts.script()) {
+    if (!script.module()) {
+      *classic_scripts.add_script() = script;
+      continue;
+    }
+
+    CHECK(script.has_path()) << "Modules must be given by path.";
+    module_paths.push_back(script.path());
+  }
+
+  // Run all of the scripts, compiling later ones in the background while
+  // earlier ones run.
+  ScriptPipeline pipeline(
+      isolate.get(),
+      classic_scripts,
+      FLAGS_compile_lookahead);
+
+  while (!pipeline.Done()) {
+    TryCatch try_catch(isolate.get());
+
+    CycleTimer compile_timer;
+    compile_timer.Start();
+
+    size_t source_bytes = 0;
+    Local<UnboundScript> compiled_script;
+    const bool compiled =
+        pipeline.CompileNext(&source_bytes).ToLocal(&compiled_script);
+
+    compile_timer.Stop();
+
+    run_counters["scriptsCompiled"] += 1;
+    run_counters["scriptBytesCompiled"] += source_bytes;
+    run_counters["compileTimeMs"] += compile_timer.GetInUsec() / 1000.0;
+
+    if (!compiled ||
+        RunCompiledJs(isolate.get(), context, compiled_script).IsEmpty()) {
+      ReportLoadError(isolate.get(), try_catch, &heap_guard, output);
+      return false;
+    }
+
+    event_loop.RunMicrotasks();
+  }
+
+  // Then compile the modules and everything they import, and evaluate them in
+  // order.
+  if (!module_paths.empty()) {
+    ModuleLoader module_loader(
+        isolate.get(),
+        scripts.module_root(),
+        FLAGS_compile_lookahead);
 
     TryCatch try_catch(isolate.get());
-    const MaybeLocal<Value> result =
-        ExecuteJs(isolate.get(), context, script.source(), script.name());
 
-    if (result.IsEmpty()) {
-      *output += DescribeError(isolate.get(), try_catch) + "\n";
+    CycleTimer compile_timer;
+    compile_timer.Start();
+    bool loaded = module_loader.Compile(module_paths);
+    compile_timer.Stop();
+
+    run_counters["scriptsCompiled"] += module_loader.modules_compiled();
+    run_counters["scriptBytesCompiled"] +=
+        module_loader.source_bytes_compiled();
+    run_counters["compileTimeMs"] += compile_timer.GetInUsec() / 1000.0;
+
+    for (uint32 i = 0; loaded && i < module_paths.size(); ++i) {
+      loaded = !module_loader.Evaluate(context, module_paths[i]).IsEmpty();
+      event_loop.RunMicrotasks();
+    }
+
+    if (!loaded) {
+      ReportLoadError(isolate.get(), try_catch, &heap_guard, output);
       return false;
     }
   }
 
-  // Get a reference to gjstest.internal.getTestFunctions for later.
-  const Local<Function> get_test_functions =
+  SettleIsolate(isolate.get());
+
+  // Get references to gjstest.internal.listTestSuites and
+  // gjstest.internal.takeStats for later.
+  const Local<Function> list_test_suites =
       GetFunctionNamed(
           isolate.get(),
-          "gjstest.internal.getTestFunctions");
+          "gjstest.internal.listTestSuites");
 
-  // Keep maps from test name to failure message (if the test failed) and
-  // duration in seconds.
-  std::unordered_map<std::string, string> test_failure_messages;
-  std::unordered_map<std::string, double> test_durations;
-  std::vector<string> tests_run;
+  const Local<Function> take_stats =
+      GetFunctionNamed(
+          isolate.get(),
+          "gjstest.internal.takeStats");
+
+  // Attribute the work done while loading the scripts to the run as a whole.
+  if (stats) {
+    TakeCounters(isolate.get(), take_stats, &run_counters);
+    run_counters["arrayBufferPeakBytes"] = allocator->peak_bytes();
+  }
+
+  // Keep track of the tests' results, and their counters if requested.
+  std::unordered_map<std::string, Counters> test_counters;
 
-  // Keep track of how long the whole process takes, and whether there are any
-  // failures.
+  TestRun run;
+  run.isolate = isolate.get();
+  run.event_loop = &event_loop;
+  run.workers = &workers;
+  run.take_stats = take_stats;
+  run.allocator = allocator.get();
+  run.heap_guard = &heap_guard;
+  run.output = output;
+  run.test_counters = stats ? &test_counters : NULL;
+
+  // Keep track of how long the whole process takes.
   CycleTimer overall_timer;
   overall_timer.Start();
-  bool success = true;
 
-  // Iterate over all of the registered test suites.
+  // Iterate over all of the registered test suites, whose tests are all
+  // enumerated by a single call.
   const Local<Value> test_suites_value =
-      ExecuteJs(isolate.get(), context, "gjstest.internal.testSuites", "")
+      list_test_suites->Call(context, context->Global(), 0, NULL)
           .ToLocalChecked();
 
   CHECK(test_suites_value->IsArray());
   const Local<Array> test_suites = Local<Array>::Cast(test_suites_value);
 
   for (uint32 i = 0; i < test_suites->Length(); ++i) {
-    const Local<Value> test_suite = test_suites->Get(i);
+    const Local<Value> test_suite =
+        test_suites->Get(context, i).ToLocalChecked();
     CHECK(test_suite->IsObject());
 
-    // Get the map of test functions registered for this test suite.
-    Local<Value> args[] = { test_suite };
-    const Local<Value> test_functions_value =
-        get_test_functions->Call(
-            context->Global(),
-            arraysize(args),
-            args);
-    CHECK(test_functions_value->IsObject());
-    const Local<Object> test_functions =
-        Local<Object>::Cast(test_functions_value);
-
     // Process this test suite.
-    ProcessTestSuite(
-        isolate.get(),
-        test_filter,
-        test_functions,
-        &success,
-        output,
-        &tests_run,
-        &test_failure_messages,
-        &test_durations);
+    ProcessTestSuite(&run, test_filter, Local<Object>::Cast(test_suite));
   }
 
   overall_timer.Stop();
 
   StringAppendF(
       output,
-      success ? "[  PASSED  ]\n" : "[  FAILED  ]\n");
+      run.success ? "[  PASSED  ]\n" : "[  FAILED  ]\n");
 
   // Make sure that at least one test ran. This catches common errors with
   // mis-registering tests and so on.
-  if (test_durations.empty()) {
+  if (run.test_durations.empty()) {
     *output = "No tests found.\n";
     return false;
   }
@@ -311,9 +834,9 @@ bool RunTests(
   *xml =
       MakeXml(
           overall_timer.GetInMs(),
-          tests_run,
-          test_durations,
-          test_failure_messages);
+          run.tests_run,
+          run.test_durations,
+          run.test_failure_messages);
 
   // Extract coverage info if requested.
   if (coverage_info) {
@@ -326,7 +849,29 @@ bool RunTests(
     *coverage_info += ConvertToString(isolate.get(), coverage_result);
   }
 
-  return success;
+  // Create a stats report if requested, rolling the per-test counters up into
+  // the ones for the whole run.
+  if (stats) {
+    // The array buffer byte counts are levels rather than totals, so the run
+    // gets the highest peak and the final level rather than their sums.
+    double array_buffer_peak_bytes = run_counters["arrayBufferPeakBytes"];
+    for (const auto& test_entry : test_counters) {
+      array_buffer_peak_bytes = std::max(
+          array_buffer_peak_bytes,
+          FindOrDie(test_entry.second, "arrayBufferPeakBytes"));
+
+      for (const auto& counter : test_entry.second) {
+        run_counters[counter.first] += counter.second;
+      }
+    }
+
+    run_counters["arrayBufferPeakBytes"] = array_buffer_peak_bytes;
+    run_counters["arrayBufferLiveBytes"] = allocator->live_bytes();
+
+    *stats = MakeStatsXml(run_counters, run.tests_run, test_counters);
+  }
+
+  return run.success;
 }
 
 }  // namespace gjstest
@@ -36,6 +36,10 @@ class NamedScripts;
 // coverage information generated by the code will be extracted after the tests
 // are run and returned LCOV format in *coverage_info.
 //
+// If stats is non-NULL, an XML report of framework-level counters (scripts
+// compiled, expectations evaluated, mock function calls, and so on) for each
+// test and for the run as a whole is written to *stats.
+//
 // This function is not safe to be called multiple times concurrently. It
 // assumes that v8 has already been successfully initialized.
 bool RunTests(
@@ -43,7 +47,8 @@ bool RunTests(
     const string& test_filter,
     string* output,
     string* xml,
-    string* coverage_info);
+    string* coverage_info,
+    string* stats);
 
 }  // namespace gjstest
 
@@ -0,0 +1,261 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/script_pipeline.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include <v8.h>
+
+#include "base/integral_types.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "file/file_utils.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+#include "gjstest/internal/proto/named_scripts.pb.h"
+
+using v8::Context;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::Script;
+using v8::ScriptCompiler;
+using v8::ScriptOrigin;
+using v8::String;
+using v8::UnboundScript;
+using v8::Value;
+
+namespace gjstest {
+
+// The size of the pieces in which source is handed to v8. v8 takes ownership
+// of each piece, so they must be copied out of the mapping.
+static const size_t kChunkSize = 64 << 10;
+
+// Hands the source of a single script to v8 on a background thread. The file,
+// if any, is mapped on the first request for data. If it can't be read or isn't
+// well-formed UTF-8 the stream is left empty, and the script is compiled in the
+// foreground instead so that any failure happens exactly as it would have
+// without the pipeline.
+class ScriptPipeline::ScriptStream
+    : public ScriptCompiler::ExternalSourceStream {
+ public:
+  explicit ScriptStream(const NamedScript& script) : script_(script) {}
+
+  size_t GetMoreData(const uint8_t** src) override {
+    if (!opened_) {
+      Open();
+      opened_ = true;
+    }
+
+    if (!usable_ || offset_ == size_) return 0;
+
+    const size_t length = std::min(kChunkSize, size_ - offset_);
+    uint8_t* const chunk = new uint8_t[length];
+    memcpy(chunk, data_ + offset_, length);
+    offset_ += length;
+
+    *src = chunk;
+    return length;
+  }
+
+  // The following may be used only once streaming has finished.
+  bool usable() const { return usable_; }
+  const std::shared_ptr<const MappedFile>& file() const { return file_; }
+
+ private:
+  void Open() {
+    if (script_.has_path()) {
+      // On failure leave the stream unusable, so that compiling in the
+      // foreground reports the error.
+      string error;
+      file_.reset(MappedFile::Open(script_.path(), false, &error));
+      if (!file_) return;
+
+      data_ = file_->data();
+      size_ = file_->size();
+    } else {
+      data_ = script_.source().data();
+      size_ = script_.source().size();
+    }
+
+    // Only for well-formed UTF-8 are v8's decoding while streaming and
+    // MakeExternalString guaranteed to agree on the source.
+    usable_ = IsValidUtf8(data_, size_);
+  }
+
+  const NamedScript& script_;
+  std::shared_ptr<const MappedFile> file_;
+
+  const char* data_ = NULL;
+  size_t size_ = 0;
+  size_t offset_ = 0;
+
+  bool opened_ = false;
+  bool usable_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptStream);
+};
+
+// The background work for a single script. Members are destroyed in reverse
+// order, so the thread must be joined before the task and source go away.
+struct ScriptPipeline::Job {
+  // Owned by source.
+  ScriptStream* stream = NULL;
+
+  std::unique_ptr<ScriptCompiler::StreamedSource> source;
+  std::unique_ptr<ScriptCompiler::ScriptStreamingTask> task;
+  std::thread thread;
+};
+
+ScriptPipeline::ScriptPipeline(
+    Isolate* const isolate,
+    const NamedScripts& scripts,
+    const uint32 lookahead)
+    : isolate_(isolate),
+      scripts_(scripts),
+      lookahead_(lookahead) {
+  while (next_to_start_ < scripts_.script_size() &&
+         jobs_.size() < lookahead_) {
+    StartNext();
+  }
+}
+
+ScriptPipeline::~ScriptPipeline() {
+  for (const auto& job : jobs_) {
+    if (job->thread.joinable()) job->thread.join();
+  }
+}
+
+bool ScriptPipeline::Done() const {
+  return next_to_compile_ == scripts_.script_size();
+}
+
+void ScriptPipeline::StartNext() {
+  std::unique_ptr<Job> job(new Job);
+
+  job->stream = new ScriptStream(scripts_.script(next_to_start_++));
+  job->source.reset(
+      new ScriptCompiler::StreamedSource(
+          job->stream,
+          ScriptCompiler::StreamedSource::UTF8));
+
+  // v8 may decline to stream the script, in which case it is compiled in the
+  // foreground.
+  job->task.reset(
+      ScriptCompiler::StartStreamingScript(isolate_, job->source.get()));
+
+  if (job->task) {
+    ScriptCompiler::ScriptStreamingTask* const task = job->task.get();
+    job->thread = std::thread([task]() { task->Run(); });
+  }
+
+  jobs_.push_back(std::move(job));
+}
+
+MaybeLocal<UnboundScript> ScriptPipeline::CompileNext(size_t* source_bytes) {
+  CHECK(!Done());
+  const int index = next_to_compile_++;
+
+  if (jobs_.empty()) {
+    return CompileInForeground(index, source_bytes);
+  }
+
+  // Take this script's job, and keep the pipeline full while we wait for it.
+  const std::unique_ptr<Job> job = std::move(jobs_.front());
+  jobs_.pop_front();
+
+  if (next_to_start_ < scripts_.script_size()) {
+    StartNext();
+  }
+
+  if (job->thread.joinable()) job->thread.join();
+  if (!job->task || !job->stream->usable()) {
+    return CompileInForeground(index, source_bytes);
+  }
+
+  // v8 doesn't keep the source it was streamed, so give it the same string we
+  // would otherwise have compiled.
+  const NamedScript& script = scripts_.script(index);
+  Local<String> source;
+
+  if (job->stream->file()) {
+    source = MakeExternalString(isolate_, job->stream->file());
+    *source_bytes = job->stream->file()->size();
+  } else {
+    source = String::NewFromUtf8(
+        isolate_,
+        script.source().data(),
+        String::kNormalString,
+        script.source().size());
+
+    *source_bytes = script.source().size();
+  }
+
+  // Match the origin given by CompileJs, which leaves it out for unnamed
+  // scripts.
+  const Local<Value> resource_name =
+      script.name().empty()
+          ? Local<Value>(v8::Undefined(isolate_))
+          : Local<Value>(
+                String::NewFromUtf8(
+                    isolate_,
+                    script.name().data(),
+                    String::kNormalString,
+                    script.name().size()));
+
+  Local<Script> compiled;
+  if (!ScriptCompiler::Compile(
+           isolate_->GetCurrentContext(),
+           job->source.get(),
+           source,
+           ScriptOrigin(resource_name)).ToLocal(&compiled)) {
+    return MaybeLocal<UnboundScript>();
+  }
+
+  return compiled->GetUnboundScript();
+}
+
+MaybeLocal<UnboundScript> ScriptPipeline::CompileInForeground(
+    const int index,
+    size_t* source_bytes) {
+  const NamedScript& script = scripts_.script(index);
+
+  // Scripts given by path are mapped rather than read, and handed to v8
+  // without copying where possible.
+  Local<String> source;
+
+  if (script.has_path()) {
+    const std::shared_ptr<const MappedFile> file(
+        new MappedFile(script.path()));
+
+    source = MakeExternalString(isolate_, file);
+    *source_bytes = file->size();
+  } else {
+    source = String::NewFromUtf8(
+        isolate_,
+        script.source().data(),
+        String::kNormalString,
+        script.source().size());
+
+    *source_bytes = script.source().size();
+  }
+
+  return CompileJs(isolate_, source, script.name());
+}
+
+}  // namespace gjstest
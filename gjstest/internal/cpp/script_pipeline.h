@@ -0,0 +1,87 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A class that compiles a sequence of scripts ahead of their execution. The
+// files for the next few scripts are read and parsed on background threads
+// using v8's script streaming support, so that most of that work overlaps with
+// running the scripts before them.
+
+#ifndef GJSTEST_INTERNAL_CPP_SCRIPT_PIPELINE_H_
+#define GJSTEST_INTERNAL_CPP_SCRIPT_PIPELINE_H_
+
+#include <deque>
+#include <memory>
+
+#include <v8.h>
+
+#include "base/integral_types.h"
+#include "base/macros.h"
+
+namespace gjstest {
+
+class NamedScripts;
+
+class ScriptPipeline {
+ public:
+  // Prepare to compile the supplied scripts, which must outlive this object,
+  // in order. At most lookahead scripts are read and parsed in the background
+  // at any one time; with a lookahead of zero, each script is read and
+  // compiled on the calling thread when it is asked for.
+  ScriptPipeline(
+      v8::Isolate* isolate,
+      const NamedScripts& scripts,
+      uint32 lookahead);
+
+  // Wait for any outstanding background work. The isolate must still exist.
+  ~ScriptPipeline();
+
+  // Are there any scripts left to compile?
+  bool Done() const;
+
+  // Finish compiling the next script in the sequence, setting *source_bytes to
+  // the size of its source. Returns an empty handle in the event of an error,
+  // which can be recovered by creating a TryCatch object on the stack first,
+  // exactly as with CompileJs.
+  v8::MaybeLocal<v8::UnboundScript> CompileNext(size_t* source_bytes);
+
+ private:
+  class ScriptStream;
+  struct Job;
+
+  // Start background work for the next script not yet started, if any.
+  void StartNext();
+
+  // Read and compile the supplied script on the calling thread.
+  v8::MaybeLocal<v8::UnboundScript> CompileInForeground(
+      int index,
+      size_t* source_bytes);
+
+  v8::Isolate* const isolate_;
+  const NamedScripts& scripts_;
+  const uint32 lookahead_;
+
+  // The index of the next script to be compiled, and of the next script for
+  // which background work should be started.
+  int next_to_compile_ = 0;
+  int next_to_start_ = 0;
+
+  // Background work started but not yet consumed, in script order.
+  std::deque<std::unique_ptr<Job>> jobs_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptPipeline);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_SCRIPT_PIPELINE_H_
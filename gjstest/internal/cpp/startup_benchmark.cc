@@ -0,0 +1,419 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A benchmark for the fixed cost of starting up the test runner, broken into
+// phases. It generates synthetic targets of a few sizes, and for each one
+// measures:
+//
+//  *  A cold start, in a fresh process that has never initialized v8.
+//  *  Warm starts, repeated within this process once v8 is initialized.
+//
+// The results are written as JSON. Run it with --data_dir pointing at the
+// built-in scripts, as for gjstest itself.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+#include <v8.h>
+
+#include "base/integral_types.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/stl_decl.h"
+#include "base/stringprintf.h"
+#include "base/timer.h"
+#include "file/file_utils.h"
+#include "gjstest/internal/cpp/builtin_data.h"
+#include "gjstest/internal/cpp/event_loop.h"
+#include "gjstest/internal/cpp/heap_guard.h"
+#include "gjstest/internal/cpp/natives.h"
+#include "gjstest/internal/cpp/script_pipeline.h"
+#include "gjstest/internal/cpp/typed_arrays.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+#include "gjstest/internal/cpp/workers.h"
+#include "gjstest/internal/proto/named_scripts.pb.h"
+#include "strings/strutil.h"
+
+DECLARE_string(data_dir);
+
+DEFINE_string(output_file, "",
+              "A file to write the JSON report to. If empty, the report is "
+              "written to stdout.");
+
+DEFINE_int32(warm_iterations, 10,
+             "The number of warm starts to measure for each target. The "
+             "report gives the median of each phase.");
+
+DEFINE_int32(compile_lookahead, 8,
+             "The number of scripts to compile in the background while "
+             "earlier ones run, as with gjstest's flag of the same name.");
+
+DEFINE_string(cold_start_js_files, "",
+              "Internal: measure a single start with these comma-separated "
+              "files as the user scripts, and print the phase durations.");
+
+namespace gjstest {
+
+// The durations in milliseconds of each phase of starting up.
+struct Phases {
+  double flags_ms = 0;
+  double init_ms = 0;
+  double create_isolate_ms = 0;
+  double builtins_ms = 0;
+  double user_scripts_ms = 0;
+  double teardown_ms = 0;
+
+  double total_ms() const {
+    return flags_ms + init_ms + create_isolate_ms + builtins_ms +
+        user_scripts_ms + teardown_ms;
+  }
+};
+
+// A synthetic target, made up of a number of files each registering a suite
+// of simple tests.
+struct SyntheticTarget {
+  const char* name;
+  uint32 files;
+  uint32 tests_per_file;
+};
+
+static const SyntheticTarget kTargets[] = {
+  { "single_test", 1, 1 },
+  { "small", 1, 50 },
+  { "medium", 20, 50 },
+  { "large", 200, 50 },
+};
+
+static double NowMs() {
+  return WallTimer::GetTimeInMicroSeconds() / 1000.0;
+}
+
+// Return the source of one file of a synthetic target.
+static string MakeSyntheticFile(uint32 index, uint32 tests) {
+  string js;
+  StringAppendF(&js, "function SyntheticTest%u() {\n", index);
+  StringAppendF(&js, "  this.values_ = [%u, 2, 3];\n", index);
+  StringAppendF(&js, "}\n\n");
+  StringAppendF(&js, "registerTestSuite(SyntheticTest%u);\n\n", index);
+
+  for (uint32 i = 0; i < tests; ++i) {
+    StringAppendF(
+        &js,
+        "SyntheticTest%u.prototype.Test%u = function() {\n"
+        "  var sum = this.values_.reduce(function(a, b) { return a + b; });\n"
+        "  expectEq(%u, sum);\n"
+        "  expectThat(this.values_, elementsAre([%u, 2, 3]));\n"
+        "};\n\n",
+        index, i, index + 5, index);
+  }
+
+  return js;
+}
+
+// Write the files for the supplied target to a new temporary directory,
+// returning their paths and setting *bytes to their total size.
+static std::vector<string> WriteSyntheticTarget(
+    const SyntheticTarget& target,
+    uint64* bytes) {
+  const char* const tmpdir = getenv("TMPDIR");
+  string dir_template =
+      StringPrintf("%s/startup_benchmark.XXXXXX", tmpdir ? tmpdir : "/tmp");
+  PCHECK(mkdtemp(&dir_template[0])) << ": creating " << dir_template;
+
+  std::vector<string> paths;
+  *bytes = 0;
+
+  for (uint32 i = 0; i < target.files; ++i) {
+    const string path = StringPrintf("%s/file_%u.js", dir_template.c_str(), i);
+    const string js = MakeSyntheticFile(i, target.tests_per_file);
+
+    WriteStringToFileOrDie(js, path);
+    paths.push_back(path);
+    *bytes += js.size();
+  }
+
+  return paths;
+}
+
+static void DeleteSyntheticTarget(const std::vector<string>& paths) {
+  for (const string& path : paths) {
+    PCHECK(unlink(path.c_str()) == 0) << ": deleting " << path;
+  }
+
+  if (!paths.empty()) {
+    const string dir = paths[0].substr(0, paths[0].rfind('/'));
+    PCHECK(rmdir(dir.c_str()) == 0) << ": deleting " << dir;
+  }
+}
+
+// Compile and run the supplied scripts in the current context, crashing on
+// error. As in RunTests, microtasks are run after each script.
+static void RunScripts(
+    v8::Isolate* isolate,
+    EventLoop* event_loop,
+    const NamedScripts& scripts) {
+  ScriptPipeline pipeline(isolate, scripts, FLAGS_compile_lookahead);
+  const v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  while (!pipeline.Done()) {
+    v8::TryCatch try_catch(isolate);
+
+    size_t source_bytes;
+    v8::Local<v8::UnboundScript> script;
+    CHECK(pipeline.CompileNext(&source_bytes).ToLocal(&script) &&
+          !RunCompiledJs(isolate, context, script).IsEmpty())
+        << DescribeError(isolate, try_catch);
+
+    event_loop->RunMicrotasks();
+  }
+}
+
+// Load the built-in scripts and then the supplied user scripts into a new
+// context in the isolate, recording the time taken by each. The environment
+// is set up just as RunTests sets it up, so that its cost is counted too.
+static void LoadScripts(
+    v8::Isolate* isolate,
+    const std::shared_ptr<ArrayBufferAllocator>& allocator,
+    const v8::ResourceConstraints& constraints,
+    const std::vector<string>& user_paths,
+    Phases* phases) {
+  const v8::Isolate::Scope isolate_scope(isolate);
+
+  double start = NowMs();
+  HeapGuard heap_guard(isolate);
+  const v8::HandleScope handle_scope(isolate);
+  const v8::Local<v8::Context> context = v8::Context::New(isolate);
+  const v8::Context::Scope context_scope(context);
+  phases->create_isolate_ms += NowMs() - start;
+
+  start = NowMs();
+  // The benchmark has no test data directory.
+  Natives natives(isolate, context, "");
+  EventLoop event_loop(isolate, context);
+  Workers workers(isolate, context, &event_loop, allocator, constraints);
+  NamedScripts builtins;
+  string error;
+  CHECK(GetBuiltinScripts(&builtins, &error)) << error;
+  RunScripts(isolate, &event_loop, builtins);
+  phases->builtins_ms = NowMs() - start;
+
+  start = NowMs();
+  NamedScripts user_scripts;
+  for (const string& path : user_paths) {
+    NamedScript* const script = user_scripts.add_script();
+    script->set_name(Basename(path));
+    script->set_path(path);
+  }
+
+  RunScripts(isolate, &event_loop, user_scripts);
+  RunPendingTasks(isolate);
+  phases->user_scripts_ms = NowMs() - start;
+}
+
+// Measure every phase after flag parsing of a single start.
+static Phases MeasureStart(const std::vector<string>& user_paths) {
+  Phases phases;
+
+  double start = NowMs();
+  InitializeV8();
+  phases.init_ms = NowMs() - start;
+
+  // Use the default limits, as gjstest does without flags that set them.
+  start = NowMs();
+  const std::shared_ptr<ArrayBufferAllocator> allocator(
+      new ArrayBufferAllocator);
+  const v8::ResourceConstraints constraints;
+  IsolateHandle isolate = CreateIsolate(allocator, constraints);
+  phases.create_isolate_ms = NowMs() - start;
+
+  LoadScripts(isolate.get(), allocator, constraints, user_paths, &phases);
+
+  start = NowMs();
+  isolate.reset();
+  phases.teardown_ms = NowMs() - start;
+
+  return phases;
+}
+
+// Measure a cold start by running this binary again in cold start mode.
+static Phases MeasureColdStart(
+    const string& self_path,
+    const std::vector<string>& user_paths) {
+  const string command =
+      StringPrintf(
+          "%s --data_dir=\"%s\" --compile_lookahead=%d"
+              " --cold_start_js_files=\"%s\"",
+          self_path.c_str(),
+          FLAGS_data_dir.c_str(),
+          FLAGS_compile_lookahead,
+          JoinStrings(user_paths, ",").c_str());
+
+  FILE* const child_output = popen(command.c_str(), "r");
+  PCHECK(child_output) << ": running " << command;
+
+  Phases phases;
+  const int fields =
+      fscanf(
+          child_output,
+          "%lf %lf %lf %lf %lf %lf",
+          &phases.flags_ms,
+          &phases.init_ms,
+          &phases.create_isolate_ms,
+          &phases.builtins_ms,
+          &phases.user_scripts_ms,
+          &phases.teardown_ms);
+
+  CHECK_EQ(0, pclose(child_output)) << "Cold start failed: " << command;
+  CHECK_EQ(6, fields) << "Bad output from cold start: " << command;
+
+  return phases;
+}
+
+// Return the median of the supplied values, which must be non-empty.
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Measure warm starts, returning the median of each phase.
+static Phases MeasureWarmStarts(const std::vector<string>& user_paths) {
+  // Make sure v8 is initialized and the files are in the page cache.
+  MeasureStart(user_paths);
+
+  std::vector<double> flags, init, create_isolate, builtins, user_scripts,
+      teardown;
+
+  for (int32 i = 0; i < FLAGS_warm_iterations; ++i) {
+    const double start = NowMs();
+    google::ReparseCommandLineNonHelpFlags();
+    flags.push_back(NowMs() - start);
+
+    const Phases phases = MeasureStart(user_paths);
+    init.push_back(phases.init_ms);
+    create_isolate.push_back(phases.create_isolate_ms);
+    builtins.push_back(phases.builtins_ms);
+    user_scripts.push_back(phases.user_scripts_ms);
+    teardown.push_back(phases.teardown_ms);
+  }
+
+  Phases result;
+  result.flags_ms = Median(flags);
+  result.init_ms = Median(init);
+  result.create_isolate_ms = Median(create_isolate);
+  result.builtins_ms = Median(builtins);
+  result.user_scripts_ms = Median(user_scripts);
+  result.teardown_ms = Median(teardown);
+
+  return result;
+}
+
+static string PhasesToJson(const Phases& phases) {
+  return StringPrintf(
+      "{ \"flags_ms\": %.3f, \"init_ms\": %.3f, \"create_isolate_ms\": %.3f,"
+          " \"builtins_ms\": %.3f, \"user_scripts_ms\": %.3f,"
+          " \"teardown_ms\": %.3f, \"total_ms\": %.3f }",
+      phases.flags_ms,
+      phases.init_ms,
+      phases.create_isolate_ms,
+      phases.builtins_ms,
+      phases.user_scripts_ms,
+      phases.teardown_ms,
+      phases.total_ms());
+}
+
+static void RunBenchmarks(const string& self_path) {
+  CHECK_GT(FLAGS_warm_iterations, 0);
+
+  string json = "{\n";
+  StringAppendF(&json, "  \"warm_iterations\": %d,\n", FLAGS_warm_iterations);
+  StringAppendF(&json, "  \"targets\": [\n");
+
+  for (uint32 i = 0; i < arraysize(kTargets); ++i) {
+    const SyntheticTarget& target = kTargets[i];
+
+    uint64 bytes;
+    const std::vector<string> paths = WriteSyntheticTarget(target, &bytes);
+
+    const Phases cold = MeasureColdStart(self_path, paths);
+    const Phases warm = MeasureWarmStarts(paths);
+
+    DeleteSyntheticTarget(paths);
+
+    StringAppendF(
+        &json,
+        "    {\n"
+        "      \"name\": \"%s\",\n"
+        "      \"files\": %u,\n"
+        "      \"tests\": %u,\n"
+        "      \"bytes\": %llu,\n"
+        "      \"cold\": %s,\n"
+        "      \"warm\": %s\n"
+        "    }%s\n",
+        target.name,
+        target.files,
+        target.files * target.tests_per_file,
+        static_cast<unsigned long long>(bytes),
+        PhasesToJson(cold).c_str(),
+        PhasesToJson(warm).c_str(),
+        i + 1 < arraysize(kTargets) ? "," : "");
+  }
+
+  json += "  ]\n}\n";
+
+  if (FLAGS_output_file.empty()) {
+    std::cout << json;
+  } else {
+    WriteStringToFileOrDie(json, FLAGS_output_file);
+  }
+}
+
+}  // namespace gjstest
+
+int main(int argc, char** argv) {
+  const double start = gjstest::NowMs();
+  google::InitGoogleLogging(argv[0]);
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  const double flags_ms = gjstest::NowMs() - start;
+
+  // In cold start mode, measure a single start and report it to the parent.
+  if (!FLAGS_cold_start_js_files.empty()) {
+    std::vector<string> paths;
+    SplitStringUsing(FLAGS_cold_start_js_files, ",", &paths);
+
+    gjstest::Phases phases = gjstest::MeasureStart(paths);
+    phases.flags_ms = flags_ms;
+
+    printf(
+        "%f %f %f %f %f %f\n",
+        phases.flags_ms,
+        phases.init_ms,
+        phases.create_isolate_ms,
+        phases.builtins_ms,
+        phases.user_scripts_ms,
+        phases.teardown_ms);
+
+    return 0;
+  }
+
+  gjstest::RunBenchmarks(argv[0]);
+  return 0;
+}
@@ -0,0 +1,624 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/stringify.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include "base/integral_types.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+
+using v8::Array;
+using v8::Context;
+using v8::EscapableHandleScope;
+using v8::Function;
+using v8::HandleScope;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::NewStringType;
+using v8::Object;
+using v8::String;
+using v8::TryCatch;
+using v8::Value;
+
+namespace gjstest {
+
+// Built-ins captured when the stringifier is created. The first function
+// returns '' + v, and fills in the supplied array with whether v is extensible
+// and, if it might be a plain object, its keys. The keys of an object are
+// the same properties that a for-in loop filtered with hasOwnProperty sees,
+// in the same order.
+static const char kHelpersJs[] =
+    "(function() {"
+    "  var isExtensible = Object.isExtensible;"
+    "  var keys = Object.keys;"
+    "  function inspect(v, result) {"
+    "    var naive = '' + v;"
+    "    result[0] = isExtensible(v);"
+    "    result[1] = naive == '[object Object]' ? keys(v) : null;"
+    "    return naive;"
+    "  }"
+    "  return [inspect, isExtensible, Array];"
+    "})()";
+
+// Descriptions of arrays and objects stop listing parts after this many.
+static const size_t kMaxParts = 25;
+
+typedef std::vector<uint16_t> Utf16;
+
+static Local<String> MakeInternalizedString(
+    Isolate* const isolate,
+    const char* str) {
+  return
+      String::NewFromUtf8(isolate, str, NewStringType::kInternalized)
+          .ToLocalChecked();
+}
+
+static void AppendAscii(const char* str, Utf16* out) {
+  for (; *str; ++str) {
+    out->push_back(static_cast<uint8_t>(*str));
+  }
+}
+
+static void AppendString(
+    Isolate* const isolate,
+    const Local<String>& str,
+    Utf16* out) {
+  const int length = str->Length();
+  if (length == 0) return;
+
+  const size_t start = out->size();
+  out->resize(start + length);
+  str->Write(isolate, &(*out)[start], 0, length, String::NO_NULL_TERMINATION);
+}
+
+// The characters matched by \s in JS regular expressions.
+static bool IsJsSpace(uint16_t c) {
+  switch (c) {
+    case '\t':
+    case '\n':
+    case '\v':
+    case '\f':
+    case '\r':
+    case ' ':
+    case 0x00a0:
+    case 0x1680:
+    case 0x2028:
+    case 0x2029:
+    case 0x202f:
+    case 0x205f:
+    case 0x3000:
+    case 0xfeff:
+      return true;
+  }
+
+  return c >= 0x2000 && c <= 0x200a;
+}
+
+// The characters matched by \w in JS regular expressions.
+static bool IsJsWordChar(uint16_t c) {
+  return
+      (c >= 'a' && c <= 'z') ||
+      (c >= 'A' && c <= 'Z') ||
+      (c >= '0' && c <= '9') ||
+      c == '_';
+}
+
+static const uint16_t* SkipSpaces(const uint16_t* p, const uint16_t* end) {
+  while (p != end && IsJsSpace(*p)) ++p;
+  return p;
+}
+
+static const uint16_t* SkipWord(const uint16_t* p, const uint16_t* end) {
+  while (p != end && IsJsWordChar(*p)) ++p;
+  return p;
+}
+
+// If the supplied function source matches the regular expression that
+// stringify.js uses to pick out names and arguments:
+//
+//     /^function(\s+(\w+))?\s*\(\s*(\w+(\s*,\s*\w+)*)?\s*\)/
+//
+// append the abbreviated description, e.g. 'function foo(bar, baz)', and
+// return true. No group in the expression can give back characters and still
+// lead to a match, so it is matched greedily without backtracking.
+static bool AppendFunctionSignature(const Utf16& source, Utf16* out) {
+  const uint16_t* p = source.data();
+  const uint16_t* const end = p + source.size();
+
+  for (const char* keyword = "function"; *keyword; ++keyword, ++p) {
+    if (p == end || *p != *keyword) return false;
+  }
+
+  // The name, which must be separated from the keyword by white space.
+  const uint16_t* name_begin = SkipSpaces(p, end);
+  const uint16_t* name_end = SkipWord(name_begin, end);
+  if (name_begin == p) {
+    name_end = name_begin;
+  }
+
+  p = SkipSpaces(name_end, end);
+  if (p == end || *p != '(') return false;
+  p = SkipSpaces(p + 1, end);
+
+  // The arguments, which are re-joined with ', '.
+  Utf16 args;
+  const uint16_t* word_end = SkipWord(p, end);
+  while (word_end != p) {
+    args.insert(args.end(), p, word_end);
+    p = word_end;
+
+    const uint16_t* const comma = SkipSpaces(p, end);
+    if (comma == end || *comma != ',') break;
+
+    const uint16_t* const next = SkipSpaces(comma + 1, end);
+    word_end = SkipWord(next, end);
+    if (word_end == next) break;
+
+    AppendAscii(", ", &args);
+    p = next;
+  }
+
+  p = SkipSpaces(p, end);
+  if (p == end || *p != ')') return false;
+
+  AppendAscii("function ", out);
+  out->insert(out->end(), name_begin, name_end);
+  out->push_back('(');
+  out->insert(out->end(), args.begin(), args.end());
+  out->push_back(')');
+
+  return true;
+}
+
+Stringifier::Stringifier(
+    Isolate* const isolate,
+    Local<Context> context)
+    : isolate_(CHECK_NOTNULL(isolate)) {
+  const HandleScope handle_scope(isolate_);
+  const Context::Scope context_scope(context);
+
+  const Local<Value> helpers_value =
+      ExecuteJs(isolate_, context, kHelpersJs, "").ToLocalChecked();
+  CHECK(helpers_value->IsArray());
+  const Local<Array> helpers = Local<Array>::Cast(helpers_value);
+
+  v8::Global<Function>* const functions[] = {
+    &inspect_, &is_extensible_, &array_
+  };
+
+  for (uint32 i = 0; i < arraysize(functions); ++i) {
+    const Local<Value> function = helpers->Get(context, i).ToLocalChecked();
+    CHECK(function->IsFunction());
+    functions[i]->Reset(isolate_, Local<Function>::Cast(function));
+  }
+
+  object_tag_.Reset(
+      isolate_,
+      MakeInternalizedString(isolate_, "[object Object]"));
+
+  arguments_tag_.Reset(
+      isolate_,
+      MakeInternalizedString(isolate_, "[object Arguments]"));
+
+  marker_key_.Reset(
+      isolate_,
+      MakeInternalizedString(isolate_, "__gjstest_next_object"));
+}
+
+Stringifier::~Stringifier() {}
+
+MaybeLocal<String> Stringifier::StringifyToDepth(
+    Local<Value> value,
+    int depth) {
+  EscapableHandleScope handle_scope(isolate_);
+
+  Handles handles;
+  handles.context = isolate_->GetCurrentContext();
+  handles.inspect = Local<Function>::New(isolate_, inspect_);
+  handles.is_extensible = Local<Function>::New(isolate_, is_extensible_);
+  handles.array = Local<Function>::New(isolate_, array_);
+  handles.inspection = Array::New(isolate_, 2);
+  handles.object_tag = Local<String>::New(isolate_, object_tag_);
+  handles.arguments_tag = Local<String>::New(isolate_, arguments_tag_);
+  handles.marker_key = Local<String>::New(isolate_, marker_key_);
+
+  const Handles* const outer_handles = handles_;
+  handles_ = &handles;
+
+  Output out;
+  const bool ok =
+      Append(
+          value,
+          depth,
+          value->IsObject() && IsVisited(Local<Object>::Cast(value)),
+          false,
+          &out);
+
+  handles_ = outer_handles;
+
+  if (!ok) {
+    return MaybeLocal<String>();
+  }
+
+  if (out.empty()) {
+    return handle_scope.Escape(String::Empty(isolate_));
+  }
+
+  // v8 gives up on strings that are too long without throwing, so throw what
+  // the JS version would have.
+  Local<String> result;
+  if (out.size() > static_cast<size_t>(String::kMaxLength) ||
+      !String::NewFromTwoByte(
+          isolate_,
+          out.data(),
+          NewStringType::kNormal,
+          out.size()).ToLocal(&result)) {
+    isolate_->ThrowException(
+        v8::Exception::RangeError(
+            MakeInternalizedString(isolate_, "Invalid string length")));
+    return MaybeLocal<String>();
+  }
+
+  return handle_scope.Escape(result);
+}
+
+bool Stringifier::Append(
+    Local<Value> value,
+    int depth,
+    bool visited,
+    bool parent_visited,
+    Output* out) {
+  const HandleScope handle_scope(isolate_);
+  const Local<Context> context = handles_->context;
+
+  // Strings are quoted, with their newlines escaped. Those that happen to be
+  // the same as toString's output for arguments objects or plain objects are
+  // described as such, as stringify.js describes them; their wrappers have the
+  // same toString output.
+  if (value->IsString()) {
+    const Local<String> str = Local<String>::Cast(value);
+    if (str->StrictEquals(handles_->arguments_tag) ||
+        str->StrictEquals(handles_->object_tag)) {
+      const Local<Object> wrapper = value->ToObject(context).ToLocalChecked();
+      return Append(wrapper, depth, IsVisited(wrapper), false, out);
+    }
+
+    out->push_back('\'');
+
+    const size_t start = out->size();
+    AppendString(isolate_, str, out);
+
+    const size_t newlines = std::count(out->begin() + start, out->end(), '\n');
+    if (newlines > 0) {
+      // Expand in place from the back, turning each newline into '\n'.
+      size_t read = out->size();
+      out->resize(out->size() + newlines);
+      size_t write = out->size();
+      while (read > start) {
+        const uint16_t c = (*out)[--read];
+        if (c == '\n') {
+          (*out)[--write] = 'n';
+          (*out)[--write] = '\\';
+        } else {
+          (*out)[--write] = c;
+        }
+      }
+    }
+
+    out->push_back('\'');
+    return true;
+  }
+
+  // Other primitives describe themselves.
+  if (!value->IsObject()) {
+    Local<String> str;
+    if (!value->ToString(context).ToLocal(&str)) return false;
+
+    AppendString(isolate_, str, out);
+    return true;
+  }
+
+  const Local<Object> object = Local<Object>::Cast(value);
+
+  // Arrays are described by their elements whatever toString returns, so don't
+  // bother calling it for them; for an array it joins every element. Anything
+  // else is inspected with a single call into JS.
+  bool is_array = false;
+  bool extensible = false;
+  Local<Value> naive;
+  Local<Value> keys;
+
+  if (value->IsArray()) {
+    if (!value->InstanceOf(context, handles_->array).To(&is_array)) {
+      return false;
+    }
+  }
+
+  if (is_array) {
+    extensible = IsExtensible(object);
+  } else {
+    Local<Value> args[] = { value, handles_->inspection };
+    Local<Value> extensible_value;
+    if (!handles_->inspect
+             ->Call(context, v8::Undefined(isolate_), arraysize(args), args)
+             .ToLocal(&naive) ||
+        !handles_->inspection->Get(context, 0).ToLocal(&extensible_value) ||
+        !handles_->inspection->Get(context, 1).ToLocal(&keys) ||
+        !value->InstanceOf(context, handles_->array).To(&is_array)) {
+      return false;
+    }
+
+    extensible = extensible_value->IsTrue();
+  }
+
+  // The JS version marks each child of a visited object, where it can.
+  if (!visited && parent_visited && extensible) {
+    MarkVisited(object);
+    visited = true;
+  }
+
+  if (is_array || naive->StrictEquals(handles_->arguments_tag)) {
+    return AppendContents(
+        object, Local<Array>(), depth, visited, extensible, '[', ']', out);
+  }
+
+  if (naive->StrictEquals(handles_->object_tag)) {
+    return AppendContents(
+        object,
+        Local<Array>::Cast(keys),
+        depth,
+        visited,
+        extensible,
+        '{',
+        '}',
+        out);
+  }
+
+  // Functions are abbreviated to their names and arguments. Anything else is
+  // described by its toString method.
+  Utf16 naive_chars;
+  AppendString(isolate_, Local<String>::Cast(naive), &naive_chars);
+  if (!AppendFunctionSignature(naive_chars, out)) {
+    out->insert(out->end(), naive_chars.begin(), naive_chars.end());
+  }
+
+  return true;
+}
+
+bool Stringifier::AppendContents(
+    Local<Object> object,
+    Local<Array> keys,
+    int depth,
+    bool visited,
+    bool extensible,
+    char prefix,
+    char suffix,
+    Output* out) {
+  const Local<Context> context = handles_->context;
+
+  // An object that hasn't been visited starts a new set of marks, which lasts
+  // until its description is finished.
+  const bool is_root = !visited;
+  if (is_root) {
+    roots_.emplace_back();
+    if (extensible) {
+      MarkVisited(object);
+      visited = true;
+    }
+  }
+
+  out->push_back(prefix);
+  size_t parts = 0;
+  bool ok = true;
+
+  if (keys.IsEmpty()) {
+    uint32 length = 0;
+    if (object->IsArray()) {
+      length = Local<Array>::Cast(object)->Length();
+    } else {
+      Local<Value> length_value;
+      double length_number = 0;
+      ok =
+          object->Get(context, MakeInternalizedString(isolate_, "length"))
+              .ToLocal(&length_value) &&
+          length_value->NumberValue(context).To(&length_number);
+
+      if (length_number > 0) {
+        length = std::min<double>(ceil(length_number), kuint32max);
+      }
+    }
+
+    for (uint32 i = 0; ok && i < length; ++i) {
+      // Past the depth limit, all that matters is whether there are any parts.
+      if (depth <= 0 && parts > 0) break;
+
+      bool has_element = false;
+      if (!object->HasOwnProperty(context, i).To(&has_element)) {
+        ok = false;
+        break;
+      }
+
+      // Leave a blank space for missing elements, even past the truncation
+      // limit.
+      if (!has_element) {
+        if (depth > 0) AppendAscii(parts == 0 ? " " : ", ", out);
+        ++parts;
+        continue;
+      }
+
+      ok =
+          AppendPart(
+              object,
+              visited,
+              v8::Integer::NewFromUnsigned(isolate_, i),
+              false,
+              depth,
+              &parts,
+              out);
+    }
+  } else {
+    for (uint32 i = 0; ok && i < keys->Length(); ++i) {
+      if (parts > kMaxParts || (depth <= 0 && parts > 0)) break;
+
+      Local<Value> key;
+      ok =
+          keys->Get(context, i).ToLocal(&key) &&
+          AppendPart(object, visited, key, true, depth, &parts, out);
+    }
+  }
+
+  if (is_root) {
+    const size_t root = roots_.size() - 1;
+    for (const int hash : roots_.back()) {
+      const auto range = visited_.equal_range(hash);
+      for (auto it = range.first; it != range.second;) {
+        if (it->second.root == root) {
+          it = visited_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    roots_.pop_back();
+  }
+
+  if (!ok) return false;
+
+  if (parts == 0) {
+    // Nothing to add.
+  } else if (depth <= 0) {
+    AppendAscii("...", out);
+  } else {
+    out->push_back(' ');
+  }
+
+  out->push_back(suffix);
+  return true;
+}
+
+bool Stringifier::AppendPart(
+    Local<Object> object,
+    bool object_visited,
+    Local<Value> key,
+    bool with_key_prefix,
+    int depth,
+    size_t* parts,
+    Output* out) {
+  const HandleScope handle_scope(isolate_);
+
+  // Property names are internalized, so this is an identity comparison.
+  if (with_key_prefix && key == handles_->marker_key) {
+    return true;
+  }
+
+  // Beyond the depth limit, only note that there is something to expand.
+  if (depth <= 0) {
+    *parts = std::max<size_t>(*parts, 1);
+    return true;
+  }
+
+  // Truncate long descriptions, leaving an indicator that parts were removed.
+  if (*parts == kMaxParts) {
+    AppendAscii(", ...", out);
+    ++*parts;
+  }
+
+  if (*parts > kMaxParts) return true;
+
+  Local<Value> child;
+  if (!object->Get(handles_->context, key).ToLocal(&child)) return false;
+
+  AppendAscii(*parts == 0 ? " " : ", ", out);
+  ++*parts;
+
+  if (with_key_prefix) {
+    AppendString(isolate_, Local<String>::Cast(key), out);
+    AppendAscii(": ", out);
+  }
+
+  if (!child->IsObject()) {
+    return Append(child, depth - 1, false, false, out);
+  }
+
+  // Objects that have already been visited are described without their
+  // contents, so that arrays appear as '[]' or '[...]'. A parent that wasn't
+  // visited to begin with may have had a prototype marked since.
+  if (IsVisited(Local<Object>::Cast(child))) {
+    return Append(child, 0, true, false, out);
+  }
+
+  return Append(
+      child,
+      depth - 1,
+      false,
+      object_visited || IsVisited(object),
+      out);
+}
+
+bool Stringifier::IsExtensible(Local<Object> object) {
+  TryCatch try_catch(isolate_);
+
+  Local<Value> args[] = { object };
+  Local<Value> result;
+  return
+      handles_->is_extensible
+          ->Call(
+              handles_->context,
+              v8::Undefined(isolate_),
+              arraysize(args),
+              args)
+          .ToLocal(&result) &&
+      result->IsTrue();
+}
+
+bool Stringifier::IsVisited(Local<Object> object) const {
+  if (visited_.empty()) return false;
+
+  // The JS version finds the marks of prototypes too.
+  Local<Value> value = object;
+  while (value->IsObject()) {
+    const Local<Object> candidate = Local<Object>::Cast(value);
+
+    const auto range = visited_.equal_range(candidate->GetIdentityHash());
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second.object == candidate) return true;
+    }
+
+    value = candidate->GetPrototype();
+  }
+
+  return false;
+}
+
+void Stringifier::MarkVisited(Local<Object> object) {
+  DCHECK(!roots_.empty());
+
+  const int hash = object->GetIdentityHash();
+
+  Visit visit;
+  visit.object.Reset(isolate_, object);
+  visit.root = roots_.size() - 1;
+
+  visited_.emplace(hash, std::move(visit));
+  roots_.back().push_back(hash);
+}
+
+}  // namespace gjstest
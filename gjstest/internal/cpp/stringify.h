@@ -0,0 +1,150 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A native implementation of gjstest.internal.stringifyToDepth. The JS version
+// remembers which objects it has already described by adding a property to
+// each of them, which changes their hidden classes and slows down both the
+// description and the code under test. This one keeps the set of visited
+// objects on the side instead.
+
+#ifndef GJSTEST_INTERNAL_CPP_STRINGIFY_H_
+#define GJSTEST_INTERNAL_CPP_STRINGIFY_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include <v8.h>
+
+#include "base/macros.h"
+
+namespace gjstest {
+
+class Stringifier {
+ public:
+  // Capture the built-in functions that the descriptions depend on from the
+  // supplied context. This must happen before any user code has run in the
+  // context, so that the originals are captured.
+  Stringifier(v8::Isolate* isolate, v8::Local<v8::Context> context);
+  ~Stringifier();
+
+  // Return exactly what gjstest.internal.stringifyToDepth would for the
+  // supplied value and depth, or an empty handle if user code (for example a
+  // toString method) threw an exception.
+  v8::MaybeLocal<v8::String> StringifyToDepth(
+      v8::Local<v8::Value> value,
+      int depth);
+
+ private:
+  typedef std::vector<uint16_t> Output;
+
+  // Local handles for the captured built-ins, created once per call to
+  // StringifyToDepth.
+  struct Handles {
+    v8::Local<v8::Context> context;
+    v8::Local<v8::Function> inspect;
+    v8::Local<v8::Function> is_extensible;
+    v8::Local<v8::Function> array;
+    v8::Local<v8::Array> inspection;
+    v8::Local<v8::String> object_tag;
+    v8::Local<v8::String> arguments_tag;
+    v8::Local<v8::String> marker_key;
+  };
+
+  // Append the description of the supplied value to *out, returning false if
+  // an exception was thrown. If the value is an object, visited says whether
+  // IsVisited is true for it, and parent_visited whether it is for the object
+  // it was found in, if any.
+  bool Append(
+      v8::Local<v8::Value> value,
+      int depth,
+      bool visited,
+      bool parent_visited,
+      Output* out);
+
+  // Append the description of a plain object with the supplied keys, or of an
+  // array or arguments object if keys is empty, surrounded by the supplied
+  // brackets.
+  bool AppendContents(
+      v8::Local<v8::Object> object,
+      v8::Local<v8::Array> keys,
+      int depth,
+      bool visited,
+      bool extensible,
+      char prefix,
+      char suffix,
+      Output* out);
+
+  // Append the description of one element or property of the supplied
+  // object, in the manner of ObjectDescriptionBuilder.addKeyWithPrefix. *parts
+  // is the number of parts in the description so far.
+  bool AppendPart(
+      v8::Local<v8::Object> object,
+      bool object_visited,
+      v8::Local<v8::Value> key,
+      bool with_key_prefix,
+      int depth,
+      size_t* parts,
+      Output* out);
+
+  // Return Object.isExtensible(object), treating exceptions as false.
+  bool IsExtensible(v8::Local<v8::Object> object);
+
+  // Has the object, or any object on its prototype chain, been marked as
+  // visited by the description in progress?
+  bool IsVisited(v8::Local<v8::Object> object) const;
+
+  // Mark the object as visited until the innermost description that started
+  // with an unvisited object finishes.
+  void MarkVisited(v8::Local<v8::Object> object);
+
+  v8::Isolate* const isolate_;
+
+  // A function that does the JS work needed for each object, along with
+  // Object.isExtensible and Array.
+  v8::Global<v8::Function> inspect_;
+  v8::Global<v8::Function> is_extensible_;
+  v8::Global<v8::Function> array_;
+
+  // The strings that toString gives for plain objects and arguments objects,
+  // and the name of the property the JS version marks objects with.
+  v8::Global<v8::String> object_tag_;
+  v8::Global<v8::String> arguments_tag_;
+  v8::Global<v8::String> marker_key_;
+
+  // The handles for the innermost call to StringifyToDepth in progress, which
+  // may be re-entered from a toString method.
+  const Handles* handles_ = NULL;
+
+  // An object marked as visited, and the index in roots_ of the description
+  // that marked it.
+  struct Visit {
+    v8::Global<v8::Object> object;
+    size_t root;
+  };
+
+  // The objects marked as visited, keyed by identity hash.
+  std::unordered_multimap<int, Visit> visited_;
+
+  // For each description in progress that started with an unvisited object,
+  // innermost last, the identity hashes of the objects it marked.
+  std::vector<std::vector<int>> roots_;
+
+  DISALLOW_COPY_AND_ASSIGN(Stringifier);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_STRINGIFY_H_
@@ -1,3 +1,8 @@
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/buffer_compare, \
+        base/integral_types \
+))
+
 $(eval $(call cc_library, \
     gjstest/internal/cpp/builtin_data, \
         base/logging \
@@ -13,6 +18,48 @@ $(eval $(call hdr_only_cc_library, \
     gjstest/internal/cpp/builtin_paths.generated, \
 ))
 
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/diff, \
+        base/integral_types \
+))
+
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/event_loop, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        gjstest/internal/cpp/v8_utils \
+))
+
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/heap_guard, \
+        base/logging \
+        base/macros \
+))
+
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/module_loader, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        file/file_utils \
+        gjstest/internal/cpp/v8_utils \
+        strings/strutil \
+        util/gtl/map_util \
+))
+
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/natives, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        file/file_utils \
+        gjstest/internal/cpp/buffer_compare \
+        gjstest/internal/cpp/diff \
+        gjstest/internal/cpp/stringify \
+        gjstest/internal/cpp/v8_utils \
+))
+
 $(eval $(call cc_library, \
     gjstest/internal/cpp/run_tests, \
         base/basictypes \
@@ -22,14 +69,39 @@ $(eval $(call cc_library, \
         base/stl_decl \
         base/stringprintf \
         base/timer \
+        gjstest/internal/cpp/event_loop \
+        gjstest/internal/cpp/heap_guard \
+        gjstest/internal/cpp/module_loader \
+        gjstest/internal/cpp/natives \
+        gjstest/internal/cpp/script_pipeline \
         gjstest/internal/cpp/test_case \
+        gjstest/internal/cpp/typed_arrays \
         gjstest/internal/cpp/v8_utils \
+        gjstest/internal/cpp/workers \
         gjstest/internal/proto/named_scripts.pb \
         strings/strutil \
         util/gtl/map_util \
         webutil/xml/xml_writer \
 ))
 
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/script_pipeline, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        file/file_utils \
+        gjstest/internal/cpp/v8_utils \
+        gjstest/internal/proto/named_scripts.pb \
+))
+
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/stringify, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        gjstest/internal/cpp/v8_utils \
+))
+
 $(eval $(call cc_library, \
     gjstest/internal/cpp/test_case, \
         base/callback \
@@ -45,6 +117,7 @@ $(eval $(call cc_library, \
 $(eval $(call cc_library, \
     gjstest/internal/cpp/typed_arrays, \
         base/logging \
+        base/macros \
 ))
 
 $(eval $(call cc_library, \
@@ -53,22 +126,60 @@ $(eval $(call cc_library, \
         base/integral_types \
         base/logging \
         base/stringprintf \
+        file/file_utils \
         gjstest/internal/cpp/typed_arrays \
 ))
 
+$(eval $(call cc_library, \
+    gjstest/internal/cpp/workers, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        base/stringprintf \
+        file/file_utils \
+        gjstest/internal/cpp/event_loop \
+        gjstest/internal/cpp/heap_guard \
+        gjstest/internal/cpp/v8_utils \
+))
+
 ######################################################
 # Tests
 ######################################################
 
+$(eval $(call cc_test, \
+    gjstest/internal/cpp/buffer_compare_test, \
+        base/integral_types \
+        gjstest/internal/cpp/buffer_compare \
+        , \
+        -lpthread \
+))
+
+$(eval $(call cc_test, \
+    gjstest/internal/cpp/diff_test, \
+        base/integral_types \
+        base/stringprintf \
+        gjstest/internal/cpp/diff \
+        , \
+        -lpthread \
+))
+
+$(eval $(call cc_test, \
+    gjstest/internal/cpp/typed_arrays_test, \
+        gjstest/internal/cpp/typed_arrays \
+        , \
+        -lpthread \
+))
+
 $(eval $(call cc_test, \
     gjstest/internal/cpp/v8_utils_test, \
         base/callback \
         base/integral_types \
         base/logging \
         base/macros \
+        file/file_utils \
         gjstest/internal/cpp/v8_utils \
         , \
-        -lv8_libbase -lv8_libplatform \
+        -lgflags -lv8_libbase -lv8_libplatform \
 ))
 
 ######################################################
@@ -87,8 +198,40 @@ $(eval $(call cc_binary, \
         strings/strutil \
         , \
         -lprotobuf -lglog -lgflags -lxml2 -lre2 -lv8_libbase -lv8_libplatform \
+        -lpthread \
 ))
 
+######################################################
+# Benchmarks
+######################################################
+
+$(eval $(call cc_benchmark, \
+    gjstest/internal/cpp/startup_benchmark, \
+        base/integral_types \
+        base/logging \
+        base/macros \
+        base/stringprintf \
+        base/timer \
+        file/file_utils \
+        gjstest/internal/cpp/builtin_data \
+        gjstest/internal/cpp/event_loop \
+        gjstest/internal/cpp/heap_guard \
+        gjstest/internal/cpp/natives \
+        gjstest/internal/cpp/script_pipeline \
+        gjstest/internal/cpp/typed_arrays \
+        gjstest/internal/cpp/v8_utils \
+        gjstest/internal/cpp/workers \
+        gjstest/internal/proto/named_scripts.pb \
+        strings/strutil \
+        , \
+        -lprotobuf -lglog -lgflags -lre2 -lv8_libbase -lv8_libplatform \
+        -lpthread \
+        , \
+        --data_dir=share/gjstest \
+))
+
+gjstest/internal/cpp/startup_benchmark.json : share
+
 ######################################################
 # Generated code
 ######################################################
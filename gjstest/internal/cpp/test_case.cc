@@ -39,109 +39,179 @@ Local<Function> TestCase::GetFunctionNamed(const string& name) const {
   return Local<Function>::Cast(result);
 }
 
-// Log the supplied string to the test's output.
+// Log the supplied string to the test's output, unless it has been closed.
 v8::Local<v8::Value> TestCase::LogString(
+    const std::shared_ptr<TestCase*>& self,
     const v8::FunctionCallbackInfo<v8::Value>& cb_info) {
   CHECK_EQ(1, cb_info.Length());
-  const string message = ConvertToString(isolate_, cb_info[0]);
-  StringAppendF(&this->output, "%s\n", message.c_str());
+  Isolate* const isolate = cb_info.GetIsolate();
+  TestCase* const test_case = *self;
+  if (!test_case) return v8::Undefined(isolate);
 
-  return v8::Undefined(isolate_);
+  const string message = ConvertToString(isolate, cb_info[0]);
+  StringAppendF(&test_case->output, "%s\n", message.c_str());
+
+  return v8::Undefined(isolate);
 }
 
-// Record the test as having failed, and extract a failure message from the JS
-// arguments and append it to the existing messages, if any.
+// Record the test as having failed, unless it has been closed, and extract a
+// failure message from the JS arguments and append it to the existing
+// messages, if any.
 v8::Local<v8::Value> TestCase::RecordFailure(
+    const std::shared_ptr<TestCase*>& self,
     const v8::FunctionCallbackInfo<v8::Value>& cb_info) {
   CHECK_EQ(1, cb_info.Length());
-  const string message = ConvertToString(isolate_, cb_info[0]);
+  Isolate* const isolate = cb_info.GetIsolate();
+  TestCase* const test_case = *self;
+  if (test_case) {
+    test_case->Fail(ConvertToString(isolate, cb_info[0]) + "\n\n");
+  }
 
-  this->succeeded = false;
-  StringAppendF(&this->output, "%s\n\n", message.c_str());
-  StringAppendF(&this->failure_output, "%s\n\n", message.c_str());
+  return v8::Undefined(isolate);
+}
 
-  return v8::Undefined(isolate_);
+void TestCase::Finish() {
+  promise_.Reset();
+  timer_.Stop();
+  duration_ms = timer_.GetInMs();
+  done_ = true;
 }
 
 TestCase::TestCase(
     v8::Isolate* const isolate,
     const Local<Function>& test_function)
     : isolate_(CHECK_NOTNULL(isolate)),
-      test_function_(test_function) {
-  CHECK(test_function_->IsFunction());
+      test_function_(isolate, test_function),
+      self_(new TestCase*(this)) {
+  CHECK(test_function->IsFunction());
+}
+
+TestCase::~TestCase() {
+  Close();
+}
+
+void TestCase::Close() {
+  *self_ = NULL;
+  test_environment_.Reset();
 }
 
-void TestCase::Run() {
-  CycleTimer timer;
-  timer.Start();
+Local<Value> TestCase::test_environment() const {
+  return Local<Value>::New(isolate_, test_environment_);
+}
+
+void TestCase::Start() {
+  timer_.Start();
 
   // Assume we succeeded by default.
   succeeded = true;
 
-  // Grab references to runTest, getCurrentStack, and the TestEnvironment
+  // Grab references to runTest, captureCurrentStack, and the TestEnvironment
   // constructor.
   const Local<Function> run_test = GetFunctionNamed("gjstest.internal.runTest");
 
-  const Local<Function> get_current_stack =
-      GetFunctionNamed("gjstest.internal.getCurrentStack");
+  const Local<Function> capture_current_stack =
+      GetFunctionNamed("gjstest.internal.captureCurrentStack");
 
   const Local<Function> test_env_constructor =
       GetFunctionNamed("gjstest.internal.TestEnvironment");
 
-  // Create log and reportFailure functions.
-  V8FunctionCallback log_cb =
-      std::bind(
-          &TestCase::LogString,
-          this,
-          std::placeholders::_1);
-
+  // Create log and reportFailure functions. They may be called after this
+  // object has gone, so they own their callbacks.
   const Local<Function> log =
-      MakeFunction(
+      MakeOwningFunction(
           isolate_,
           "log",
-          &log_cb);
-
-  V8FunctionCallback report_failure_cb =
-      std::bind(
-          &TestCase::RecordFailure,
-          this,
-          std::placeholders::_1);
+          std::bind(
+              &TestCase::LogString,
+              self_,
+              std::placeholders::_1));
 
   const Local<Function> report_failure =
-      MakeFunction(
+      MakeOwningFunction(
           isolate_,
           "reportFailure",
-          &report_failure_cb);
+          std::bind(
+              &TestCase::RecordFailure,
+              self_,
+              std::placeholders::_1));
 
   // Create a test environment.
-  Local<Value> test_env_args[] = { log, report_failure, get_current_stack };
+  Local<Value> test_env_args[] = {
+    log,
+    report_failure,
+    capture_current_stack,
+  };
   const Local<Object> test_env =
       test_env_constructor
           ->NewInstance(isolate_->GetCurrentContext(), arraysize(test_env_args),
                         test_env_args)
           .ToLocalChecked();
 
+  test_environment_.Reset(isolate_, test_env);
+
   // Run the test.
   TryCatch try_catch(isolate_);
-  Local<Value> args[] = { test_function_, test_env };
-  const Local<Value> result =
-      run_test->Call(
+  Local<Value> args[] = {
+    Local<Function>::New(isolate_, test_function_),
+    test_env,
+  };
+
+  Local<Value> result;
+  if (!run_test->Call(
+          isolate_->GetCurrentContext(),
           isolate_->GetCurrentContext()->Global(),
           arraysize(args),
-          args);
-
-  // Was there an exception while running the test?
-  if (result.IsEmpty()) {
+          args).ToLocal(&result)) {
+    // There was an exception while running the test.
     succeeded = false;
 
     const string description = DescribeError(isolate_, try_catch);
     StringAppendF(&output, "%s\n", description.c_str());
     StringAppendF(&failure_output, "%s\n", description.c_str());
+  } else if (result->IsPromise()) {
+    // The test is asynchronous; it finishes when the promise settles.
+    promise_.Reset(isolate_, Local<v8::Promise>::Cast(result));
+    return;
   }
 
-  // Record the test time.
-  timer.Stop();
-  duration_ms = timer.GetInMs();
+  Finish();
+}
+
+bool TestCase::Poll() {
+  if (done_) return true;
+
+  const Local<v8::Promise> promise =
+      Local<v8::Promise>::New(isolate_, promise_);
+
+  switch (promise->State()) {
+    case v8::Promise::kPending:
+      return false;
+
+    // runTest has already reported any failure of the test itself, so a
+    // rejection means something went wrong in the runner.
+    case v8::Promise::kRejected:
+      Fail(ConvertToString(isolate_, promise->Result()) + "\n\n");
+      break;
+
+    case v8::Promise::kFulfilled:
+      break;
+  }
+
+  Finish();
+  return true;
+}
+
+void TestCase::Fail(const string& message) {
+  succeeded = false;
+  output += message;
+  failure_output += message;
+}
+
+void TestCase::Abandon(const string& message) {
+  if (done_) return;
+
+  Fail(message);
+  Finish();
 }
 
 }  // namespace gjstest
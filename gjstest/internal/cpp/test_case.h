@@ -18,6 +18,7 @@
 #ifndef GJSTEST_INTERNAL_CPP_TEST_CASE_H_
 #define GJSTEST_INTERNAL_CPP_TEST_CASE_H_
 
+#include <memory>
 #include <string>
 
 #include <v8.h>
@@ -25,6 +26,8 @@
 #include "base/integral_types.h"
 #include "base/macros.h"
 #include "base/stl_decl.h"
+#include "base/timer.h"
+#include "gjstest/internal/cpp/v8_utils.h"
 
 namespace gjstest {
 
@@ -36,12 +39,39 @@ class TestCase {
       v8::Isolate* isolate,
       const v8::Local<v8::Function>& test_function);
 
-  // Run the test case and fill in the properties below. It is assumed that a
-  // context is currently active in which all of the test's dependencies have
-  // been evaluated.
+  ~TestCase();
+
+  // Start running the test case. It is assumed that a context is currently
+  // active in which all of the test's dependencies have been evaluated.
+  //
+  // If the test function returns a promise, the test keeps running until the
+  // promise settles. Otherwise it has finished by the time this returns.
   //
   // Behavior is undefined if this method is called twice on the same object.
-  void Run();
+  void Start();
+
+  // Return true if the test has finished, in which case the properties below
+  // are filled in. The microtasks queued by the test must be run for its
+  // promise to settle.
+  bool Poll();
+
+  // Fail the test, appending the supplied message to its output. The message
+  // should end with a blank line.
+  void Fail(const string& message);
+
+  // If the test hasn't finished, stop waiting for it and fail it with the
+  // supplied message.
+  void Abandon(const string& message);
+
+  // Stop recording output from the test, once it has been reported, and let
+  // go of its environment. Code left behind by the test may still call the
+  // environment's functions, which do nothing from now on, even once this
+  // object has been destroyed.
+  void Close();
+
+  // The gjstest.internal.TestEnvironment that the test runs in. Empty once
+  // the test case has been closed.
+  v8::Local<v8::Value> test_environment() const;
 
   // Did the test succeed or fail?
   bool succeeded = false;
@@ -57,7 +87,19 @@ class TestCase {
 
  private:
   v8::Isolate* const isolate_;
-  const v8::Local<v8::Function> test_function_;
+  const v8::Global<v8::Function> test_function_;
+
+  // The test's environment, and the promise returned by
+  // gjstest.internal.runTest while the test is running asynchronously.
+  v8::Global<v8::Value> test_environment_;
+  v8::Global<v8::Promise> promise_;
+
+  CycleTimer timer_;
+  bool done_ = false;
+
+  // The test case, until it's closed, shared with the test environment's log
+  // and reportFailure functions, which may outlive it.
+  const std::shared_ptr<TestCase*> self_;
 
   ///////////////////////////////////
   // Helpers
@@ -66,10 +108,15 @@ class TestCase {
   v8::Local<v8::Function> GetFunctionNamed(
       const string& name) const;
 
-  v8::Local<v8::Value> LogString(
+  // Record the test as finished.
+  void Finish();
+
+  static v8::Local<v8::Value> LogString(
+      const std::shared_ptr<TestCase*>& self,
       const v8::FunctionCallbackInfo<v8::Value>& cb_info);
 
-  v8::Local<v8::Value> RecordFailure(
+  static v8::Local<v8::Value> RecordFailure(
+      const std::shared_ptr<TestCase*>& self,
       const v8::FunctionCallbackInfo<v8::Value>& cb_info);
 
   DISALLOW_COPY_AND_ASSIGN(TestCase);
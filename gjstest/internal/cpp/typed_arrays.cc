@@ -13,39 +13,162 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+
 #include <v8.h>
 
+#include "base/logging.h"
 #include "gjstest/internal/cpp/typed_arrays.h"
 
 namespace gjstest {
 
-namespace {
-class MallocArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
-public:
-  virtual void* Allocate(size_t length) {
-    void* const result = malloc(length);
-    if (result) {
+// Buffers up to this size are served from the pools; anything larger is mapped
+// on its own.
+static const size_t kMaxPooledSize = 64 << 10;
+
+// The smallest size class. Every size class is a power of two multiple of
+// this, which keeps all pooled blocks suitably aligned.
+static const size_t kMinPooledSize = 16;
+static const size_t kNumSizeClasses = 13;  // 16 bytes to 64 KiB
+
+// The size of the mappings that pooled blocks are carved out of.
+static const size_t kSlabSize = 1 << 20;
+
+// Return the index of the smallest size class that can hold the given length,
+// which must be at most kMaxPooledSize.
+static size_t SizeClass(const size_t length) {
+  size_t size_class = 0;
+  while ((kMinPooledSize << size_class) < length) ++size_class;
+  return size_class;
+}
+
+// Round the supplied length up to a whole number of pages.
+static size_t RoundUpToPage(const size_t length) {
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  return (length + page_size - 1) / page_size * page_size;
+}
+
+// Return a new anonymous mapping of the given size, or NULL on failure.
+static void* MapAnonymous(const size_t length) {
+  void* const result =
+      mmap(
+          NULL,
+          length,
+          PROT_READ | PROT_WRITE,
+          MAP_PRIVATE | MAP_ANONYMOUS,
+          -1,
+          0);
+
+  return result == MAP_FAILED ? NULL : result;
+}
+
+ArrayBufferAllocator::ArrayBufferAllocator()
+    : free_lists_(kNumSizeClasses, NULL) {}
+
+ArrayBufferAllocator::~ArrayBufferAllocator() {
+  for (void* const slab : slabs_) {
+    PCHECK(munmap(slab, kSlabSize) == 0);
+  }
+}
+
+void* ArrayBufferAllocator::Allocate(size_t length) {
+  return AllocateInternal(length, true);
+}
+
+void* ArrayBufferAllocator::AllocateUninitialized(size_t length) {
+  return AllocateInternal(length, false);
+}
+
+void* ArrayBufferAllocator::AllocateInternal(size_t length, bool zero) {
+  // Large buffers are mapped without holding the lock.
+  const bool pooled = length <= kMaxPooledSize;
+  void* const mapping = pooled ? NULL : MapAnonymous(RoundUpToPage(length));
+  if (!pooled && !mapping) return NULL;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  void* const result = pooled ? AllocateSmall(length, zero) : mapping;
+  if (!result) return NULL;
+
+  live_bytes_ += length;
+  peak_bytes_ = std::max(peak_bytes_, live_bytes_);
+
+  return result;
+}
+
+void* ArrayBufferAllocator::AllocateSmall(size_t length, bool zero) {
+  const size_t size_class = SizeClass(length);
+  const size_t block_size = kMinPooledSize << size_class;
+
+  // Reuse a freed block if there is one. Only these need to be cleared.
+  void*& free_list = free_lists_[size_class];
+  if (free_list) {
+    void* const result = free_list;
+    free_list = *static_cast<void**>(result);
+
+    if (zero) {
       memset(result, 0, length);
     }
 
     return result;
   }
 
-  virtual void* AllocateUninitialized(size_t length) {
-    return malloc(length);
+  // Otherwise carve a fresh block out of the current slab, starting a new one
+  // if there isn't enough left.
+  if (slab_remaining_ < block_size) {
+    void* const slab = MapAnonymous(kSlabSize);
+    if (!slab) return NULL;
+
+    slabs_.push_back(slab);
+    slab_next_ = static_cast<char*>(slab);
+    slab_remaining_ = kSlabSize;
   }
 
-  virtual void Free(void* data, size_t length) {
-    free(data);
+  void* const result = slab_next_;
+  slab_next_ += block_size;
+  slab_remaining_ -= block_size;
+
+  return result;
+}
+
+void ArrayBufferAllocator::Free(void* data, size_t length) {
+  if (!data) return;
+
+  if (length > kMaxPooledSize) {
+    PCHECK(munmap(data, RoundUpToPage(length)) == 0);
   }
-};
-}  // namespace
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  live_bytes_ -= length;
+
+  if (length <= kMaxPooledSize) {
+    void*& free_list = free_lists_[SizeClass(length)];
+    *static_cast<void**>(data) = free_list;
+    free_list = data;
+  }
+}
+
+size_t ArrayBufferAllocator::live_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return live_bytes_;
+}
+
+size_t ArrayBufferAllocator::peak_bytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return peak_bytes_;
+}
+
+void ArrayBufferAllocator::ResetPeak() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  peak_bytes_ = live_bytes_;
+}
 
 std::unique_ptr<v8::ArrayBuffer::Allocator> NewArrayBufferAllocator() {
   return std::unique_ptr<v8::ArrayBuffer::Allocator>(
-      new MallocArrayBufferAllocator);
+      new ArrayBufferAllocator);
 }
 
 }  // namespace gjstest
@@ -22,13 +22,67 @@
 #ifndef GJSTEST_INTERNAL_CPP_TYPED_ARRAYS_H_
 #define GJSTEST_INTERNAL_CPP_TYPED_ARRAYS_H_
 
+#include <stddef.h>
+
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include <v8.h>
 
+#include "base/macros.h"
+
 namespace gjstest {
 
-// Create a straightforward array buffer allocator for v8.
+// An array buffer allocator for v8 that keeps track of how much memory is in
+// use. Large buffers are given their own anonymous mappings, which the kernel
+// hands out already zeroed. Small buffers are carved out of larger mappings and
+// recycled through per-size free lists, so only reused memory needs clearing.
+//
+// v8 may free buffers from background threads, so all methods are thread-safe.
+class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
+ public:
+  ArrayBufferAllocator();
+  ~ArrayBufferAllocator() override;
+
+  void* Allocate(size_t length) override;
+  void* AllocateUninitialized(size_t length) override;
+  void Free(void* data, size_t length) override;
+
+  // The total length of the buffers currently allocated.
+  size_t live_bytes() const;
+
+  // The largest value live_bytes has had since the last call to ResetPeak, or
+  // since construction.
+  size_t peak_bytes() const;
+
+  // Reset peak_bytes to the current value of live_bytes, e.g. at the start of
+  // a test.
+  void ResetPeak();
+
+ private:
+  void* AllocateInternal(size_t length, bool zero);
+  void* AllocateSmall(size_t length, bool zero);
+
+  mutable std::mutex mutex_;
+
+  size_t live_bytes_ = 0;
+  size_t peak_bytes_ = 0;
+
+  // For each size class, a list of freed blocks linked through their first
+  // word.
+  std::vector<void*> free_lists_;
+
+  // The unused remainder of the most recent slab, and every slab mapped so far.
+  char* slab_next_ = NULL;
+  size_t slab_remaining_ = 0;
+  std::vector<void*> slabs_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArrayBufferAllocator);
+};
+
+// Create an array buffer allocator suitable for v8 isolates that don't need to
+// inspect its accounting.
 std::unique_ptr<v8::ArrayBuffer::Allocator> NewArrayBufferAllocator();
 
 }  // namespace gjstest
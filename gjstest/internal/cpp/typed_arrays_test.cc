@@ -0,0 +1,99 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+#include "gjstest/internal/cpp/typed_arrays.h"
+
+namespace gjstest {
+
+// Return true iff the supplied buffer contains only zeroes.
+static bool AllZero(const void* data, size_t length) {
+  const char* const bytes = static_cast<const char*>(data);
+  for (size_t i = 0; i < length; ++i) {
+    if (bytes[i]) return false;
+  }
+
+  return true;
+}
+
+class ArrayBufferAllocatorTest : public ::testing::Test {
+ protected:
+  ArrayBufferAllocator allocator_;
+};
+
+TEST_F(ArrayBufferAllocatorTest, SmallBuffersAreZeroed) {
+  void* const first = allocator_.Allocate(100);
+  ASSERT_TRUE(first != NULL);
+  EXPECT_TRUE(AllZero(first, 100));
+
+  // Dirty the buffer and give it back. It should be reused, but cleared.
+  memset(first, 0xab, 100);
+  allocator_.Free(first, 100);
+
+  void* const second = allocator_.Allocate(100);
+  EXPECT_EQ(first, second);
+  EXPECT_TRUE(AllZero(second, 100));
+
+  allocator_.Free(second, 100);
+}
+
+TEST_F(ArrayBufferAllocatorTest, LargeBuffersAreZeroed) {
+  const size_t length = 10 << 20;
+
+  void* const buffer = allocator_.Allocate(length);
+  ASSERT_TRUE(buffer != NULL);
+  EXPECT_TRUE(AllZero(buffer, length));
+
+  memset(buffer, 0xab, length);
+  allocator_.Free(buffer, length);
+}
+
+TEST_F(ArrayBufferAllocatorTest, EmptyBuffers) {
+  void* const a = allocator_.Allocate(0);
+  void* const b = allocator_.Allocate(0);
+
+  ASSERT_TRUE(a != NULL);
+  ASSERT_TRUE(b != NULL);
+  EXPECT_NE(a, b);
+
+  allocator_.Free(a, 0);
+  allocator_.Free(b, 0);
+}
+
+TEST_F(ArrayBufferAllocatorTest, LiveAndPeakBytes) {
+  EXPECT_EQ(0, allocator_.live_bytes());
+  EXPECT_EQ(0, allocator_.peak_bytes());
+
+  void* const small = allocator_.AllocateUninitialized(17);
+  void* const large = allocator_.Allocate(1 << 20);
+
+  EXPECT_EQ(17 + (1 << 20), allocator_.live_bytes());
+  EXPECT_EQ(17 + (1 << 20), allocator_.peak_bytes());
+
+  allocator_.Free(large, 1 << 20);
+  EXPECT_EQ(17, allocator_.live_bytes());
+  EXPECT_EQ(17 + (1 << 20), allocator_.peak_bytes());
+
+  allocator_.ResetPeak();
+  EXPECT_EQ(17, allocator_.peak_bytes());
+
+  allocator_.Free(small, 17);
+  EXPECT_EQ(0, allocator_.live_bytes());
+  EXPECT_EQ(17, allocator_.peak_bytes());
+}
+
+}  // namespace gjstest
@@ -15,12 +15,14 @@
 
 #include "gjstest/internal/cpp/v8_utils.h"
 
+#include <gflags/gflags.h>
 #include <v8-platform.h>
 #include <libplatform/libplatform.h>
 
 #include "base/integral_types.h"
 #include "base/logging.h"
 #include "base/stringprintf.h"
+#include "file/file_utils.h"
 #include "gjstest/internal/cpp/typed_arrays.h"
 
 using v8::Array;
@@ -42,6 +44,11 @@ using v8::TryCatch;
 using v8::UnboundScript;
 using v8::Value;
 
+DEFINE_int32(platform_worker_threads, 0,
+             "The number of worker threads v8 may use for background tasks "
+             "such as concurrent compilation and garbage collection. Zero "
+             "lets v8 choose based on the number of processors.");
+
 namespace gjstest {
 
 // The global platform that we initialized v8 with.
@@ -50,7 +57,11 @@ static v8::Platform* platform_;
 // Ensure that v8 and platform_ have been initialized.
 static void InitOnce() {
   static const int dummy = []{
-    platform_ = v8::platform::CreateDefaultPlatform();
+    platform_ =
+        v8::platform::CreateDefaultPlatform(
+            FLAGS_platform_worker_threads,
+            v8::platform::IdleTaskSupport::kEnabled);
+
     v8::V8::InitializePlatform(platform_);
     v8::V8::Initialize();
     return 0;
@@ -59,18 +70,25 @@ static void InitOnce() {
   (void)dummy;  // Silence "unused variable" errors.
 }
 
-IsolateHandle CreateIsolate() {
+void InitializeV8() {
   InitOnce();
+}
 
-  // Create an array buffer allocator.
-  const std::shared_ptr<v8::ArrayBuffer::Allocator> allocator =
-      NewArrayBufferAllocator();
+IsolateHandle CreateIsolate() {
+  return CreateIsolate(NewArrayBufferAllocator(), v8::ResourceConstraints());
+}
+
+IsolateHandle CreateIsolate(
+    const std::shared_ptr<v8::ArrayBuffer::Allocator>& allocator,
+    const v8::ResourceConstraints& constraints) {
+  InitOnce();
 
   // Set up an appropriate isolate, ensuring that it is disposed of when the
   // handle goes away. Also make sure the allocator sticks around as long as
   // needed.
   v8::Isolate::CreateParams params;
   params.array_buffer_allocator = allocator.get();
+  params.constraints = constraints;
 
   return {
     v8::Isolate::New(params),
@@ -90,6 +108,154 @@ static Local<String> ConvertString(
       s.size());
 }
 
+namespace {
+
+// An external string resource for ASCII text that refers directly to the
+// memory of a mapped file.
+class MappedFileResource : public String::ExternalOneByteStringResource {
+ public:
+  explicit MappedFileResource(const std::shared_ptr<const MappedFile>& file)
+      : file_(file) {}
+
+  const char* data() const override { return file_->data(); }
+  size_t length() const override { return file_->size(); }
+
+ private:
+  const std::shared_ptr<const MappedFile> file_;
+};
+
+// An external string resource that owns UTF-16 text.
+class Utf16Resource : public String::ExternalStringResource {
+ public:
+  explicit Utf16Resource(std::vector<uint16_t>* chars) {
+    chars_.swap(*chars);
+  }
+
+  const uint16_t* data() const override { return chars_.data(); }
+  size_t length() const override { return chars_.size(); }
+
+ private:
+  std::vector<uint16_t> chars_;
+};
+
+}  // namespace
+
+// The code point that ReadUtf8 returns for a malformed sequence.
+static const uint32 kMalformedUtf8 = 0xffffffff;
+
+// Decode the UTF-8 sequence starting at the supplied offset, which must be
+// within the text, and advance the offset past it. Return kMalformedUtf8 if
+// the sequence is malformed, having skipped its lead byte and any continuation
+// bytes that followed.
+static uint32 ReadUtf8(
+    const uint8* const bytes,
+    const size_t size,
+    size_t* const offset) {
+  size_t i = *offset;
+  const uint8 lead = bytes[i];
+
+  // Figure out how many continuation bytes to expect, and the smallest code
+  // point that legally requires that many.
+  uint32 code_point;
+  size_t continuation_bytes;
+  uint32 min_code_point;
+
+  if (lead < 0x80) {
+    ++*offset;
+    return lead;
+  } else if ((lead & 0xe0) == 0xc0) {
+    code_point = lead & 0x1f;
+    continuation_bytes = 1;
+    min_code_point = 0x80;
+  } else if ((lead & 0xf0) == 0xe0) {
+    code_point = lead & 0x0f;
+    continuation_bytes = 2;
+    min_code_point = 0x800;
+  } else if ((lead & 0xf8) == 0xf0) {
+    code_point = lead & 0x07;
+    continuation_bytes = 3;
+    min_code_point = 0x10000;
+  } else {
+    ++*offset;
+    return kMalformedUtf8;
+  }
+
+  size_t j = 1;
+  for (; j <= continuation_bytes && i + j < size; ++j) {
+    if ((bytes[i + j] & 0xc0) != 0x80) break;
+    code_point = (code_point << 6) | (bytes[i + j] & 0x3f);
+  }
+
+  *offset = i + j;
+  if (j <= continuation_bytes ||
+      code_point < min_code_point ||
+      code_point > 0x10ffff ||
+      (code_point >= 0xd800 && code_point <= 0xdfff)) {
+    return kMalformedUtf8;
+  }
+
+  return code_point;
+}
+
+bool IsValidUtf8(const char* const data, const size_t size) {
+  const uint8* const bytes = reinterpret_cast<const uint8*>(data);
+  for (size_t i = 0; i < size; ) {
+    if (ReadUtf8(bytes, size, &i) == kMalformedUtf8) return false;
+  }
+
+  return true;
+}
+
+// Decode the supplied UTF-8 text into UTF-16, replacing malformed sequences
+// with U+FFFD.
+static void DecodeUtf8(
+    const char* const data,
+    const size_t size,
+    std::vector<uint16_t>* const result) {
+  const uint8* const bytes = reinterpret_cast<const uint8*>(data);
+  result->reserve(size);
+
+  for (size_t i = 0; i < size; ) {
+    uint32 code_point = ReadUtf8(bytes, size, &i);
+    if (code_point == kMalformedUtf8) {
+      result->push_back(0xfffd);
+    } else if (code_point >= 0x10000) {
+      code_point -= 0x10000;
+      result->push_back(0xd800 | (code_point >> 10));
+      result->push_back(0xdc00 | (code_point & 0x3ff));
+    } else {
+      result->push_back(code_point);
+    }
+  }
+}
+
+Local<String> MakeExternalString(
+    Isolate* const isolate,
+    const std::shared_ptr<const MappedFile>& file) {
+  const char* const data = file->data();
+  const size_t size = file->size();
+
+  // Pure ASCII is also valid Latin-1, so v8 can use the mapping as is.
+  bool ascii = true;
+  for (size_t i = 0; i < size && ascii; ++i) {
+    ascii = !(data[i] & 0x80);
+  }
+
+  if (ascii) {
+    return String::NewExternalOneByte(
+        isolate,
+        new MappedFileResource(file)).ToLocalChecked();
+  }
+
+  // Otherwise we need to decode once, but v8 can still share our buffer.
+  std::vector<uint16_t> chars;
+  DecodeUtf8(data, size, &chars);
+
+  return String::NewExternalTwoByte(
+      isolate,
+      new Utf16Resource(&chars)).ToLocalChecked();
+}
+
 std::string ConvertToString(v8::Isolate* isolate, const Local<Value>& value) {
   const String::Utf8Value utf8_value(isolate, value);
   return std::string(*utf8_value, utf8_value.length());
@@ -110,43 +276,79 @@ void ConvertToStringVector(
   }
 }
 
-static MaybeLocal<UnboundScript> Compile(Isolate* const isolate,
-                                         const std::string& js,
-                                         const std::string& filename) {
+MaybeLocal<UnboundScript> CompileJs(Isolate* const isolate,
+                                    const std::string& js,
+                                    const std::string& filename) {
+  return CompileJs(isolate, ConvertString(isolate, js), filename);
+}
+
+MaybeLocal<UnboundScript> CompileJs(Isolate* const isolate,
+                                    const Local<String>& js,
+                                    const std::string& filename) {
+  InitOnce();
+
   if (filename.empty()) {
-    ScriptCompiler::Source source(ConvertString(isolate, js));
+    ScriptCompiler::Source source(js);
     return ScriptCompiler::CompileUnboundScript(isolate, &source);
   }
 
   ScriptCompiler::Source source(
-      ConvertString(isolate, js),
+      js,
       ScriptOrigin(ConvertString(isolate, filename)));
 
   return ScriptCompiler::CompileUnboundScript(isolate, &source);
 }
 
+MaybeLocal<Value> RunCompiledJs(Isolate* const isolate,
+                                Local<Context> context,
+                                const Local<UnboundScript>& script) {
+  InitOnce();
+
+  // Run the script.
+  auto result = script->BindToCurrentContext()->Run(context);
+
+  // Give v8 a chance to process any foreground tasks that are pending.
+  RunPendingTasks(isolate);
+
+  return result;
+}
+
+void RunPendingTasks(Isolate* const isolate) {
+  InitOnce();
+  while (v8::platform::PumpMessageLoop(platform_, isolate)) {}
+}
+
+void GiveIdleTime(Isolate* const isolate, const double seconds) {
+  InitOnce();
+
+  // Let the garbage collector use the time first, then hand anything left over
+  // to idle tasks that v8 has posted.
+  const double deadline = platform_->MonotonicallyIncreasingTime() + seconds;
+  isolate->IdleNotificationDeadline(deadline);
+
+  const double remaining = deadline - platform_->MonotonicallyIncreasingTime();
+  if (remaining > 0) {
+    v8::platform::RunIdleTasks(platform_, isolate, remaining);
+  }
+}
+
 MaybeLocal<Value> ExecuteJs(Isolate* const isolate, Local<Context> context,
                             const std::string& js,
                             const std::string& filename) {
-  InitOnce();
-
   // Attempt to compile the script.
   Local<UnboundScript> script;
 
-  if (!Compile(isolate, js, filename).ToLocal(&script)) {
+  if (!CompileJs(isolate, js, filename).ToLocal(&script)) {
     return Local<Value>();
   }
 
-  // Run the script.
-  auto result = script->BindToCurrentContext()->Run(context);
-
-  // Give v8 a chance to process any foreground tasks that are pending.
-  while (v8::platform::PumpMessageLoop(platform_, isolate)) {}
-
-  return result;
+  return RunCompiledJs(isolate, context, script);
 }
 
 std::string DescribeError(Isolate* isolate, const TryCatch& try_catch) {
+  // There is no exception to speak of when execution was terminated.
+  if (try_catch.HasTerminated()) return "Execution terminated.";
+
   const std::string exception = ConvertToString(isolate, try_catch.Exception());
   const Local<Message> message = try_catch.Message();
 
@@ -166,6 +368,11 @@ std::string DescribeError(Isolate* isolate, const TryCatch& try_catch) {
     return StringPrintf("%s: %s", filename.c_str(), exception.c_str());
   }
 
+  // Errors thrown from C++ while no script is running have no location.
+  if (line == 0 && message->GetScriptResourceName()->IsUndefined()) {
+    return exception;
+  }
+
   return StringPrintf("%s:%i: %s", filename.c_str(), line, exception.c_str());
 }
 
@@ -211,18 +418,52 @@ Local<Function> MakeFunction(
           isolate,
           CHECK_NOTNULL(callback));
 
-  // Create a function template with the wrapped callback as associated data,
-  // and instantiate it.
+  // Create a function with the wrapped callback as associated data. Unlike
+  // instances of function templates, the context doesn't cache it, so it can
+  // be garbage collected.
   const Local<Function> result =
-      FunctionTemplate::New(
-          isolate,
+      Function::New(
+          isolate->GetCurrentContext(),
           RunAssociatedCallback,
-          data)
-      ->GetFunction();
+          data).ToLocalChecked();
 
   result->SetName(ConvertString(isolate, name));
 
   return result;
 }
 
+// A callback owned by the function that wraps it.
+struct OwnedCallback {
+  V8FunctionCallback callback;
+  v8::Global<Function> function;
+};
+
+static void DeleteOwnedCallback(
+    const v8::WeakCallbackInfo<OwnedCallback>& info) {
+  delete info.GetParameter();
+}
+
+static void ReleaseOwnedCallback(
+    const v8::WeakCallbackInfo<OwnedCallback>& info) {
+  info.GetParameter()->function.Reset();
+  info.SetSecondPassCallback(&DeleteOwnedCallback);
+}
+
+Local<Function> MakeOwningFunction(
+    Isolate* const isolate,
+    const std::string& name,
+    const V8FunctionCallback& callback) {
+  OwnedCallback* const owned = new OwnedCallback;
+  owned->callback = callback;
+
+  const Local<Function> result = MakeFunction(isolate, name, &owned->callback);
+  owned->function.Reset(isolate, result);
+  owned->function.SetWeak(
+      owned,
+      &ReleaseOwnedCallback,
+      v8::WeakCallbackType::kParameter);
+
+  return result;
+}
+
 }  // namespace gjstest
@@ -27,14 +27,28 @@
 
 #include <v8.h>
 
+class MappedFile;
+
 namespace gjstest {
 
+// Initialize v8 and the platform it runs on, if that hasn't already been done.
+// The other functions here do this as needed, so it only needs to be called
+// explicitly to control when the cost is paid.
+void InitializeV8();
+
 // An RAII handle for an isolate.
 typedef std::shared_ptr<v8::Isolate> IsolateHandle;
 
 // Create an initialized v8 isolate, with support for array buffers.
 IsolateHandle CreateIsolate();
 
+// Like CreateIsolate, but use the supplied allocator for array buffers and
+// limits on the resources used by the isolate. The isolate keeps the allocator
+// alive for as long as it needs it.
+IsolateHandle CreateIsolate(
+    const std::shared_ptr<v8::ArrayBuffer::Allocator>& allocator,
+    const v8::ResourceConstraints& constraints);
+
 // Convert the supplied value to a UTF-8 string.
 std::string ConvertToString(v8::Isolate* isolate,
                             const v8::Local<v8::Value>& value);
@@ -45,6 +59,44 @@ void ConvertToStringVector(
     const v8::Local<v8::Value>& value,
     std::vector<std::string>* result);
 
+// Is the supplied text well-formed UTF-8, by the rules MakeExternalString
+// decodes it with?
+bool IsValidUtf8(const char* data, size_t size);
+
+// Create a JS string with the contents of the supplied file, which must be
+// UTF-8. When the contents are pure ASCII they are not copied; the string
+// refers directly to the mapping, which is kept alive for as long as v8 needs
+// it.
+v8::Local<v8::String> MakeExternalString(
+    v8::Isolate* isolate,
+    const std::shared_ptr<const MappedFile>& file);
+
+// Compile the supplied string as JS, returning an empty handle in the event of
+// an error. See ExecuteJs for the meaning of filename.
+v8::MaybeLocal<v8::UnboundScript> CompileJs(v8::Isolate* isolate,
+                                            const std::string& js,
+                                            const std::string& filename);
+
+v8::MaybeLocal<v8::UnboundScript> CompileJs(v8::Isolate* isolate,
+                                            const v8::Local<v8::String>& js,
+                                            const std::string& filename);
+
+// Run a script previously compiled with CompileJs in the supplied context,
+// returning the result, or an empty handle in the event of an error.
+v8::MaybeLocal<v8::Value> RunCompiledJs(
+    v8::Isolate* isolate,
+    v8::Local<v8::Context> context,
+    const v8::Local<v8::UnboundScript>& script);
+
+// Run any foreground tasks that v8 has posted for the isolate, such as the
+// finalization of work done on background threads. RunCompiledJs does this
+// after running a script.
+void RunPendingTasks(v8::Isolate* isolate);
+
+// Tell v8 that the isolate will be idle for the supplied number of seconds,
+// letting it do garbage collection work and run idle tasks in that time.
+void GiveIdleTime(v8::Isolate* isolate, double seconds);
+
 // Execute the supplied string as JS in the current context, returning the
 // result, or an empty handle in the event of an error. (The error can be
 // recovered by creating a TryCatch object on the stack before calling this
@@ -58,7 +110,7 @@ v8::MaybeLocal<v8::Value> ExecuteJs(v8::Isolate* isolate,
                                     const std::string& filename);
 
 // Return a human-readable string describing the error caught by the supplied
-// try-catch block.
+// try-catch block, which may also have caught the termination of execution.
 std::string DescribeError(v8::Isolate*, const v8::TryCatch& try_catch);
 
 // C++ functions exported by v8 must accept a FunctionCallbackInfo<Value> object
@@ -85,6 +137,14 @@ v8::Local<v8::Function> MakeFunction(
     const std::string& name,
     V8FunctionCallback* callback);
 
+// Like MakeFunction, but the function keeps its own copy of the callback,
+// which is destroyed once the function has been garbage collected. Use this
+// for functions that may outlive whatever creates them.
+v8::Local<v8::Function> MakeOwningFunction(
+    v8::Isolate* isolate,
+    const std::string& name,
+    const V8FunctionCallback& callback);
+
 }  // namespace gjstest
 
 #endif  // GJSTEST_INTERNAL_CPP_V8_UTILS_H_
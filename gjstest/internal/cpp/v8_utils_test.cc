@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <v8.h>
@@ -22,6 +24,7 @@
 #include "base/integral_types.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "file/file_utils.h"
 
 using testing::ContainsRegex;
 using testing::ElementsAre;
@@ -148,6 +151,92 @@ TEST_F(ConvertToStringTest, Numbers) {
   EXPECT_EQ("3.14", ConvertToString(isolate_.get(), MakeNumber(3.14)));
 }
 
+////////////////////////////////////////////////////////////////////////
+// IsValidUtf8
+////////////////////////////////////////////////////////////////////////
+
+TEST(IsValidUtf8Test, WellFormed) {
+  EXPECT_TRUE(IsValidUtf8("", 0));
+  EXPECT_TRUE(IsValidUtf8("taco", 4));
+
+  // Two-, three-, and four-byte sequences.
+  const std::string text = "caf\xc3\xa9 \xed\x83\x80 \xf0\x9f\x8c\xae";
+  EXPECT_TRUE(IsValidUtf8(text.data(), text.size()));
+}
+
+TEST(IsValidUtf8Test, Malformed) {
+  // A bad lead byte, a truncated sequence, an overlong encoding and a
+  // surrogate.
+  EXPECT_FALSE(IsValidUtf8("a\xff", 2));
+  EXPECT_FALSE(IsValidUtf8("a\xc3", 2));
+  EXPECT_FALSE(IsValidUtf8("\xc0\xaf", 2));
+  EXPECT_FALSE(IsValidUtf8("\xed\xa0\x80", 3));
+}
+
+////////////////////////////////////////////////////////////////////////
+// MakeExternalString
+////////////////////////////////////////////////////////////////////////
+
+class MakeExternalStringTest : public V8UtilsTest {
+ protected:
+  Local<String> MakeExternalStringWithContents(const std::string& contents) {
+    const std::string path = tmpnam(NULL);
+    WriteStringToFileOrDie(contents, path);
+
+    const std::shared_ptr<const MappedFile> file(new MappedFile(path));
+    return MakeExternalString(isolate_.get(), file);
+  }
+};
+
+TEST_F(MakeExternalStringTest, Empty) {
+  HandleScope handle_owner(isolate_.get());
+
+  const Local<String> result = MakeExternalStringWithContents("");
+  EXPECT_EQ(0, result->Length());
+}
+
+TEST_F(MakeExternalStringTest, Ascii) {
+  HandleScope handle_owner(isolate_.get());
+
+  const Local<String> result = MakeExternalStringWithContents("taco\nburrito");
+  EXPECT_TRUE(result->IsExternalOneByte());
+  EXPECT_EQ("taco\nburrito", ConvertToString(isolate_.get(), result));
+}
+
+TEST_F(MakeExternalStringTest, NonAscii) {
+  HandleScope handle_owner(isolate_.get());
+
+  // Two-, three-, and four-byte UTF-8 sequences.
+  const std::string contents = "caf\xc3\xa9 \xed\x83\x80 \xf0\x9f\x8c\xae";
+  const Local<String> result = MakeExternalStringWithContents(contents);
+
+  EXPECT_TRUE(result->IsExternal());
+  EXPECT_EQ(9, result->Length());
+  EXPECT_EQ(contents, ConvertToString(isolate_.get(), result));
+}
+
+TEST_F(MakeExternalStringTest, MalformedUtf8) {
+  HandleScope handle_owner(isolate_.get());
+
+  const Local<String> result = MakeExternalStringWithContents("a\xc3" "b\xff");
+  EXPECT_EQ("a\xef\xbf\xbd" "b\xef\xbf\xbd",
+            ConvertToString(isolate_.get(), result));
+}
+
+TEST_F(MakeExternalStringTest, CanBeCompiled) {
+  HandleScope handle_owner(isolate_.get());
+
+  const Local<String> js = MakeExternalStringWithContents("'taco' + 'burrito'");
+  const Local<v8::UnboundScript> script =
+      CompileJs(isolate_.get(), js, "taco.js").ToLocalChecked();
+
+  EXPECT_EQ(
+      "tacoburrito",
+      ConvertToString(
+          isolate_.get(),
+          RunCompiledJs(isolate_.get(), context_, script).ToLocalChecked()));
+}
+
 ////////////////////////////////////////////////////////////////////////
 // ExecuteJs
 ////////////////////////////////////////////////////////////////////////
@@ -245,6 +334,17 @@ TEST_F(DescribeErrorTest, WithMessage) {
   EXPECT_EQ("taco.js:1: Error: foo", DescribeError(isolate_.get(), try_catch));
 }
 
+TEST_F(DescribeErrorTest, ThrownOutsideOfScripts) {
+  HandleScope handle_owner(isolate_.get());
+
+  TryCatch try_catch(isolate_.get());
+  isolate_->ThrowException(
+      v8::Exception::Error(
+          String::NewFromUtf8(isolate_.get(), "foo")));
+
+  EXPECT_EQ("Error: foo", DescribeError(isolate_.get(), try_catch));
+}
+
 ////////////////////////////////////////////////////////////////////////
 // ConvertToStringVector
 ////////////////////////////////////////////////////////////////////////
@@ -388,4 +488,60 @@ TEST_F(MakeFunctionTest, CallsCallback) {
   EXPECT_EQ(18, counter_);
 }
 
+////////////////////////////////////////////////////////////////////////
+// MakeOwningFunction
+////////////////////////////////////////////////////////////////////////
+
+static Local<Value> AddToSharedCounter(
+    Isolate* const isolate,
+    const std::shared_ptr<uint32>& counter,
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  return AddToCounter(isolate, counter.get(), cb_info);
+}
+
+typedef V8UtilsTest MakeOwningFunctionTest;
+
+TEST_F(MakeOwningFunctionTest, OutlivesCallback) {
+  uint32 counter = 0;
+  Local<Function> func;
+
+  {
+    const V8FunctionCallback callback =
+        std::bind(
+            &AddToCounter,
+            isolate_.get(),
+            &counter,
+            std::placeholders::_1);
+
+    func = MakeOwningFunction(isolate_.get(), "taco", callback);
+  }
+
+  ASSERT_FALSE(func.IsEmpty());
+  EXPECT_EQ("taco", ConvertToString(isolate_.get(), func->GetName()));
+
+  Local<Value> args[] = { MakeInteger(17) };
+  func->Call(isolate_.get()->GetCurrentContext()->Global(), 1, args);
+
+  EXPECT_EQ(17, counter);
+}
+
+TEST_F(MakeOwningFunctionTest, ReleasesCallbackOnceCollected) {
+  const std::shared_ptr<uint32> counter(new uint32(0));
+
+  {
+    const HandleScope handle_scope(isolate_.get());
+    MakeOwningFunction(
+        isolate_.get(),
+        "taco",
+        std::bind(
+            &AddToSharedCounter,
+            isolate_.get(),
+            counter,
+            std::placeholders::_1));
+  }
+
+  isolate_->LowMemoryNotification();
+  EXPECT_EQ(1, counter.use_count());
+}
+
 }  // namespace gjstest
@@ -0,0 +1,710 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gjstest/internal/cpp/workers.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+#include "base/logging.h"
+#include "base/stringprintf.h"
+#include "file/file_utils.h"
+#include "gjstest/internal/cpp/event_loop.h"
+#include "gjstest/internal/cpp/heap_guard.h"
+
+using v8::ArrayBuffer;
+using v8::Context;
+using v8::Function;
+using v8::Isolate;
+using v8::Local;
+using v8::MaybeLocal;
+using v8::Object;
+using v8::SharedArrayBuffer;
+using v8::String;
+using v8::TryCatch;
+using v8::Value;
+
+namespace gjstest {
+
+static void ThrowError(Isolate* const isolate, const std::string& message) {
+  isolate->ThrowException(
+      v8::Exception::Error(String::NewFromUtf8(isolate, message.c_str())));
+}
+
+// Set a property of an object, which may fail only if execution is being
+// terminated.
+static void SetProperty(
+    Isolate* const isolate,
+    const Local<Object>& object,
+    const char* name,
+    const Local<Value>& value) {
+  object->Set(
+      isolate->GetCurrentContext(),
+      String::NewFromUtf8(isolate, name),
+      value).FromMaybe(false);
+}
+
+// Return the onmessage handler of the supplied object, or an empty handle if
+// it has none.
+static Local<Function> GetMessageHandler(
+    Isolate* const isolate,
+    const Local<Object>& object) {
+  Local<Value> handler;
+  if (!object->Get(
+          isolate->GetCurrentContext(),
+          String::NewFromUtf8(isolate, "onmessage")).ToLocal(&handler) ||
+      !handler->IsFunction()) {
+    return Local<Function>();
+  }
+
+  return Local<Function>::Cast(handler);
+}
+
+// Create the event passed to onmessage.
+static Local<Object> MakeMessageEvent(
+    Isolate* const isolate,
+    const Local<Value>& data) {
+  const Local<Object> event = Object::New(isolate);
+  SetProperty(isolate, event, "data", data);
+  return event;
+}
+
+struct Workers::Message {
+  explicit Message(const std::shared_ptr<ArrayBuffer::Allocator>& allocator)
+      : allocator(allocator) {
+  }
+
+  // Free the buffers that were transferred but never delivered.
+  ~Message() {
+    for (const auto& buffer : transferred) {
+      if (buffer.first) allocator->Free(buffer.first, buffer.second);
+    }
+  }
+
+  // The output of v8::ValueSerializer.
+  std::vector<uint8> data;
+
+  // The memory of the SharedArrayBuffers in the message, indexed by the IDs
+  // under which they were serialized.
+  std::vector<std::pair<void*, size_t>> shared;
+
+  // The contents of the ArrayBuffers in the transfer list, until they're
+  // handed to the receiving isolate.
+  std::vector<std::pair<void*, size_t>> transferred;
+
+  const std::shared_ptr<ArrayBuffer::Allocator> allocator;
+};
+
+struct Workers::Worker {
+  uint32 id = 0;
+  std::string path;
+
+  // The Worker object and the test that created it, which are used only on
+  // the main thread.
+  v8::Global<Object> object;
+  v8::Global<Value> test_environment;
+
+  std::thread thread;
+
+  // Has the worker's script called close? Used only on the worker's thread.
+  bool closing = false;
+
+  // Messages waiting to be delivered to the worker, whether it's being
+  // terminated, and its isolate while it has one, guarded by mutex.
+  std::mutex mutex;
+  std::condition_variable message_posted;
+  std::deque<std::unique_ptr<Message>> inbox;
+  bool terminating = false;
+  Isolate* isolate = NULL;
+};
+
+class Workers::SerializerDelegate : public v8::ValueSerializer::Delegate {
+ public:
+  SerializerDelegate(
+      Workers* const workers,
+      Isolate* const isolate,
+      Message* const message)
+      : workers_(workers),
+        isolate_(isolate),
+        message_(message) {
+  }
+
+  void ThrowDataCloneError(const Local<String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  v8::Maybe<uint32_t> GetSharedArrayBufferId(
+      Isolate* const isolate,
+      const Local<SharedArrayBuffer> buffer) override {
+    const std::pair<void*, size_t> memory = workers_->ShareMemory(buffer);
+
+    std::vector<std::pair<void*, size_t>>& shared = message_->shared;
+    const auto it = std::find(shared.begin(), shared.end(), memory);
+    if (it != shared.end()) return v8::Just<uint32_t>(it - shared.begin());
+
+    shared.push_back(memory);
+    return v8::Just<uint32_t>(shared.size() - 1);
+  }
+
+ private:
+  Workers* const workers_;
+  Isolate* const isolate_;
+  Message* const message_;
+
+  DISALLOW_COPY_AND_ASSIGN(SerializerDelegate);
+};
+
+class Workers::DeserializerDelegate : public v8::ValueDeserializer::Delegate {
+ public:
+  explicit DeserializerDelegate(const Message* const message)
+      : message_(message) {
+  }
+
+  MaybeLocal<SharedArrayBuffer> GetSharedArrayBufferFromId(
+      Isolate* const isolate,
+      const uint32_t id) override {
+    if (id >= message_->shared.size()) return MaybeLocal<SharedArrayBuffer>();
+
+    // The memory is externalized, so the buffer doesn't own it.
+    const std::pair<void*, size_t>& memory = message_->shared[id];
+    return SharedArrayBuffer::New(isolate, memory.first, memory.second);
+  }
+
+ private:
+  const Message* const message_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeserializerDelegate);
+};
+
+Workers::Workers(
+    Isolate* const isolate,
+    Local<Context> context,
+    EventLoop* const event_loop,
+    const std::shared_ptr<ArrayBuffer::Allocator>& allocator,
+    const v8::ResourceConstraints& constraints)
+    : isolate_(CHECK_NOTNULL(isolate)),
+      context_(isolate, context),
+      event_loop_(CHECK_NOTNULL(event_loop)),
+      allocator_(allocator),
+      constraints_(constraints) {
+  const v8::HandleScope handle_scope(isolate_);
+  const Context::Scope context_scope(context);
+
+  id_key_.Reset(
+      isolate_,
+      v8::Private::ForApi(
+          isolate_,
+          String::NewFromUtf8(isolate_, "gjstest::workerId")));
+
+  const Local<Function> constructor =
+      AddFunction(
+          "Worker",
+          std::bind(&Workers::NewWorker, this, std::placeholders::_1));
+
+  const Local<Object> prototype =
+      Local<Object>::Cast(
+          constructor->Get(
+              context,
+              String::NewFromUtf8(isolate_, "prototype")).ToLocalChecked());
+
+  SetProperty(
+      isolate_,
+      prototype,
+      "postMessage",
+      AddFunction(
+          "postMessage",
+          std::bind(&Workers::PostToWorker, this, std::placeholders::_1)));
+
+  SetProperty(
+      isolate_,
+      prototype,
+      "terminate",
+      AddFunction(
+          "terminate",
+          std::bind(&Workers::Terminate, this, std::placeholders::_1)));
+
+  SetProperty(isolate_, context->Global(), "Worker", constructor);
+}
+
+Workers::~Workers() {
+  while (!workers_.empty()) {
+    TerminateWorker(workers_.begin()->first);
+  }
+
+  // No isolate is left to use the shared memory.
+  for (const auto& memory : shared_memory_) {
+    allocator_->Free(memory.first, memory.second);
+  }
+}
+
+void Workers::DiscardTest(Local<Value> test_environment) {
+  if (!test_environment->IsObject()) return;
+
+  std::vector<uint32> ids;
+  for (const auto& entry : workers_) {
+    if (entry.second->test_environment == test_environment) {
+      ids.push_back(entry.first);
+    }
+  }
+
+  for (const uint32 id : ids) {
+    TerminateWorker(id);
+  }
+}
+
+std::unique_ptr<Workers::Message> Workers::Serialize(
+    Isolate* const isolate,
+    Local<Value> value,
+    Local<Value> transfer_list) {
+  const Local<Context> context = isolate->GetCurrentContext();
+  std::unique_ptr<Message> message(new Message(allocator_));
+  SerializerDelegate delegate(this, isolate, message.get());
+  v8::ValueSerializer serializer(isolate, &delegate);
+
+  // Check the transfer list, and tell the serializer about its buffers.
+  std::vector<Local<ArrayBuffer>> buffers;
+  if (!transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      ThrowError(isolate, "The transfer list must be an array.");
+      return NULL;
+    }
+
+    const Local<v8::Array> array = Local<v8::Array>::Cast(transfer_list);
+    for (uint32 i = 0; i < array->Length(); ++i) {
+      Local<Value> element;
+      if (!array->Get(context, i).ToLocal(&element)) return NULL;
+
+      if (!element->IsArrayBuffer()) {
+        ThrowError(isolate, "Only ArrayBuffers can be transferred.");
+        return NULL;
+      }
+
+      const Local<ArrayBuffer> buffer = Local<ArrayBuffer>::Cast(element);
+      if (std::find(buffers.begin(), buffers.end(), buffer) != buffers.end()) {
+        ThrowError(isolate, "An ArrayBuffer is transferred more than once.");
+        return NULL;
+      }
+
+      // Buffers whose memory belongs to someone else can't be handed over.
+      if (buffer->IsExternal() || !buffer->IsNeuterable()) {
+        ThrowError(isolate, "An ArrayBuffer can't be transferred.");
+        return NULL;
+      }
+
+      serializer.TransferArrayBuffer(buffers.size(), buffer);
+      buffers.push_back(buffer);
+    }
+  }
+
+  serializer.WriteHeader();
+  if (serializer.WriteValue(context, value).IsNothing()) return NULL;
+
+  // Take the memory of the transferred buffers, leaving them empty.
+  for (const Local<ArrayBuffer>& buffer : buffers) {
+    const ArrayBuffer::Contents contents = buffer->Externalize();
+    buffer->Neuter();
+    message->transferred.emplace_back(contents.Data(), contents.ByteLength());
+  }
+
+  const std::pair<uint8_t*, size_t> data = serializer.Release();
+  message->data.assign(data.first, data.first + data.second);
+  free(data.first);
+
+  return message;
+}
+
+MaybeLocal<Value> Workers::Deserialize(
+    Isolate* const isolate,
+    Message* const message) {
+  const Local<Context> context = isolate->GetCurrentContext();
+  DeserializerDelegate delegate(message);
+  v8::ValueDeserializer deserializer(
+      isolate,
+      message->data.data(),
+      message->data.size(),
+      &delegate);
+
+  // Hand the transferred memory to the isolate, which will free it.
+  for (uint32 i = 0; i < message->transferred.size(); ++i) {
+    std::pair<void*, size_t>& memory = message->transferred[i];
+    deserializer.TransferArrayBuffer(
+        i,
+        ArrayBuffer::New(
+            isolate,
+            memory.first,
+            memory.second,
+            v8::ArrayBufferCreationMode::kInternalized));
+
+    memory.first = NULL;
+  }
+
+  if (deserializer.ReadHeader(context).IsNothing()) return MaybeLocal<Value>();
+  return deserializer.ReadValue(context);
+}
+
+std::pair<void*, size_t> Workers::ShareMemory(
+    Local<SharedArrayBuffer> buffer) {
+  if (buffer->IsExternal()) {
+    const SharedArrayBuffer::Contents contents = buffer->GetContents();
+    return std::make_pair(contents.Data(), contents.ByteLength());
+  }
+
+  // Take the memory away from the isolate that allocated it, so that it
+  // outlives the isolate.
+  const SharedArrayBuffer::Contents contents = buffer->Externalize();
+  const std::pair<void*, size_t> memory(
+      contents.Data(),
+      contents.ByteLength());
+
+  std::lock_guard<std::mutex> lock(shared_memory_mutex_);
+  shared_memory_.push_back(memory);
+  return memory;
+}
+
+void Workers::RunWorker(Worker* const worker) {
+  const IsolateHandle isolate = CreateIsolate(allocator_, constraints_);
+
+  bool terminating;
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    terminating = worker->terminating;
+    if (!terminating) worker->isolate = isolate.get();
+  }
+
+  if (!terminating) {
+    RunWorkerScript(worker, isolate.get());
+
+    // Make sure nobody terminates the isolate once it's gone.
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->isolate = NULL;
+  }
+
+  event_loop_->PostTask(
+      std::bind(&Workers::OnWorkerExit, this, worker->id));
+}
+
+void Workers::RunWorkerScript(Worker* const worker, Isolate* const isolate) {
+  const Isolate::Scope isolate_scope(isolate);
+  const v8::HandleScope handle_scope(isolate);
+  const Local<Context> context = Context::New(isolate);
+  const Context::Scope context_scope(context);
+
+  // Stop the worker if it runs out of memory, rather than crashing.
+  HeapGuard heap_guard(isolate);
+
+  // Set up the global scope.
+  V8FunctionCallback post_message =
+      std::bind(&Workers::PostToMain, this, worker, std::placeholders::_1);
+  V8FunctionCallback close =
+      std::bind(&Workers::Close, this, worker, std::placeholders::_1);
+
+  const Local<Object> global = context->Global();
+  SetProperty(isolate, global, "self", global);
+  SetProperty(
+      isolate,
+      global,
+      "postMessage",
+      MakeFunction(isolate, "postMessage", &post_message));
+  SetProperty(isolate, global, "close", MakeFunction(isolate, "close", &close));
+
+  // Run the script.
+  std::string error;
+  const std::shared_ptr<const MappedFile> file(
+      MappedFile::Open(worker->path, false, &error));
+
+  if (!file) {
+    event_loop_->PostTask(
+        std::bind(
+            &Workers::ReportWorkerError,
+            this,
+            worker->id,
+            "Uncaught exception in worker: " + error));
+    return;
+  }
+
+  {
+    const TryCatch try_catch(isolate);
+    Local<v8::UnboundScript> script;
+    if (!CompileJs(
+            isolate,
+            MakeExternalString(isolate, file),
+            worker->path).ToLocal(&script) ||
+        RunCompiledJs(isolate, context, script).IsEmpty()) {
+      ReportException(worker, isolate, try_catch, &heap_guard);
+      return;
+    }
+  }
+
+  // Deliver messages until the worker is closed or terminated. Exceptions
+  // thrown by its handler are reported, but don't stop it.
+  while (!worker->closing) {
+    const std::unique_ptr<Message> message = WaitForMessage(worker);
+    if (!message) return;
+
+    const v8::HandleScope message_handle_scope(isolate);
+    const TryCatch try_catch(isolate);
+
+    Local<Value> data;
+    if (Deserialize(isolate, message.get()).ToLocal(&data)) {
+      const Local<Function> handler = GetMessageHandler(isolate, global);
+      Local<Value> args[] = { MakeMessageEvent(isolate, data) };
+      if (handler.IsEmpty() ||
+          !handler->Call(context, global, arraysize(args), args).IsEmpty()) {
+        continue;
+      }
+    }
+
+    if (!ReportException(worker, isolate, try_catch, &heap_guard)) return;
+  }
+}
+
+bool Workers::ReportException(
+    Worker* const worker,
+    Isolate* const isolate,
+    const TryCatch& try_catch,
+    HeapGuard* const heap_guard) {
+  // Recovering from heap exhaustion cancels the termination, so check first.
+  const bool terminated = try_catch.HasTerminated();
+
+  std::string message;
+  if (heap_guard->Recover()) {
+    message =
+        StringPrintf(
+            "Worker terminated after nearly exhausting the JS heap limit of "
+            "%zu MB. See --max_old_space_mb.",
+            heap_guard->initial_heap_limit() >> 20);
+  } else if (!terminated) {
+    message =
+        "Uncaught exception in worker: " + DescribeError(isolate, try_catch);
+  } else {
+    return false;
+  }
+
+  event_loop_->PostTask(
+      std::bind(&Workers::ReportWorkerError, this, worker->id, message));
+
+  return !terminated;
+}
+
+std::unique_ptr<Workers::Message> Workers::WaitForMessage(
+    Worker* const worker) {
+  std::unique_lock<std::mutex> lock(worker->mutex);
+  while (worker->inbox.empty() && !worker->terminating) {
+    worker->message_posted.wait(lock);
+  }
+
+  if (worker->terminating) return NULL;
+
+  std::unique_ptr<Message> message = std::move(worker->inbox.front());
+  worker->inbox.pop_front();
+  return message;
+}
+
+Local<Value> Workers::PostToMain(
+    Worker* const worker,
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  Isolate* const isolate = cb_info.GetIsolate();
+  std::unique_ptr<Message> message =
+      Serialize(isolate, cb_info[0], cb_info[1]);
+
+  if (!message) return Local<Value>();
+
+  event_loop_->PostTask(
+      std::bind(
+          &Workers::DeliverMessage,
+          this,
+          worker->id,
+          std::shared_ptr<Message>(std::move(message))));
+
+  return v8::Undefined(isolate);
+}
+
+Local<Value> Workers::Close(
+    Worker* const worker,
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  worker->closing = true;
+  return v8::Undefined(cb_info.GetIsolate());
+}
+
+void Workers::DeliverMessage(
+    const uint32 id,
+    const std::shared_ptr<Message>& message) {
+  const auto it = workers_.find(id);
+  if (it == workers_.end()) return;
+  const Worker& worker = *it->second;
+
+  const v8::HandleScope handle_scope(isolate_);
+  const Local<Context> context = Local<Context>::New(isolate_, context_);
+  const Context::Scope context_scope(context);
+
+  const Local<Object> object = Local<Object>::New(isolate_, worker.object);
+  const Local<Value> test_environment =
+      Local<Value>::New(isolate_, worker.test_environment);
+
+  Local<Value> data;
+  {
+    const TryCatch try_catch(isolate_);
+    if (!Deserialize(isolate_, message.get()).ToLocal(&data)) {
+      if (!try_catch.HasTerminated()) {
+        event_loop_->ReportError(test_environment, try_catch.Exception());
+      }
+
+      return;
+    }
+  }
+
+  const Local<Function> handler = GetMessageHandler(isolate_, object);
+  if (handler.IsEmpty()) return;
+
+  Local<Value> args[] = { MakeMessageEvent(isolate_, data) };
+  event_loop_->CallInTest(
+      test_environment,
+      handler,
+      object,
+      arraysize(args),
+      args);
+}
+
+void Workers::ReportWorkerError(
+    const uint32 id,
+    const std::string& message) {
+  const auto it = workers_.find(id);
+  if (it == workers_.end()) return;
+  const Worker& worker = *it->second;
+
+  const v8::HandleScope handle_scope(isolate_);
+  const Context::Scope context_scope(Local<Context>::New(isolate_, context_));
+
+  event_loop_->ReportError(
+      Local<Value>::New(isolate_, worker.test_environment),
+      v8::Exception::Error(
+          String::NewFromUtf8(isolate_, message.c_str())));
+}
+
+void Workers::OnWorkerExit(const uint32 id) {
+  TerminateWorker(id);
+}
+
+Local<Value> Workers::NewWorker(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  if (!cb_info.IsConstructCall()) {
+    ThrowError(isolate_, "Worker must be called with new.");
+    return Local<Value>();
+  }
+
+  if (cb_info.Length() < 1 || !cb_info[0]->IsString()) {
+    ThrowError(isolate_, "Worker requires the path of a script.");
+    return Local<Value>();
+  }
+
+  const Local<Object> object = cb_info.This();
+  const uint32 id = next_worker_id_++;
+  if (!object->SetPrivate(
+          isolate_->GetCurrentContext(),
+          Local<v8::Private>::New(isolate_, id_key_),
+          v8::Integer::NewFromUnsigned(isolate_, id)).FromMaybe(false)) {
+    return Local<Value>();
+  }
+
+  std::unique_ptr<Worker>& worker = workers_[id];
+  worker.reset(new Worker);
+  worker->id = id;
+  worker->path = ConvertToString(isolate_, cb_info[0]);
+  worker->object.Reset(isolate_, object);
+  worker->test_environment.Reset(isolate_, event_loop_->GetCurrentTest());
+
+  // The runner waits for messages from the worker until it's terminated.
+  event_loop_->AddTaskSource();
+  worker->thread = std::thread(&Workers::RunWorker, this, worker.get());
+
+  return object;
+}
+
+Local<Value> Workers::PostToWorker(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  const uint32 id = GetWorkerId(cb_info);
+  if (id == 0) return Local<Value>();
+
+  // Messages to a terminated worker are dropped, but their buffers are still
+  // transferred.
+  std::unique_ptr<Message> message =
+      Serialize(isolate_, cb_info[0], cb_info[1]);
+
+  if (!message) return Local<Value>();
+
+  const auto it = workers_.find(id);
+  if (it != workers_.end()) {
+    Worker& worker = *it->second;
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.inbox.push_back(std::move(message));
+    worker.message_posted.notify_one();
+  }
+
+  return v8::Undefined(isolate_);
+}
+
+Local<Value> Workers::Terminate(
+    const v8::FunctionCallbackInfo<Value>& cb_info) {
+  const uint32 id = GetWorkerId(cb_info);
+  if (id == 0) return Local<Value>();
+
+  TerminateWorker(id);
+  return v8::Undefined(isolate_);
+}
+
+uint32 Workers::GetWorkerId(const v8::FunctionCallbackInfo<Value>& cb_info) {
+  Local<Value> id;
+  if (!cb_info.This()
+          ->GetPrivate(
+              isolate_->GetCurrentContext(),
+              Local<v8::Private>::New(isolate_, id_key_))
+          .ToLocal(&id) ||
+      !id->IsUint32()) {
+    ThrowError(isolate_, "The receiver is not a Worker.");
+    return 0;
+  }
+
+  return id.As<v8::Uint32>()->Value();
+}
+
+void Workers::TerminateWorker(const uint32 id) {
+  const auto it = workers_.find(id);
+  if (it == workers_.end()) return;
+
+  const std::unique_ptr<Worker> worker = std::move(it->second);
+  workers_.erase(it);
+
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->terminating = true;
+    if (worker->isolate) worker->isolate->TerminateExecution();
+    worker->message_posted.notify_one();
+  }
+
+  worker->thread.join();
+  event_loop_->RemoveTaskSource();
+}
+
+Local<Function> Workers::AddFunction(
+    const char* name,
+    const V8FunctionCallback& callback) {
+  callbacks_.emplace_back(new V8FunctionCallback(callback));
+  return MakeFunction(isolate_, name, callbacks_.back().get());
+}
+
+}  // namespace gjstest
@@ -0,0 +1,189 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A minimal implementation of Web Workers, for testing code that runs in
+// parallel.
+
+#ifndef GJSTEST_INTERNAL_CPP_WORKERS_H_
+#define GJSTEST_INTERNAL_CPP_WORKERS_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <v8.h>
+
+#include "base/integral_types.h"
+#include "base/macros.h"
+#include "gjstest/internal/cpp/v8_utils.h"
+
+namespace gjstest {
+
+class EventLoop;
+class HeapGuard;
+
+// Installs a Worker constructor in a context, used as follows:
+//
+//     var worker = new Worker('path/to/worker.js');
+//     worker.onmessage = function(event) { ... event.data ... };
+//     worker.postMessage(value, [transferable, ...]);
+//     worker.terminate();
+//
+// Each worker runs the script at the supplied path, which is relative to the
+// current directory like --js_files, in an isolate of its own on a thread of
+// its own. The script's global scope has self, postMessage, close and
+// onmessage, but none of gjstest's functions or timers.
+//
+// Messages are structured clones written by v8::ValueSerializer. ArrayBuffers
+// in the transfer list are moved rather than copied, and SharedArrayBuffers
+// are shared, so that Atomics work across threads. Every isolate uses the same
+// array buffer allocator, so backing stores can change hands. The memory of a
+// SharedArrayBuffer that has been shared is kept until the Workers object is
+// destroyed.
+//
+// Messages from a worker are delivered to its onmessage by the event loop, as
+// part of the test that created the worker, and exceptions the worker doesn't
+// catch fail that test. A test's workers are terminated when it ends.
+//
+// Worker isolates have the same resource constraints as the main one. A worker
+// that nearly exhausts its heap is terminated, failing the test that created
+// it, rather than taking the whole process down.
+class Workers {
+ public:
+  // Install the constructor in the supplied context. The object must outlive
+  // any use of it, and the event loop must outlive the object.
+  Workers(
+      v8::Isolate* isolate,
+      v8::Local<v8::Context> context,
+      EventLoop* event_loop,
+      const std::shared_ptr<v8::ArrayBuffer::Allocator>& allocator,
+      const v8::ResourceConstraints& constraints);
+
+  // Terminate any workers still running.
+  ~Workers();
+
+  // Terminate the workers created by the supplied test environment.
+  void DiscardTest(v8::Local<v8::Value> test_environment);
+
+ private:
+  struct Message;
+  struct Worker;
+  class SerializerDelegate;
+  class DeserializerDelegate;
+
+  // Serialize a message in the supplied isolate, moving the ArrayBuffers in
+  // the transfer list, which may be undefined. Return NULL, having thrown an
+  // exception, if that fails. May be called from any thread.
+  std::unique_ptr<Message> Serialize(
+      v8::Isolate* isolate,
+      v8::Local<v8::Value> value,
+      v8::Local<v8::Value> transfer_list);
+
+  // Deserialize a message in the supplied isolate, which takes ownership of
+  // any buffers transferred with it. May be called from any thread.
+  v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate, Message* message);
+
+  // Return the memory of a SharedArrayBuffer, taking ownership of it if no
+  // isolate has given it up yet. May be called from any thread.
+  std::pair<void*, size_t> ShareMemory(
+      v8::Local<v8::SharedArrayBuffer> buffer);
+
+  // The body of a worker's thread, and the part of it that runs with the
+  // worker's isolate entered.
+  void RunWorker(Worker* worker);
+  void RunWorkerScript(Worker* worker, v8::Isolate* isolate);
+
+  // Report the exception that stopped a script in a worker, as caught by the
+  // supplied TryCatch. If the script was terminated because the worker nearly
+  // exhausted its heap, report that instead, and if it was terminated for any
+  // other reason, report nothing. Return false if the script was terminated,
+  // in which case the worker must stop.
+  bool ReportException(
+      Worker* worker,
+      v8::Isolate* isolate,
+      const v8::TryCatch& try_catch,
+      HeapGuard* heap_guard);
+
+  // Wait for the next message to a worker, returning NULL if the worker is
+  // being terminated.
+  std::unique_ptr<Message> WaitForMessage(Worker* worker);
+
+  // postMessage and close in a worker's global scope.
+  v8::Local<v8::Value> PostToMain(
+      Worker* worker,
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> Close(
+      Worker* worker,
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Tasks that worker threads post to the event loop. They do nothing if the
+  // worker with the supplied ID has since been terminated.
+  void DeliverMessage(uint32 id, const std::shared_ptr<Message>& message);
+  void ReportWorkerError(uint32 id, const std::string& message);
+  void OnWorkerExit(uint32 id);
+
+  // The constructor, and the methods of Worker.prototype.
+  v8::Local<v8::Value> NewWorker(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> PostToWorker(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  v8::Local<v8::Value> Terminate(
+      const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Return the ID of the worker that is the receiver of a method, or zero,
+  // having thrown an exception, if the receiver isn't a worker.
+  uint32 GetWorkerId(const v8::FunctionCallbackInfo<v8::Value>& cb_info);
+
+  // Stop the thread of the worker with the supplied ID, if it's still running,
+  // and forget about the worker.
+  void TerminateWorker(uint32 id);
+
+  // Create a function wrapping the supplied callback.
+  v8::Local<v8::Function> AddFunction(
+      const char* name,
+      const V8FunctionCallback& callback);
+
+  v8::Isolate* const isolate_;
+  const v8::Global<v8::Context> context_;
+  EventLoop* const event_loop_;
+  const std::shared_ptr<v8::ArrayBuffer::Allocator> allocator_;
+  const v8::ResourceConstraints constraints_;
+
+  // The private property under which Worker objects record their IDs.
+  v8::Global<v8::Private> id_key_;
+
+  // The workers not yet terminated, by ID.
+  std::unordered_map<uint32, std::unique_ptr<Worker>> workers_;
+  uint32 next_worker_id_ = 1;
+
+  // The memory of the SharedArrayBuffers that have been shared, guarded by
+  // shared_memory_mutex_.
+  std::mutex shared_memory_mutex_;
+  std::vector<std::pair<void*, size_t>> shared_memory_;
+
+  // The callbacks wrapped by the functions.
+  std::vector<std::unique_ptr<V8FunctionCallback>> callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(Workers);
+};
+
+}  // namespace gjstest
+
+#endif  // GJSTEST_INTERNAL_CPP_WORKERS_H_
@@ -0,0 +1,144 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A test file containing tests that return promises, for use by
+// integration_test.cc. It expects to be run with --async_test_timeout_ms=1000.
+
+// Return a promise that is fulfilled with the supplied value after the
+// supplied number of milliseconds.
+function after(ms, value) {
+  return new Promise(function(resolve) {
+    setTimeout(resolve, ms, value);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////
+// A suite of asynchronous tests that can run at the same time
+////////////////////////////////////////////////////////////////////////
+
+function AsyncTest() {
+  ++AsyncTest.running;
+  AsyncTest.maxRunning = Math.max(AsyncTest.maxRunning, AsyncTest.running);
+}
+gjstest.registerTestSuite(AsyncTest);
+
+AsyncTest.running = 0;
+AsyncTest.maxRunning = 0;
+
+AsyncTest.prototype.tearDown = function() {
+  --AsyncTest.running;
+};
+
+AsyncTest.prototype.ResolvesAfterTimeout = async function() {
+  expectEq('taco', await after(50, 'taco'));
+};
+
+AsyncTest.prototype.FailsAfterAwait = async function() {
+  await after(20);
+  gjstest.log('Resumed FailsAfterAwait.');
+  expectEq('taco', 'burrito');
+};
+
+AsyncTest.prototype.PassesWhileOthersFail = async function() {
+  await after(10);
+  gjstest.log('Resumed PassesWhileOthersFail.');
+  await after(30);
+  expectEq('burrito', 'burrito');
+};
+
+AsyncTest.prototype.RejectsAfterAwait = function() {
+  return after(10).then(function() {
+    throw new Error('Taco shortage.');
+  });
+};
+
+AsyncTest.prototype.FailsInTimerCallback = function() {
+  return new Promise(function(resolve) {
+    setTimeout(function() {
+      expectEq('enchilada', 'taco');
+      resolve();
+    }, 5);
+  });
+};
+
+AsyncTest.prototype.Synchronous = function() {
+  expectEq(4, 2 + 2);
+};
+
+// Make sure that the tests above overlapped, by a suite that runs after them.
+function AfterAsyncTest() {}
+gjstest.registerTestSuite(AfterAsyncTest);
+
+AfterAsyncTest.prototype.RanConcurrently = function() {
+  expectGt(AsyncTest.maxRunning, 1);
+  expectEq(0, AsyncTest.running);
+};
+
+////////////////////////////////////////////////////////////////////////
+// A suite with an asynchronous tearDown method
+////////////////////////////////////////////////////////////////////////
+
+function AsyncTearDownTest() {
+  this.state_ = 'constructed';
+}
+gjstest.registerTestSuite(AsyncTearDownTest);
+
+AsyncTearDownTest.prototype.tearDown = async function() {
+  gjstest.log('Tearing down once ' + this.state_ + '.');
+  await after(5);
+  gjstest.log('Finished tearing down.');
+};
+
+AsyncTearDownTest.prototype.WaitsForTest = async function() {
+  await after(5);
+  this.state_ = 'settled';
+};
+
+////////////////////////////////////////////////////////////////////////
+// Tests that never finish
+////////////////////////////////////////////////////////////////////////
+
+function NeverSettlesTest() {}
+gjstest.registerTestSuite(NeverSettlesTest);
+
+NeverSettlesTest.prototype.ReturnsPendingPromise = function() {
+  return new Promise(function() {});
+};
+
+function TimeoutTest() {}
+gjstest.registerTestSuite(TimeoutTest);
+
+TimeoutTest.timerFired = false;
+
+// Timers run on virtual time, so this test's interval keeps it busy without
+// its clock ever reaching its timeout, until it's failed for taking too long
+// in real time.
+TimeoutTest.prototype.TakesTooLong = function() {
+  setInterval(function() {}, 10);
+  setTimeout(function() {
+    TimeoutTest.timerFired = true;
+  }, 1e12);
+
+  return new Promise(function() {});
+};
+
+// The timers of a test that times out are cancelled. Had they not been, this
+// test's clock would never catch up with the interval above.
+function AfterTimeoutTest() {}
+gjstest.registerTestSuite(AfterTimeoutTest);
+
+AfterTimeoutTest.prototype.TimerDidNotFire = async function() {
+  await after(2e12);
+  expectFalse(TimeoutTest.timerFired);
+};
@@ -0,0 +1,42 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A test file containing tests that allocate without bound, for use by
+// integration_test.cc with a small heap limit.
+
+function HeapExhaustionTest() {}
+gjstest.registerTestSuite(HeapExhaustionTest);
+
+HeapExhaustionTest.prototype.AllocatesForever = function() {
+  var chunks = [];
+  while (true) {
+    chunks.push(new Array(1 << 16).join('x'));
+  }
+};
+
+// A worker that allocates without bound is terminated, failing the test. The
+// worker never replies, so the test's promise never settles either.
+HeapExhaustionTest.prototype.WorkerAllocatesForever = function() {
+  var worker =
+      new Worker('gjstest/internal/integration_tests/workers/worker.js');
+  worker.postMessage({ command: 'allocate' });
+
+  return new Promise(function(resolve) {
+    worker.onmessage = resolve;
+  });
+};
+
+HeapExhaustionTest.prototype.RunsAfterwards = function() {
+  expectEq(2, 1 + 1);
+};
@@ -39,6 +39,7 @@ DEFINE_bool(dump_new, false,
             "If true, new golden files will be written out whenever an existing"
             "one doesn't match.");
 
+using testing::ContainsRegex;
 using testing::HasSubstr;
 using testing::Not;
 
@@ -93,6 +94,7 @@ static bool RunTool(
     const string& data_dir,
     const std::vector<string>& js_files,
     const string& filter,
+    const string& extra_flags,
     bool* success,
     string* output,
     string* xml) {
@@ -107,12 +109,14 @@ static bool RunTool(
               " --js_files=\"%s\""
               " --xml_output_file=\"%s\""
               " --data_dir=\"%s\""
-              " --filter=\"%s\"",
+              " --filter=\"%s\""
+              " %s",
           gjstest_binary.c_str(),
           JoinStrings(js_files, ",").c_str(),
           xml_file.c_str(),
           data_dir.c_str(),
-          filter.c_str());
+          filter.c_str(),
+          extra_flags.c_str());
 
   // Call the command.
   int exit_code;
@@ -135,7 +139,10 @@ static string PathToDataFile(const string& file_name) {
 
 class IntegrationTest : public ::testing::Test {
  protected:
-  bool RunBundleNamed(const string& name, string test_filter = "") {
+  bool RunBundleNamed(
+      const string& name,
+      string test_filter = "",
+      string extra_flags = "") {
     // Get a list of user scripts to load. Special case: the test
     // 'syntax_error' is meant to simulate a syntax error in a dependency.
     std::vector<string> js_files;
@@ -155,6 +162,38 @@ class IntegrationTest : public ::testing::Test {
             FLAGS_data_dir,
             js_files,
             test_filter,
+            extra_flags,
+            &success,
+            &txt_,
+            &xml_))
+        << "Could not run the gjstest binary.";
+
+    return success;
+  }
+
+  // Run the supplied comma-separated ES modules from the modules directory,
+  // which is also used as the module root.
+  bool RunModules(const string& modules, const string& extra_flags = "") {
+    const string root = PathToDataFile("modules");
+
+    std::vector<string> paths;
+    SplitStringUsing(modules, ",", &paths);
+    for (string& path : paths) {
+      path = root + "/" + path;
+    }
+
+    bool success = false;
+    CHECK(
+        RunTool(
+            FLAGS_gjstest_binary,
+            FLAGS_data_dir,
+            std::vector<string>(),
+            "",
+            StringPrintf(
+                "--js_modules=\"%s\" --module_root=\"%s\" %s",
+                JoinStrings(paths, ",").c_str(),
+                root.c_str(),
+                extra_flags.c_str()),
             &success,
             &txt_,
             &xml_))
@@ -212,6 +251,15 @@ TEST_F(IntegrationTest, SyntaxError) {
   EXPECT_TRUE(CheckGoldenFile("syntax_error.golden.xml", xml_));
 }
 
+TEST_F(IntegrationTest, SyntaxErrorWithoutLookahead) {
+  // Compiling each script only when it's needed should give the same result as
+  // compiling ahead in the background.
+  EXPECT_FALSE(
+      RunBundleNamed("syntax_error", "", "--compile_lookahead=0")) << txt_;
+  EXPECT_TRUE(CheckGoldenFile("syntax_error.golden.txt", txt_));
+  EXPECT_TRUE(CheckGoldenFile("syntax_error.golden.xml", xml_));
+}
+
 TEST_F(IntegrationTest, ExceptionDuringTest) {
   EXPECT_FALSE(RunBundleNamed("exception")) << txt_;
   EXPECT_TRUE(CheckGoldenFile("exception.golden.txt", txt_));
@@ -230,6 +278,43 @@ TEST_F(IntegrationTest, TestRegistration) {
   EXPECT_TRUE(CheckGoldenFile("registration.golden.xml", xml_));
 }
 
+TEST_F(IntegrationTest, SuiteHooks) {
+  EXPECT_FALSE(RunBundleNamed("suite_hooks")) << txt_;
+
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] SharedFixtureTest.setUpSuite"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] SharedFixtureTest.UsesFixture"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] SharedFixtureTest.UsesFixtureAgain"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] SharedFixtureTest.tearDownSuite"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] AfterSharedFixtureTest.WasTornDown"));
+
+  // When the set-up fails, the tests are skipped but the tear-down isn't.
+  EXPECT_THAT(txt_, HasSubstr("Fixture is unavailable."));
+  EXPECT_THAT(txt_, HasSubstr("[  FAILED  ] FailingSetUpTest.setUpSuite"));
+  EXPECT_THAT(txt_, Not(HasSubstr("NeverRuns")));
+  EXPECT_THAT(txt_, HasSubstr("Tearing down FailingSetUpTest."));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] FailingSetUpTest.tearDownSuite"));
+
+  EXPECT_THAT(
+      xml_,
+      HasSubstr("<testcase name=\"FailingSetUpTest.setUpSuite\""));
+}
+
+TEST_F(IntegrationTest, FilteredSuiteHooks) {
+  // The hooks of suites none of whose tests run shouldn't be run either.
+  ASSERT_TRUE(RunBundleNamed("suite_hooks", "SharedFixtureTest.UsesFixture"))
+      << txt_;
+
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] SharedFixtureTest.setUpSuite"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] SharedFixtureTest.UsesFixture"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] SharedFixtureTest.tearDownSuite"));
+  EXPECT_THAT(txt_, Not(HasSubstr("UsesFixtureAgain")));
+  EXPECT_THAT(txt_, Not(HasSubstr("FailingSetUpTest")));
+}
+
 TEST_F(IntegrationTest, FilteredFailingTest) {
   // Run only the passing tests.
   ASSERT_TRUE(RunBundleNamed("failing", ".*PassingTest.*")) << txt_;
@@ -244,6 +329,201 @@ TEST_F(IntegrationTest, NoMatchingTests) {
   EXPECT_THAT(txt_, HasSubstr("No tests found."));
 }
 
+TEST_F(IntegrationTest, HeapExhaustion) {
+  EXPECT_FALSE(
+      RunBundleNamed("heap_exhaustion", "", "--max_old_space_mb=32")) << txt_;
+
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("Terminated after nearly exhausting the JS heap limit"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[  FAILED  ] HeapExhaustionTest.AllocatesForever"));
+
+  // Workers get the same heap limit, and are stopped in the same way.
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "Worker terminated after nearly exhausting the JS heap limit of "
+          "32 MB"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[  FAILED  ] HeapExhaustionTest.WorkerAllocatesForever"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] HeapExhaustionTest.RunsAfterwards"));
+}
+
+TEST_F(IntegrationTest, AsyncTests) {
+  EXPECT_FALSE(
+      RunBundleNamed("async", "", "--async_test_timeout_ms=1000")) << txt_;
+
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] AsyncTest.ResolvesAfterTimeout"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] AsyncTest.Synchronous"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] AfterAsyncTest.RanConcurrently"));
+
+  // Failures reported after an await or in a timer callback are attributed to
+  // the right test, even though other tests were running at the same time.
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] AsyncTest.FailsAfterAwait\n"
+          "Resumed FailsAfterAwait.\n"
+          "Expected: 'taco'\n"
+          "Actual:   'burrito'\n"));
+  EXPECT_THAT(txt_, HasSubstr("[  FAILED  ] AsyncTest.FailsAfterAwait"));
+
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] AsyncTest.PassesWhileOthersFail\n"
+          "Resumed PassesWhileOthersFail.\n"
+          "[       OK ] AsyncTest.PassesWhileOthersFail"));
+
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] AsyncTest.RejectsAfterAwait\n"
+          "Error: Taco shortage."));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] AsyncTest.FailsInTimerCallback\n"
+          "Expected: 'enchilada'"));
+
+  // tearDown runs once the test's promise has settled, and is waited for.
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "Tearing down once settled.\n"
+          "Finished tearing down.\n"
+          "[       OK ] AsyncTearDownTest.WaitsForTest"));
+
+  // Tests that can't finish are failed, and their timers cancelled.
+  EXPECT_THAT(txt_, HasSubstr("never settled"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[  FAILED  ] NeverSettlesTest.ReturnsPendingPromise"));
+  EXPECT_THAT(txt_, HasSubstr("didn't settle within 1000 ms"));
+  EXPECT_THAT(txt_, HasSubstr("[  FAILED  ] TimeoutTest.TakesTooLong"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] AfterTimeoutTest.TimerDidNotFire"));
+}
+
+TEST_F(IntegrationTest, AsyncTestsOneAtATime) {
+  EXPECT_FALSE(
+      RunBundleNamed(
+          "async",
+          "",
+          "--async_test_timeout_ms=1000 --async_test_concurrency=1")) << txt_;
+
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] AsyncTest.PassesWhileOthersFail"));
+  EXPECT_THAT(txt_, HasSubstr("[  FAILED  ] AfterAsyncTest.RanConcurrently"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] AfterTimeoutTest.TimerDidNotFire"));
+}
+
+TEST_F(IntegrationTest, Workers) {
+  EXPECT_FALSE(
+      RunBundleNamed("workers", "", "--async_test_timeout_ms=1000")) << txt_;
+
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] WorkerTest.EchoesMessages"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] WorkerTest.TransfersArrayBuffers"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] WorkerTest.SharesMemory"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] WorkerTest.RejectsBadTransferLists"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] WorkerTest.IgnoresMessagesOnceTerminated"));
+
+  // Exceptions thrown by a worker fail the test that created it.
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] WorkerTest.UncaughtException\n"
+          "Error: Uncaught exception in worker: "
+          "gjstest/internal/integration_tests/workers/worker.js:47: "
+          "Error: Taco overflow."));
+  EXPECT_THAT(txt_, HasSubstr("[  FAILED  ] WorkerTest.UncaughtException"));
+
+  // Workers are terminated when their tests end, and waited for until then.
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] WorkerTest.LeavesWorkerSpinning"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] WorkerTest.NeverReplies\n"
+          "The promise returned by the test didn't settle within 1000 ms."));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "[ RUN      ] WorkerTest.WaitsForClosedWorker\n"
+          "The promise returned by the test never settled"));
+  EXPECT_THAT(txt_, HasSubstr("[       OK ] AfterWorkerTest.Runs"));
+}
+
+TEST_F(IntegrationTest, Modules) {
+  EXPECT_FALSE(RunModules("modules_test.js,modules_other_test.js")) << txt_;
+
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] FirstModuleTest.SharesImportedModules"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr(
+          "Expected: 1\n"
+          "Actual:   4\n"
+          "        at modules_test.js:"));
+  EXPECT_THAT(txt_, HasSubstr("[  FAILED  ] FirstModuleTest.Fails"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] OtherModuleTest.ResolvesSpecifiersToOneModule"));
+}
+
+TEST_F(IntegrationTest, ModulesWithoutLookahead) {
+  EXPECT_FALSE(
+      RunModules(
+          "modules_test.js,modules_other_test.js",
+          "--compile_lookahead=0")) << txt_;
+
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] FirstModuleTest.SharesImportedModules"));
+  EXPECT_THAT(
+      txt_,
+      HasSubstr("[       OK ] OtherModuleTest.ResolvesSpecifiersToOneModule"));
+}
+
+TEST_F(IntegrationTest, MissingModule) {
+  EXPECT_FALSE(RunModules("missing_import_test.js")) << txt_;
+  EXPECT_THAT(
+      txt_,
+      ContainsRegex(
+          "Cannot find module './lib/missing.js' imported by "
+          "[^\\n]*/missing_import_test.js"));
+}
+
+TEST_F(IntegrationTest, StatsOutput) {
+  const string stats_file = tmpnam(NULL);
+  PCHECK(!stats_file.empty());
+
+  ASSERT_TRUE(
+      RunBundleNamed("passing", "", "--stats_output_file=" + stats_file))
+      << txt_;
+
+  const string stats = ReadFileOrDie(stats_file);
+  EXPECT_THAT(stats, ContainsRegex("<run [^>]*scriptsCompiled=\"[1-9]"));
+  EXPECT_THAT(
+      stats,
+      ContainsRegex(
+          "<testcase name=\"PassingTest.UserErrors\"[^>]*"
+          " expectThatCalls=\"9\""));
+}
+
 }  // namespace gjstest
 
 int main(int argc, char **argv) {
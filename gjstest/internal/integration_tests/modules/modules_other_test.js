@@ -0,0 +1,29 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Imports the same module by each kind of specifier.
+
+import * as counter from './lib/counter.js';
+import * as counterFromRoot from '/lib/counter.js';
+import * as counterFromParent from '../modules/lib/counter.js';
+
+counter.increment();
+
+function OtherModuleTest() {}
+gjstest.registerTestSuite(OtherModuleTest);
+
+OtherModuleTest.prototype.ResolvesSpecifiersToOneModule = function() {
+  expectTrue(counter === counterFromRoot);
+  expectTrue(counter === counterFromParent);
+};
@@ -0,0 +1,34 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// An ES module for use by integration_test.cc, which runs it with
+// modules_other_test.js and --module_root set to this directory.
+
+import {getCount, increment} from './lib/counter.js';
+import {incrementTwice} from 'lib/twice.js';
+
+incrementTwice();
+
+function FirstModuleTest() {}
+gjstest.registerTestSuite(FirstModuleTest);
+
+FirstModuleTest.prototype.SharesImportedModules = function() {
+  // This module's import and the other test module's import of the counter
+  // module are the same instance, whose state both have changed.
+  expectEq(3, getCount());
+};
+
+FirstModuleTest.prototype.Fails = function() {
+  expectEq(1, increment());
+};
@@ -0,0 +1,78 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A test file containing suites with setUpSuite and tearDownSuite hooks, for
+// use by integration_test.cc.
+
+////////////////////////////////////////////////////////////////////////
+// A suite whose fixture is shared by its tests
+////////////////////////////////////////////////////////////////////////
+
+function SharedFixtureTest() {}
+gjstest.registerTestSuite(SharedFixtureTest);
+
+SharedFixtureTest.setUps = 0;
+SharedFixtureTest.tearDowns = 0;
+
+SharedFixtureTest.setUpSuite = function() {
+  ++this.setUps;
+  this.table = {taco: 1, burrito: 2};
+};
+
+SharedFixtureTest.tearDownSuite = function() {
+  ++this.tearDowns;
+  this.table = null;
+};
+
+SharedFixtureTest.prototype.UsesFixture = function() {
+  expectEq(1, SharedFixtureTest.setUps);
+  expectEq(0, SharedFixtureTest.tearDowns);
+  expectEq(1, SharedFixtureTest.table.taco);
+};
+
+SharedFixtureTest.prototype.UsesFixtureAgain = function() {
+  expectEq(1, SharedFixtureTest.setUps);
+  expectEq(0, SharedFixtureTest.tearDowns);
+  expectEq(2, SharedFixtureTest.table.burrito);
+};
+
+// Make sure the fixture was torn down exactly once, by a suite that runs after
+// the one above.
+function AfterSharedFixtureTest() {}
+gjstest.registerTestSuite(AfterSharedFixtureTest);
+
+AfterSharedFixtureTest.prototype.WasTornDown = function() {
+  expectEq(1, SharedFixtureTest.setUps);
+  expectEq(1, SharedFixtureTest.tearDowns);
+  expectEq(null, SharedFixtureTest.table);
+};
+
+////////////////////////////////////////////////////////////////////////
+// A suite whose set-up fails
+////////////////////////////////////////////////////////////////////////
+
+function FailingSetUpTest() {}
+gjstest.registerTestSuite(FailingSetUpTest);
+
+FailingSetUpTest.setUpSuite = function() {
+  throw new Error('Fixture is unavailable.');
+};
+
+FailingSetUpTest.tearDownSuite = function() {
+  gjstest.log('Tearing down FailingSetUpTest.');
+};
+
+FailingSetUpTest.prototype.NeverRuns = function() {
+  expectEq('taco', 'burrito');
+};
@@ -19,7 +19,7 @@ $(eval $(call cc_binary, \
 
 INT_TEST_ARGS =
 
-gjstest/internal/integration_tests/integration_test.out : gjstest/internal/integration_tests/integration_test.bin scripts/cc_test_run.sh share gjstest/internal/cpp/gjstest.bin gjstest/internal/integration_tests/*.js gjstest/internal/integration_tests/*.golden.txt gjstest/internal/integration_tests/*.golden.xml
+gjstest/internal/integration_tests/integration_test.out : gjstest/internal/integration_tests/integration_test.bin scripts/cc_test_run.sh share gjstest/internal/cpp/gjstest.bin gjstest/internal/integration_tests/*.js gjstest/internal/integration_tests/modules/*.js gjstest/internal/integration_tests/modules/lib/*.js gjstest/internal/integration_tests/workers/*.js gjstest/internal/integration_tests/*.golden.txt gjstest/internal/integration_tests/*.golden.xml
 	./scripts/cc_test_run.sh gjstest/internal/integration_tests/integration_test --test_srcdir=gjstest/internal/integration_tests --data_dir=share/gjstest --gjstest_binary=gjstest/internal/cpp/gjstest.bin $(INT_TEST_ARGS)
 
 CC_TESTS += gjstest/internal/integration_tests/integration_test.out
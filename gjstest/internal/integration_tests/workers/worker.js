@@ -0,0 +1,62 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A worker script for workers_test.js, which carries out the commands it's
+// sent.
+
+self.onmessage = function(event) {
+  var message = event.data;
+
+  switch (message.command) {
+    case 'echo':
+      postMessage(message.value);
+      break;
+
+    // Add up the bytes of a transferred buffer, then hand it back.
+    case 'sum':
+      var bytes = new Uint8Array(message.buffer);
+      var sum = 0;
+      for (var i = 0; i < bytes.length; ++i) {
+        sum += bytes[i];
+      }
+
+      postMessage({ sum: sum, buffer: message.buffer }, [message.buffer]);
+      break;
+
+    // Increment a counter in shared memory.
+    case 'add':
+      for (var i = 0; i < message.times; ++i) {
+        Atomics.add(message.counter, 0, 1);
+      }
+
+      postMessage('done');
+      break;
+
+    case 'throw':
+      throw new Error('Taco overflow.');
+
+    case 'spin':
+      while (true) {}
+
+    case 'allocate':
+      var chunks = [];
+      while (true) {
+        chunks.push(new Array(1 << 16).join('x'));
+      }
+
+    case 'close':
+      close();
+      break;
+  }
+};
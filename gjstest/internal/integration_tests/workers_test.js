@@ -0,0 +1,135 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A test file containing tests that use workers, for use by
+// integration_test.cc. It expects to be run from the root of the source tree,
+// with --async_test_timeout_ms=1000.
+
+var WORKER_PATH = 'gjstest/internal/integration_tests/workers/worker.js';
+
+// Send the supplied message to a worker, returning a promise for its reply.
+function request(worker, message, transferList) {
+  return new Promise(function(resolve) {
+    worker.onmessage = function(event) { resolve(event.data); };
+    worker.postMessage(message, transferList);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////
+// Workers that do as they're told
+////////////////////////////////////////////////////////////////////////
+
+function WorkerTest() {
+  this.worker_ = new Worker(WORKER_PATH);
+}
+gjstest.registerTestSuite(WorkerTest);
+
+WorkerTest.prototype.EchoesMessages = async function() {
+  var value = { taco: [1, 'burrito', { enchilada: null }] };
+  var reply = await request(this.worker_, { command: 'echo', value: value });
+
+  expectThat(reply, recursivelyEquals(value));
+  expectNe(value, reply);
+};
+
+WorkerTest.prototype.TransfersArrayBuffers = async function() {
+  var buffer = new Uint8Array([1, 2, 3, 4]).buffer;
+  var reply =
+      await request(
+          this.worker_,
+          { command: 'sum', buffer: buffer },
+          [buffer]);
+
+  expectEq(0, buffer.byteLength);
+  expectEq(10, reply.sum);
+  expectThat(new Uint8Array(reply.buffer), elementsAre([1, 2, 3, 4]));
+};
+
+WorkerTest.prototype.SharesMemory = async function() {
+  var counter = new Int32Array(new SharedArrayBuffer(4));
+  var workers = [this.worker_];
+  for (var i = 1; i < 4; ++i) {
+    workers.push(new Worker(WORKER_PATH));
+  }
+
+  await Promise.all(
+      workers.map(function(worker) {
+        return request(
+            worker,
+            { command: 'add', counter: counter, times: 10000 });
+      }));
+
+  expectEq(40000, Atomics.load(counter, 0));
+};
+
+WorkerTest.prototype.RejectsBadTransferLists = function() {
+  var worker = this.worker_;
+  var buffer = new ArrayBuffer(4);
+
+  expectThat(
+      function() { worker.postMessage(buffer, [new Uint8Array(4)]); },
+      throwsError(/Only ArrayBuffers can be transferred/));
+
+  expectThat(
+      function() { worker.postMessage(buffer, [buffer, buffer]); },
+      throwsError(/transferred more than once/));
+
+  expectEq(4, buffer.byteLength);
+};
+
+WorkerTest.prototype.IgnoresMessagesOnceTerminated = function() {
+  var buffer = new ArrayBuffer(4);
+
+  this.worker_.postMessage({ command: 'spin' });
+  this.worker_.terminate();
+  this.worker_.postMessage(buffer, [buffer]);
+
+  expectEq(0, buffer.byteLength);
+};
+
+WorkerTest.prototype.UncaughtException = async function() {
+  this.worker_.postMessage({ command: 'throw' });
+
+  // The worker carries on, and its reply arrives after the error.
+  expectEq(
+      'taco',
+      await request(this.worker_, { command: 'echo', value: 'taco' }));
+};
+
+// Workers still running when their test ends are terminated, so the runner
+// moves on.
+WorkerTest.prototype.LeavesWorkerSpinning = function() {
+  this.worker_.postMessage({ command: 'spin' });
+};
+
+// A test waiting for a worker that will never reply times out, while one
+// waiting for a worker that has closed fails straight away.
+WorkerTest.prototype.NeverReplies = function() {
+  return request(this.worker_, { command: 'ignore' });
+};
+
+WorkerTest.prototype.WaitsForClosedWorker = function() {
+  return request(this.worker_, { command: 'close' });
+};
+
+////////////////////////////////////////////////////////////////////////
+// A test that runs after the others
+////////////////////////////////////////////////////////////////////////
+
+function AfterWorkerTest() {}
+gjstest.registerTestSuite(AfterWorkerTest);
+
+AfterWorkerTest.prototype.Runs = function() {
+  expectEq(4, 2 + 2);
+};
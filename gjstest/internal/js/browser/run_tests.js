@@ -28,24 +28,46 @@ gjstest.internal.runTestsInBrowser = function(pageTitle) {
   // test suite and case objects.
   var testSuites = {};
   var allCases = [];
-  for (var i = 0; i < gjstest.internal.testSuites.length; ++i) {
-    var suiteConstructor = gjstest.internal.testSuites[i];
-    var suiteName = suiteConstructor.name;
+  var suiteInfos = gjstest.internal.listTestSuites();
+  for (var i = 0; i < suiteInfos.length; ++i) {
+    var suiteInfo = suiteInfos[i];
+    var suiteName = suiteInfo.name;
 
     var browserSuite = new gjstest.internal.browser.TestSuite(suiteName);
     testSuites[suiteName] = browserSuite;
 
-    // Get all of the test functions for this suite.
-    var testFunctions = gjstest.internal.getTestFunctions(suiteConstructor);
-    for (var fullName in testFunctions) {
-      var testFn = testFunctions[fullName];
-      var caseName = gjstest.internal.browser.subtractSuiteName_(suiteName,
-                                                              fullName);
-      var enabled = !filter || caseName.match(filter);
-      var testCase = new gjstest.internal.browser.TestCase(
-          caseName, testFn, enabled);
-      browserSuite.addTestCase(testCase);
-      allCases.push(testCase);
+    // Create a case for each of the suite's tests, noting whether any of them
+    // will run.
+    var suiteCases = [];
+    var anyEnabled = false;
+    for (var j = 0; j < suiteInfo.testNames.length; ++j) {
+      var testFn = suiteInfo.testFunctions[j];
+      var caseName = gjstest.internal.browser.subtractSuiteName_(
+          suiteName,
+          suiteInfo.testNames[j]);
+      var enabled = !filter || !!caseName.match(filter);
+      anyEnabled = anyEnabled || enabled;
+      suiteCases.push(new gjstest.internal.browser.TestCase(
+          caseName, testFn, enabled));
+    }
+
+    // Surround them with cases for the suite-level hooks, which run only if
+    // one of the tests does. If setUpSuite fails, the tests are skipped.
+    if (suiteInfo.setUpSuite) {
+      var setUpCase = new gjstest.internal.browser.TestCase(
+          'setUpSuite', suiteInfo.setUpSuite, anyEnabled);
+      setUpCase.setDependentCases(suiteCases);
+      suiteCases.unshift(setUpCase);
+    }
+
+    if (suiteInfo.tearDownSuite) {
+      suiteCases.push(new gjstest.internal.browser.TestCase(
+          'tearDownSuite', suiteInfo.tearDownSuite, anyEnabled));
+    }
+
+    for (var j = 0; j < suiteCases.length; ++j) {
+      browserSuite.addTestCase(suiteCases[j]);
+      allCases.push(suiteCases[j]);
     }
   }
 
@@ -60,14 +82,15 @@ gjstest.internal.runTestsInBrowser = function(pageTitle) {
     var testCase = allCases.shift();
     if (!testCase) return;
     gjstest.internal.browser.runSoon_(function() {
-      var passed = testCase.run();
-      ++testsRun;
-      if (passed) ++testsPassed;
-      gjstest.internal.browser.updateStatus(testsRun,
-                                         testsPassed,
-                                         !allCases.length);
-      // Start the next test.
-      runOneTest();
+      testCase.run(function(passed) {
+        ++testsRun;
+        if (passed) ++testsPassed;
+        gjstest.internal.browser.updateStatus(testsRun,
+                                           testsPassed,
+                                           !allCases.length);
+        // Start the next test.
+        runOneTest();
+      });
     });
   };
   runOneTest();
@@ -220,6 +243,16 @@ gjstest.internal.browser.TestCase = function(testName, testFn, enabled) {
   this.enabled_ = enabled;
   this.logElem_ = null;
   this.headerElem_ = null;
+  this.dependentCases_ = [];
+};
+
+/**
+ * Set the cases that should be skipped if this one fails.
+ * @param {!Array.<!gjstest.internal.browser.TestCase>} testCases
+ */
+gjstest.internal.browser.TestCase.prototype.setDependentCases =
+    function(testCases) {
+  this.dependentCases_ = testCases.slice();
 };
 
 /**
@@ -245,14 +278,16 @@ gjstest.internal.browser.TestCase.prototype.renderDom = function() {
 };
 
 /**
- * Invoke this test case.
- * @returns {boolean} True if the test passed.
+ * Invoke this test case, waiting for it to finish if it's asynchronous.
+ * @param {function(boolean)} onDone  A function to call with true iff the test
+ *     passed, once it has finished.
  */
-gjstest.internal.browser.TestCase.prototype.run = function() {
+gjstest.internal.browser.TestCase.prototype.run = function(onDone) {
   var $ = gjstest.internal.HtmlBuilder;
   if (!this.enabled_) {
     this.headerElem_.addClass('skip');
-    return true;
+    onDone(true);
+    return;
   }
   this.headerElem_.addClass('running');
 
@@ -275,15 +310,51 @@ gjstest.internal.browser.TestCase.prototype.run = function() {
       new gjstest.internal.TestEnvironment(
           log,
           reportFailure,
-          gjstest.internal.getCurrentStack);
+          gjstest.internal.captureCurrentStack);
 
-  // Run the test.
+  // Run the test. Tests run one at a time here, so an asynchronous test's
+  // environment can stay current until it has finished.
+  var finished = null;
   try {
-    gjstest.internal.runTest(this.testFn_, testEnvironment);
+    finished = gjstest.internal.runTest(this.testFn_, testEnvironment);
   } catch (error) {
     testEnvironment.reportFailure(gjstest.stringify(error));
   }
 
+  var me = this;
+  var finish = function() {
+    onDone(me.recordResult_(failure));
+  };
+
+  if (!finished) {
+    finish();
+    return;
+  }
+
+  gjstest.internal.currentTestEnvironment = testEnvironment;
+  finished.then(finish, function(error) {
+    testEnvironment.reportFailure(gjstest.stringify(error));
+    finish();
+  });
+};
+
+/**
+ * Update the UI with the result of running this test case, and skip the cases
+ * that depend on it if it failed.
+ * @param {boolean} failure  True if the test failed.
+ * @returns {boolean} True if the test passed.
+ * @private
+ */
+gjstest.internal.browser.TestCase.prototype.recordResult_ = function(failure) {
+  var logElem = this.logElem_;
+
+  // Skip the cases that depend on this one if it failed.
+  if (failure) {
+    for (var i = 0; i < this.dependentCases_.length; ++i) {
+      this.dependentCases_[i].enabled_ = false;
+    }
+  }
+
   // Update the UI with the result.
   var className = failure ? 'fail' : 'pass';
   var status = failure ? 'FAILED' : 'PASSED';
@@ -192,6 +192,7 @@ gjstest.internal.checkArgsAgainstExpectation = function(args, expectation) {
     }
 
     // Check the argument (or missing argument sentinel) against the matcher.
+    ++gjstest.internal.stats.matcherPredicateCalls;
     var predicateResult = matcher.predicate(arg);
     if (predicateResult === false) {
       return "arg " + i + " didn't match";
@@ -0,0 +1,443 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Diffs of large strings and arrays, for failure messages that would otherwise
+// leave the user to hunt for the difference in a truncated description.
+
+/**
+ * Limits on the work done when computing a diff, after which the differing
+ * region is reported as a whole. The number of comparisons bounds the time
+ * taken, and the number of edits the memory used.
+ *
+ * @type {{maxEdits: number, maxComparisons: number}}
+ */
+gjstest.internal.diffBudget = {
+  maxEdits: 1000,
+  maxComparisons: 10000000
+};
+
+/**
+ * Describe how actual differs from expected, as a list of the differing
+ * regions, or return null if the values are too small or of the wrong types
+ * for that to be more useful than their descriptions. Strings containing new
+ * lines are compared line by line, other strings character by character, and
+ * arrays element by element.
+ *
+ * For example:
+ *
+ *     Differences (- expected, + actual):
+ *       - [120] 'foo'
+ *       + [120] 'bar'
+ *       + [121] 'baz'
+ *       ...
+ *       - [4012] 17
+ *
+ * @param {*} expected
+ * @param {*} actual
+ * @return {?string}
+ */
+gjstest.internal.describeDiff = function(expected, actual) {
+  var lines;
+
+  if (typeof(expected) == 'string' && typeof(actual) == 'string') {
+    if (expected.indexOf('\n') != -1 || actual.indexOf('\n') != -1) {
+      lines = gjstest.internal.describeLineDiff_(
+          expected.split('\n'),
+          actual.split('\n'));
+    } else if (expected.length > 80 || actual.length > 80) {
+      lines = gjstest.internal.describeCharacterDiff_(expected, actual);
+    } else {
+      return null;
+    }
+  } else if (gjstest.internal.hasLength_(expected) &&
+             gjstest.internal.hasLength_(actual) &&
+             (expected.length > 25 || actual.length > 25)) {
+    lines = gjstest.internal.describeElementDiff_(expected, actual);
+  } else {
+    return null;
+  }
+
+  if (!lines || !lines.length) return null;
+  return 'Differences (- expected, + actual):\n  ' + lines.join('\n  ');
+};
+
+/**
+ * Compute the differing regions of the supplied sequences, using the native
+ * implementation when available.
+ *
+ * @param {(string|!Int32Array)} a
+ * @param {(string|!Int32Array)} b
+ *     Sequences of the same type.
+ *
+ * @return {{hunks: !Array.<!Array.<number>>, complete: boolean}}
+ */
+gjstest.internal.diffSequences = function(a, b) {
+  var natives = gjstest.internal.natives;
+  var computeDiff =
+      natives ? natives.computeDiff : gjstest.internal.computeDiff;
+
+  var budget = gjstest.internal.diffBudget;
+  return computeDiff(a, b, budget.maxEdits, budget.maxComparisons);
+};
+
+/**
+ * The JS implementation of gjstest.internal.diffSequences, used where the
+ * native one isn't available. The two must produce identical output.
+ *
+ * Each hunk is a maximal run of differences [aBegin, aEnd, bBegin, bEnd],
+ * meaning that elements [aBegin, aEnd) of a were replaced by elements
+ * [bBegin, bEnd) of b. Together they make up a shortest edit script, found with
+ * Myers' algorithm. If the budget runs out first, complete is false and there
+ * is a single hunk spanning everything between the common prefix and suffix.
+ *
+ * @param {(string|!Int32Array)} a
+ * @param {(string|!Int32Array)} b
+ * @param {number} maxEdits
+ * @param {number} maxComparisons
+ * @return {{hunks: !Array.<!Array.<number>>, complete: boolean}}
+ */
+gjstest.internal.computeDiff = function(a, b, maxEdits, maxComparisons) {
+  // Skip the common prefix and suffix.
+  var prefix = 0;
+  while (prefix < a.length && prefix < b.length && a[prefix] === b[prefix]) {
+    ++prefix;
+  }
+
+  var suffix = 0;
+  while (suffix < a.length - prefix &&
+         suffix < b.length - prefix &&
+         a[a.length - suffix - 1] === b[b.length - suffix - 1]) {
+    ++suffix;
+  }
+
+  var n = a.length - prefix - suffix;
+  var m = b.length - prefix - suffix;
+  var everything = {
+    hunks: [[prefix, prefix + n, prefix, prefix + m]],
+    complete: true
+  };
+
+  if (n == 0 && m == 0) return { hunks: [], complete: true };
+  if (n == 0 || m == 0) return everything;
+
+  // Myers' greedy algorithm. v[maxD + k] is the furthest x reached so far on
+  // diagonal k = x - y. trace holds a copy of v[maxD - d, maxD + d] after
+  // each round d, for walking the path backwards once the end is reached.
+  var maxD = Math.min(n + m, maxEdits);
+  var v = new Array(2 * maxD + 3);
+  for (var i = 0; i < v.length; ++i) v[i] = 0;
+  var trace = [];
+
+  var comparisons = 0;
+  for (var d = 0; d <= maxD; ++d) {
+    for (var k = -d; k <= d; k += 2) {
+      // Extend the furthest path on a neighbouring diagonal by one insertion
+      // or deletion, then follow the diagonal as far as it goes.
+      var x;
+      if (k == -d || (k != d && v[maxD + k - 1] < v[maxD + k + 1])) {
+        x = v[maxD + k + 1];
+      } else {
+        x = v[maxD + k - 1] + 1;
+      }
+
+      var xStart = x;
+      var y = x - k;
+      while (x < n && y < m && a[prefix + x] === b[prefix + y]) {
+        ++x;
+        ++y;
+      }
+
+      comparisons += x - xStart + 1;
+      v[maxD + k] = x;
+
+      if (x < n || y < m) continue;
+
+      // We've reached the end. Walk back through the rounds to find the
+      // edits that got us here.
+      var edits = [];
+      for (var backD = d; backD > 0; --backD) {
+        var prev = trace[backD - 1];
+        var prevOffset = backD - 1;
+        var backK = x - y;
+
+        var insertion =
+            backK == -backD ||
+            (backK != backD &&
+             prev[prevOffset + backK - 1] < prev[prevOffset + backK + 1]);
+        var prevK = insertion ? backK + 1 : backK - 1;
+        var prevX = prev[prevOffset + prevK];
+        var prevY = prevX - prevK;
+
+        edits.push([prevX, prevY, insertion]);
+        x = prevX;
+        y = prevY;
+      }
+
+      edits.reverse();
+      return {
+        hunks: gjstest.internal.makeHunks_(edits, prefix),
+        complete: true
+      };
+    }
+
+    if (comparisons > maxComparisons) break;
+    trace.push(v.slice(maxD - d, maxD + d + 1));
+  }
+
+  everything.complete = false;
+  return everything;
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Group the supplied edits [x, y, isInsertion], which must be in order, into
+ * hunks, offsetting them by the supplied amount.
+ *
+ * @param {!Array.<!Array>} edits
+ * @param {number} offset
+ * @return {!Array.<!Array.<number>>}
+ *
+ * @private
+ */
+gjstest.internal.makeHunks_ = function(edits, offset) {
+  var hunks = [];
+  var hunk = null;
+
+  for (var i = 0; i < edits.length; ++i) {
+    var x = offset + edits[i][0];
+    var y = offset + edits[i][1];
+
+    // Start a new hunk unless this edit begins where the last one ended.
+    if (!hunk || hunk[1] != x || hunk[3] != y) {
+      hunk = [x, x, y, y];
+      hunks.push(hunk);
+    }
+
+    if (edits[i][2]) {
+      ++hunk[3];
+    } else {
+      ++hunk[1];
+    }
+  }
+
+  return hunks;
+};
+
+/**
+ * Turn each of the supplied keys into a number, such that equal keys get
+ * equal numbers.
+ *
+ * @param {!Array.<string>} aKeys
+ * @param {!Array.<string>} bKeys
+ * @return {!Array.<!Int32Array>}
+ *
+ * @private
+ */
+gjstest.internal.tokenize_ = function(aKeys, bKeys) {
+  var tokens = {};
+  var nextToken = 0;
+
+  var tokenizeAll = function(keys) {
+    var result = new Int32Array(keys.length);
+    for (var i = 0; i < keys.length; ++i) {
+      // Prefix the keys so that they can't collide with built-in properties.
+      var key = '$' + keys[i];
+      if (!tokens.hasOwnProperty(key)) {
+        tokens[key] = nextToken++;
+      }
+
+      result[i] = tokens[key];
+    }
+
+    return result;
+  };
+
+  return [tokenizeAll(aKeys), tokenizeAll(bKeys)];
+};
+
+/**
+ * Return the lines of a diff whose hunks are described by the supplied
+ * function, which is given a hunk and an array to push lines to. Long diffs are
+ * truncated.
+ *
+ * @param {{hunks: !Array.<!Array.<number>>, complete: boolean}} diff
+ * @param {function(!Array.<number>, !Array.<string>)} describeHunk
+ * @return {!Array.<string>}
+ *
+ * @private
+ */
+gjstest.internal.describeHunks_ = function(diff, describeHunk) {
+  var kMaxHunks = 10;
+
+  var lines = [];
+  for (var i = 0; i < diff.hunks.length && i < kMaxHunks; ++i) {
+    if (i > 0) lines.push('...');
+    describeHunk(diff.hunks[i], lines);
+  }
+
+  if (diff.hunks.length > kMaxHunks) {
+    lines.push('(' + (diff.hunks.length - kMaxHunks) + ' more differences)');
+  }
+
+  if (!diff.complete) {
+    lines.push('(gave up looking for a smaller diff)');
+  }
+
+  return lines;
+};
+
+/**
+ * Push lines describing the elements in the range [begin, end) of one side of
+ * a hunk, with the supplied prefix, truncating long ranges.
+ *
+ * @param {!Array.<string>} lines
+ * @param {string} prefix
+ * @param {number} begin
+ * @param {number} end
+ * @param {function(number):string} describeElement
+ *
+ * @private
+ */
+gjstest.internal.pushRange_ = function(
+    lines,
+    prefix,
+    begin,
+    end,
+    describeElement) {
+  var kMaxElements = 10;
+
+  for (var i = begin; i < end && i < begin + kMaxElements; ++i) {
+    lines.push(prefix + describeElement(i));
+  }
+
+  if (end - begin > kMaxElements) {
+    lines.push(prefix + '(' + (end - begin - kMaxElements) + ' more)');
+  }
+};
+
+/**
+ * @param {!Array.<string>} expected
+ * @param {!Array.<string>} actual
+ * @return {!Array.<string>}
+ *
+ * @private
+ */
+gjstest.internal.describeLineDiff_ = function(expected, actual) {
+  var tokens = gjstest.internal.tokenize_(expected, actual);
+  var diff = gjstest.internal.diffSequences(tokens[0], tokens[1]);
+
+  // Number lines from one, as editors do.
+  return gjstest.internal.describeHunks_(diff, function(hunk, lines) {
+    gjstest.internal.pushRange_(lines, '- ', hunk[0], hunk[1], function(i) {
+      return 'line ' + (i + 1) + ': ' + expected[i];
+    });
+
+    gjstest.internal.pushRange_(lines, '+ ', hunk[2], hunk[3], function(i) {
+      return 'line ' + (i + 1) + ': ' + actual[i];
+    });
+  });
+};
+
+/**
+ * @param {*} obj
+ * @return {boolean}
+ *
+ * @private
+ */
+gjstest.internal.hasLength_ = function(obj) {
+  return !!obj && typeof(obj) == 'object' && typeof(obj.length) == 'number';
+};
+
+/**
+ * @param {{length: number}} expected
+ * @param {{length: number}} actual
+ * @return {Array.<string>}
+ *
+ * @private
+ */
+gjstest.internal.describeElementDiff_ = function(expected, actual) {
+  // Compare primitive elements by type and value, and others by their
+  // descriptions. Matchers can't be compared in this way, so don't try.
+  var keyAll = function(array) {
+    var result = [];
+    for (var i = 0; i < array.length; ++i) {
+      var element = array[i];
+      if (element instanceof gjstest.Matcher) return null;
+
+      result.push(
+          element instanceof Object ?
+              'object ' + gjstest.stringify(element) :
+              typeof(element) + ' ' + String(element));
+    }
+
+    return result;
+  };
+
+  var expectedKeys = keyAll(expected);
+  var actualKeys = keyAll(actual);
+  if (!expectedKeys || !actualKeys) return null;
+
+  var tokens = gjstest.internal.tokenize_(expectedKeys, actualKeys);
+  var diff = gjstest.internal.diffSequences(tokens[0], tokens[1]);
+
+  return gjstest.internal.describeHunks_(diff, function(hunk, lines) {
+    gjstest.internal.pushRange_(lines, '- ', hunk[0], hunk[1], function(i) {
+      return '[' + i + '] ' + gjstest.stringify(expected[i]);
+    });
+
+    gjstest.internal.pushRange_(lines, '+ ', hunk[2], hunk[3], function(i) {
+      return '[' + i + '] ' + gjstest.stringify(actual[i]);
+    });
+  });
+};
+
+/**
+ * @param {string} expected
+ * @param {string} actual
+ * @return {!Array.<string>}
+ *
+ * @private
+ */
+gjstest.internal.describeCharacterDiff_ = function(expected, actual) {
+  var kContext = 10;
+  var kMaxChars = 40;
+
+  var diff = gjstest.internal.diffSequences(expected, actual);
+
+  // Show each side of a hunk with some context, bracketing the part that
+  // differs. For example:
+  //
+  //     - [1234] ...abcdefghij[XY]klmnopqrst...
+  //     + [1234] ...abcdefghij[Z]klmnopqrst...
+  //
+  var describeSide = function(str, begin, end) {
+    var before = str.substring(Math.max(0, begin - kContext), begin);
+    var middle = str.substring(begin, Math.min(end, begin + kMaxChars));
+    var after = str.substr(end, kContext);
+
+    if (end - begin > kMaxChars) middle += '...';
+    if (begin > kContext) before = '...' + before;
+    if (end + kContext < str.length) after += '...';
+
+    return '[' + begin + '] ' + before + '[' + middle + ']' + after;
+  };
+
+  return gjstest.internal.describeHunks_(diff, function(hunk, lines) {
+    lines.push('- ' + describeSide(expected, hunk[0], hunk[1]));
+    lines.push('+ ' + describeSide(actual, hunk[2], hunk[3]));
+  });
+};
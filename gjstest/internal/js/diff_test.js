@@ -0,0 +1,349 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+var computeDiff = gjstest.internal.computeDiff;
+var describeDiff = gjstest.internal.describeDiff;
+
+////////////////////////////////////////////////////////////////////////
+// computeDiff
+////////////////////////////////////////////////////////////////////////
+
+function ComputeDiffTest() {}
+registerTestSuite(ComputeDiffTest);
+
+ComputeDiffTest.prototype.diff_ = function(a, b, opt_maxEdits) {
+  var maxEdits = opt_maxEdits === undefined ? 1000 : opt_maxEdits;
+  var result = computeDiff(a, b, maxEdits, 1e7);
+
+  // The native implementation must agree.
+  var natives = gjstest.internal.natives;
+  if (natives) {
+    expectThat(
+        natives.computeDiff(a, b, maxEdits, 1e7),
+        recursivelyEquals(result));
+  }
+
+  return result;
+};
+
+ComputeDiffTest.prototype.IdenticalSequences = function() {
+  expectThat(this.diff_('', '').hunks, elementsAre([]));
+  expectThat(this.diff_('taco', 'taco').hunks, elementsAre([]));
+};
+
+ComputeDiffTest.prototype.EmptySequences = function() {
+  expectThat(
+      this.diff_('', 'taco'),
+      recursivelyEquals({ hunks: [[0, 0, 0, 4]], complete: true }));
+
+  expectThat(
+      this.diff_('taco', ''),
+      recursivelyEquals({ hunks: [[0, 4, 0, 0]], complete: true }));
+};
+
+ComputeDiffTest.prototype.SingleHunks = function() {
+  expectThat(this.diff_('abcde', 'abXde').hunks,
+             recursivelyEquals([[2, 3, 2, 3]]));
+  expectThat(this.diff_('abcde', 'abXYcde').hunks,
+             recursivelyEquals([[2, 2, 2, 4]]));
+  expectThat(this.diff_('abcde', 'ade').hunks,
+             recursivelyEquals([[1, 3, 1, 1]]));
+};
+
+ComputeDiffTest.prototype.SeveralHunks = function() {
+  expectThat(this.diff_('abcdefgh', 'abXdefYZh').hunks,
+             recursivelyEquals([[2, 3, 2, 3], [6, 7, 6, 8]]));
+  expectThat(this.diff_('abcd', 'bcdX').hunks,
+             recursivelyEquals([[0, 1, 0, 0], [4, 4, 3, 4]]));
+};
+
+ComputeDiffTest.prototype.Tokens = function() {
+  var a = new Int32Array([1, 2, 3, 4, 5]);
+  var b = new Int32Array([1, 2, 7, 4, 5, 6]);
+
+  expectThat(this.diff_(a, b).hunks,
+             recursivelyEquals([[2, 3, 2, 3], [5, 5, 5, 6]]));
+};
+
+ComputeDiffTest.prototype.AppliedHunksGiveSecondSequence = function() {
+  for (var i = 0; i < 100; ++i) {
+    var a = '';
+    var b = '';
+    for (var j = (i * 7) % 20; j > 0; --j) a += 'abc'.charAt((i * j) % 3);
+    for (var j = (i * 11) % 20; j > 0; --j) b += 'abc'.charAt((i + j) % 3);
+
+    var hunks = this.diff_(a, b).hunks;
+    var patched = '';
+    var aPos = 0;
+    for (var j = 0; j < hunks.length; ++j) {
+      patched += a.substring(aPos, hunks[j][0]);
+      patched += b.substring(hunks[j][2], hunks[j][3]);
+      aPos = hunks[j][1];
+    }
+
+    patched += a.substring(aPos);
+    expectEq(b, patched, a + ' -> ' + b);
+  }
+};
+
+ComputeDiffTest.prototype.GivesUpAfterTooManyEdits = function() {
+  expectThat(
+      this.diff_('abcdefgh', 'abXdefgh', 2),
+      recursivelyEquals({ hunks: [[2, 3, 2, 3]], complete: true }));
+
+  expectThat(
+      this.diff_('abcdefgh', 'abXdeYgh', 2),
+      recursivelyEquals({ hunks: [[2, 6, 2, 6]], complete: false }));
+};
+
+ComputeDiffTest.prototype.GivesUpAfterTooManyComparisons = function() {
+  var a = new Int32Array(1000);
+  var b = new Int32Array(1000);
+  for (var i = 0; i < b.length; i += 100) b[i] = 1;
+
+  var result = computeDiff(a, b, 1000, 100);
+  expectThat(result, recursivelyEquals({
+    hunks: [[0, 901, 0, 901]],
+    complete: false
+  }));
+
+  var natives = gjstest.internal.natives;
+  if (natives) {
+    expectThat(natives.computeDiff(a, b, 1000, 100),
+               recursivelyEquals(result));
+  }
+};
+
+ComputeDiffTest.prototype.NativeImplementationRejectsBadArguments =
+    function() {
+  var natives = gjstest.internal.natives;
+  if (!natives) return;
+
+  var tokens = new Int32Array([1, 2]);
+
+  expectThat(function() { natives.computeDiff('ab', tokens, 10, 100); },
+             throwsError(/TypeError.*two strings or two Int32Arrays/));
+  expectThat(function() { natives.computeDiff(tokens, [1, 2], 10, 100); },
+             throwsError(/TypeError.*two strings or two Int32Arrays/));
+  expectThat(function() { natives.computeDiff(tokens, 'ab', 10, 100); },
+             throwsError(/TypeError.*two strings or two Int32Arrays/));
+
+  var budget = { valueOf: function() { throw new Error('taco'); } };
+  expectThat(function() { natives.computeDiff('ab', 'ac', budget, 100); },
+             throwsError(/taco/));
+};
+
+////////////////////////////////////////////////////////////////////////
+// describeDiff
+////////////////////////////////////////////////////////////////////////
+
+function DescribeDiffTest() {}
+registerTestSuite(DescribeDiffTest);
+
+function makeRange(length) {
+  var result = [];
+  for (var i = 0; i < length; ++i) result.push(i);
+  return result;
+}
+
+DescribeDiffTest.prototype.SmallValues = function() {
+  expectEq(null, describeDiff('taco', 'burrito'));
+  expectEq(null, describeDiff([1, 2, 3], [1, 2]));
+  expectEq(null, describeDiff(17, 19));
+  expectEq(null, describeDiff(makeRange(30), 'taco'));
+  expectEq(null, describeDiff(makeRange(30), { length: 'taco' }));
+};
+
+DescribeDiffTest.prototype.EqualValues = function() {
+  expectEq(null, describeDiff(makeRange(30), makeRange(30)));
+  expectEq(null, describeDiff('taco\nburrito', 'taco\nburrito'));
+};
+
+DescribeDiffTest.prototype.LongArrays = function() {
+  var expected = makeRange(50000);
+  var actual = makeRange(50000);
+  actual[120] = 'foo';
+  actual.splice(4012, 1);
+
+  expectEq(
+      'Differences (- expected, + actual):\n' +
+          '  - [120] 120\n' +
+          '  + [120] \'foo\'\n' +
+          '  ...\n' +
+          '  - [4012] 4012',
+      describeDiff(expected, actual));
+};
+
+DescribeDiffTest.prototype.ElementsAreComparedByTypeAndDescription =
+    function() {
+  var expected = makeRange(30);
+  var actual = makeRange(30);
+  expected[3] = { foo: 1 };
+  actual[3] = { foo: 1 };
+  actual[7] = '7';
+
+  expectEq(
+      'Differences (- expected, + actual):\n' +
+          '  - [7] 7\n' +
+          '  + [7] \'7\'',
+      describeDiff(expected, actual));
+};
+
+DescribeDiffTest.prototype.ArraysContainingMatchers = function() {
+  var expected = makeRange(30);
+  expected[3] = _;
+
+  expectEq(null, describeDiff(expected, makeRange(31)));
+};
+
+DescribeDiffTest.prototype.LongHunksAndManyHunks = function() {
+  var expected = makeRange(1000);
+  var actual = makeRange(1000);
+  for (var i = 0; i < 12; ++i) actual[i * 50] = -1;
+  for (var i = 900; i < 920; ++i) actual[i] = -1;
+
+  var lines = describeDiff(expected, actual).split('\n');
+  expectThat(lines, elementsAre([
+    'Differences (- expected, + actual):',
+    '  - [0] 0',
+    '  + [0] -1',
+    '  ...',
+    '  - [50] 50',
+    '  + [50] -1',
+    '  ...',
+    '  - [100] 100',
+    '  + [100] -1',
+    '  ...',
+    '  - [150] 150',
+    '  + [150] -1',
+    '  ...',
+    '  - [200] 200',
+    '  + [200] -1',
+    '  ...',
+    '  - [250] 250',
+    '  + [250] -1',
+    '  ...',
+    '  - [300] 300',
+    '  + [300] -1',
+    '  ...',
+    '  - [350] 350',
+    '  + [350] -1',
+    '  ...',
+    '  - [400] 400',
+    '  + [400] -1',
+    '  ...',
+    '  - [450] 450',
+    '  + [450] -1',
+    '  (3 more differences)',
+  ]));
+
+  expected = makeRange(1000);
+  actual = makeRange(1000);
+  for (var i = 900; i < 920; ++i) actual[i] = -1;
+
+  lines = describeDiff(expected, actual).split('\n');
+  expectEq(23, lines.length);
+  expectEq('  - [909] 909', lines[10]);
+  expectEq('  - (10 more)', lines[11]);
+  expectEq('  + [900] -1', lines[12]);
+  expectEq('  + (10 more)', lines[22]);
+};
+
+DescribeDiffTest.prototype.MultiLineStrings = function() {
+  var expected = 'taco\nburrito\nenchilada\nqueso\nnachos';
+  var actual = 'taco\nburrito\nfajita\nqueso\nnachos\nsalsa';
+
+  expectEq(
+      'Differences (- expected, + actual):\n' +
+          '  - line 3: enchilada\n' +
+          '  + line 3: fajita\n' +
+          '  ...\n' +
+          '  + line 6: salsa',
+      describeDiff(expected, actual));
+};
+
+DescribeDiffTest.prototype.LongStrings = function() {
+  var expected = new Array(10001).join('abcdefghij');
+  var actual =
+      expected.substring(0, 50000) + 'XY' + expected.substring(50001);
+
+  expectEq(
+      'Differences (- expected, + actual):\n' +
+          '  - [50000] ...abcdefghij[a]bcdefghija...\n' +
+          '  + [50000] ...abcdefghij[XY]bcdefghija...',
+      describeDiff(expected, actual));
+};
+
+DescribeDiffTest.prototype.BudgetRunsOut = function() {
+  var budget = gjstest.internal.diffBudget;
+  var oldMaxEdits = budget.maxEdits;
+  budget.maxEdits = 2;
+
+  // Four edits are needed. Everything between the common prefix and suffix is
+  // shown instead.
+  var expected = new Array(11).join('abcdefghij');
+  var actual =
+      'abcdefghij' + 'X' + expected.substring(11, 89) + 'Y' + 'abcdefghij';
+
+  try {
+    expectEq(
+        'Differences (- expected, + actual):\n' +
+            '  - [10] abcdefghij' +
+            '[abcdefghijabcdefghijabcdefghijabcdefghij...]abcdefghij\n' +
+            '  + [10] abcdefghij' +
+            '[Xbcdefghijabcdefghijabcdefghijabcdefghij...]abcdefghij\n' +
+            '  (gave up looking for a smaller diff)',
+        describeDiff(expected, actual));
+  } finally {
+    budget.maxEdits = oldMaxEdits;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////
+// Matchers
+////////////////////////////////////////////////////////////////////////
+
+function DiffingMatchersTest() {}
+registerTestSuite(DiffingMatchersTest);
+
+DiffingMatchersTest.prototype.Equals = function() {
+  var expected = 'taco\nburrito';
+  var differences = equals(expected).describeDifferences('taco\nfajita');
+  expectThat(differences, containsRegExp(/- line 2: burrito\n  \+ line 2/));
+
+  expectEq(null, equals(17).describeDifferences);
+  expectEq(null, equals(makeRange(30)).describeDifferences);
+};
+
+DiffingMatchersTest.prototype.RecursivelyEquals = function() {
+  var actual = makeRange(30);
+  actual[3] = 'taco';
+
+  expectEq(
+      'Differences (- expected, + actual):\n' +
+          '  - [3] 3\n' +
+          '  + [3] \'taco\'',
+      recursivelyEquals(makeRange(30)).describeDifferences(actual));
+};
+
+DiffingMatchersTest.prototype.ElementsAre = function() {
+  var actual = makeRange(30);
+  actual[3] = 'taco';
+
+  expectEq(
+      'Differences (- expected, + actual):\n' +
+          '  - [3] 3\n' +
+          '  + [3] \'taco\'',
+      elementsAre(makeRange(30)).describeDifferences(actual));
+};
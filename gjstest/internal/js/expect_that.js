@@ -41,7 +41,10 @@ gjstest.internal.expectThat = function(
     stringify,
     reportFailure,
     errorMessage) {
+  ++gjstest.internal.stats.expectThatCalls;
+
   // Ask the matcher about the object.
+  ++gjstest.internal.stats.matcherPredicateCalls;
   var predicateResult = matcher.predicate(obj);
 
   // If the matcher says the object is okay, we're done.
@@ -58,6 +61,14 @@ gjstest.internal.expectThat = function(
     failureMessage += ', ' + predicateResult;
   }
 
+  // Point out where large values differ, if the matcher knows how.
+  if (matcher.describeDifferences) {
+    var differences = matcher.describeDifferences(obj);
+    if (differences != null) {
+      failureMessage += '\n' + differences;
+    }
+  }
+
   if (errorMessage != null) {
     failureMessage += '\n' + errorMessage;
   }
@@ -100,3 +100,46 @@ ExpectThatTest.prototype.MatcherReturnsStringAndUserGivesErrorMessage =
       this.reportFailure_,
       'Grande Failure');
 };
+
+ExpectThatTest.prototype.MatcherDescribesDifferences = function() {
+  var obj = {};
+  var describeDifferences = createMockFunction();
+  this.matcher_.describeDifferences = describeDifferences;
+
+  expectCall(this.predicate_)(_)
+    .willOnce(returnWith('which has too few tacos'));
+
+  expectCall(this.stringify_)(obj)
+    .willOnce(returnWith('burrito'));
+
+  expectCall(describeDifferences)(obj)
+    .willOnce(returnWith('Differences:\n  - taco'));
+
+  expectCall(this.reportFailure_)(
+      'Expected: desc\n' +
+          'Actual:   burrito, which has too few tacos\n' +
+          'Differences:\n  - taco\n' +
+          'Grande Failure');
+
+  internalExpectThat(
+      obj,
+      this.matcher_,
+      this.stringify_,
+      this.reportFailure_,
+      'Grande Failure');
+};
+
+ExpectThatTest.prototype.MatcherHasNoDifferencesToDescribe = function() {
+  var obj = {};
+  this.matcher_.describeDifferences = function() { return null; };
+
+  expectCall(this.predicate_)(_)
+    .willOnce(returnWith(false));
+
+  expectCall(this.stringify_)(obj)
+    .willOnce(returnWith('burrito'));
+
+  expectCall(this.reportFailure_)('Expected: desc\nActual:   burrito');
+
+  internalExpectThat(obj, this.matcher_, this.stringify_, this.reportFailure_);
+};
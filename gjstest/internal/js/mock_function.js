@@ -86,6 +86,113 @@ gjstest.internal.describeExpectation = function(expectation) {
   return result;
 };
 
+/**
+ * An index of the call expectations registered for a mock function, used to
+ * find the ones that might match a call without evaluating the matchers of
+ * every expectation.
+ *
+ * Each expectation is filed under the primitiveKey of the matcher for its
+ * first argument that has one, or left unfiled if none does. A call can only
+ * match the unfiled expectations and those filed under the key of the
+ * corresponding argument.
+ *
+ * @param {!Array.<!gjstest.internal.CallExpectation>} expectations
+ *     The expectations to index. New ones may be appended at any time, but
+ *     the matchers of an expectation must not change once it's been added.
+ *
+ * @constructor
+ * @private
+ */
+gjstest.internal.CallExpectationIndex_ = function(expectations) {
+  this.expectations_ = expectations;
+  // The number of expectations filed so far, and the last one, which is used
+  // to notice if the list has been truncated.
+  this.numFiled_ = 0;
+  this.lastFiled_ = null;
+
+  // For each argument position, an object mapping primitive keys to the
+  // indices in expectations_ of the expectations filed under them. Indices are
+  // in increasing order, as are those of the unfiled expectations.
+  this.filed_ = [];
+  this.unfiled_ = [];
+};
+
+/**
+ * Return the indices of the expectations that might match a call with the
+ * supplied arguments, in increasing order.
+ *
+ * @param {!Arguments} args
+ * @return {!Array.<number>}
+ */
+gjstest.internal.CallExpectationIndex_.prototype.getCandidates =
+    function(args) {
+  this.update_();
+
+  var lists = [this.unfiled_];
+  var numArgs = Math.min(args.length, this.filed_.length);
+  for (var i = 0; i < numArgs; ++i) {
+    var key = gjstest.internal.getPrimitiveKey(args[i]);
+    var list = key === null ? null : this.filed_[i][key];
+    if (list) {
+      lists.push(list);
+    }
+  }
+
+  // The common cases: no indexed expectations, or a single key.
+  if (lists.length == 1) {
+    return lists[0];
+  }
+
+  if (lists.length == 2 && !this.unfiled_.length) {
+    return lists[1];
+  }
+
+  // Merge the lists. No expectation is in more than one.
+  var result = Array.prototype.concat.apply([], lists);
+  result.sort(function(a, b) { return a - b; });
+  return result;
+};
+
+/**
+ * File any expectations added since the last call.
+ *
+ * @private
+ */
+gjstest.internal.CallExpectationIndex_.prototype.update_ = function() {
+  var expectations = this.expectations_;
+
+  // Start again if expectations have been removed.
+  if (this.numFiled_ &&
+      expectations[this.numFiled_ - 1] !== this.lastFiled_) {
+    this.numFiled_ = 0;
+    this.filed_ = [];
+    this.unfiled_ = [];
+  }
+
+  for (; this.numFiled_ < expectations.length; ++this.numFiled_) {
+    this.lastFiled_ = expectations[this.numFiled_];
+    var matchers = this.lastFiled_.argMatchers;
+
+    var i = 0;
+    while (i < matchers.length && matchers[i].primitiveKey === null) {
+      ++i;
+    }
+
+    if (i == matchers.length) {
+      this.unfiled_.push(this.numFiled_);
+      continue;
+    }
+
+    while (this.filed_.length <= i) {
+      this.filed_.push({});
+    }
+
+    var key = matchers[i].primitiveKey;
+    var list = this.filed_[i][key] || (this.filed_[i][key] = []);
+    list.push(this.numFiled_);
+  }
+};
+
 /**
  * Create a mock function that verifies against a list of expectation and takes
  * the appropriate action when called.
@@ -98,6 +205,8 @@ gjstest.internal.describeExpectation = function(expectation) {
  *     checkArgs
  *     A function that knows how to check function call arguments against a call
  *     expectation, returning null if it matches and an error message otherwise.
+ *     It must not match an argument whose primitive key differs from the
+ *     primitiveKey of the corresponding matcher, if that's not null.
  *
  * @param {function(string)} reportFailure
  *     A function that will be called with a descriptive error message in the
@@ -114,22 +223,30 @@ gjstest.internal.createMockFunction =
   var callExpectations =
       /** @type !Array.<gjstest.internal.CallExpectation> */([]);
 
+  // Many mock functions are never called, for example most methods of mock
+  // instances, so create the index on the first call.
+  var index = null;
+
   // Create a function that checks its arguments against the expectations that
   // have been registered.
   var result = function() {
-    // Check the arguments against each expectation, building up information
-    // about why each didn't match. Each element of nonMatchInfo is an array
-    // whose first element is the expectation that didn't match, and whose
-    // second element is the failure message for that expectation.
-    //
-    // If some expectation does match, perform an action and return early.
-    var nonMatchInfo = [];
+    ++gjstest.internal.stats.mockFunctionCalls;
 
-    for (var i = callExpectations.length - 1; i >= 0; --i) {
+    // Check the arguments against each expectation that might match them,
+    // newest first, remembering why each didn't match. If some expectation
+    // does match, perform an action and return early.
+    index = index ||
+        new gjstest.internal.CallExpectationIndex_(callExpectations);
+
+    var candidates = index.getCandidates(arguments);
+    var failureMessages = [];
+
+    for (var j = candidates.length - 1; j >= 0; --j) {
       var expectation = /** @type {!gjstest.internal.CallExpectation} */ (
-          callExpectations[i]);
+          callExpectations[candidates[j]]);
 
       // Does this expectation match?
+      ++gjstest.internal.stats.mockExpectationChecks;
       var expectationFailureMessage = checkArgs(arguments, expectation);
       if (expectationFailureMessage === null) {
         ++expectation.numMatches;
@@ -139,6 +256,24 @@ gjstest.internal.createMockFunction =
         return actionFunc.apply(this, arguments);
       }
 
+      failureMessages[candidates[j]] = expectationFailureMessage;
+    }
+
+    // Build up information about why each expectation didn't match, checking
+    // the ones the index ruled out. Each element of nonMatchInfo is an array
+    // whose first element is the expectation that didn't match, and whose
+    // second element is the failure message for that expectation.
+    var nonMatchInfo = [];
+    for (var i = callExpectations.length - 1; i >= 0; --i) {
+      var expectation = /** @type {!gjstest.internal.CallExpectation} */ (
+          callExpectations[i]);
+
+      var expectationFailureMessage = failureMessages[i];
+      if (expectationFailureMessage === undefined) {
+        ++gjstest.internal.stats.mockExpectationChecks;
+        expectationFailureMessage = checkArgs(arguments, expectation);
+      }
+
       nonMatchInfo.push([expectation, expectationFailureMessage]);
     }
 
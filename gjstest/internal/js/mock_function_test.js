@@ -375,3 +375,139 @@ MockFunctionTest.prototype.ActionReturnValues = function() {
 
   expectEq(0, this.failureMessages_.length);
 };
+
+////////////////////////////////////////////////////////////////////////
+// Expectations indexed by primitive arguments
+////////////////////////////////////////////////////////////////////////
+
+function IndexedMockFunctionTest() {
+  this.failureMessages_ = [];
+
+  var me = this;
+  var reportFailure = function(msg) { me.failureMessages_.push(msg); };
+
+  this.mockFunction_ =
+      createMockFunction(
+          gjstest.stringify,
+          gjstest.internal.checkArgsAgainstExpectation,
+          reportFailure);
+}
+registerTestSuite(IndexedMockFunctionTest);
+
+IndexedMockFunctionTest.prototype.addExpectation_ =
+    function(matchers, returnValue) {
+  var expectation =
+      new CallExpectation(
+          matchers,
+          { fileName: 'foo.js', lineNumber: 17 });
+
+  expectation.fallbackAction =
+      new MockAction(function() { return returnValue; });
+
+  this.mockFunction_.__gjstest_expectations.push(expectation);
+  return expectation;
+};
+
+IndexedMockFunctionTest.prototype.ManyPrimitiveExpectations = function() {
+  for (var i = 0; i < 1000; ++i) {
+    this.addExpectation_([equals(i), equals('' + i)], 'number ' + i);
+    this.addExpectation_([equals('' + i)], 'string ' + i);
+  }
+
+  gjstest.internal.takeStats();
+
+  expectEq('number 17', this.mockFunction_(17, '17'));
+  expectEq('string 17', this.mockFunction_('17'));
+  expectEq('number 999', this.mockFunction_(999, '999'));
+  expectEq('string 0', this.mockFunction_('0'));
+
+  expectEq(4, gjstest.internal.takeStats().mockExpectationChecks);
+  expectEq(0, this.failureMessages_.length);
+};
+
+IndexedMockFunctionTest.prototype.NewestExpectationWins = function() {
+  this.addExpectation_([_], 'any 0');
+  this.addExpectation_([equals(1)], 'one 0');
+  this.addExpectation_([_], 'any 1');
+  this.addExpectation_([equals(2)], 'two');
+
+  expectEq('two', this.mockFunction_(2));
+  expectEq('any 1', this.mockFunction_(1));
+
+  this.addExpectation_([equals(1)], 'one 1');
+  expectEq('one 1', this.mockFunction_(1));
+  expectEq('two', this.mockFunction_(2));
+  expectEq('any 1', this.mockFunction_(3));
+};
+
+IndexedMockFunctionTest.prototype.IndexesFirstPrimitiveArgument = function() {
+  this.addExpectation_([_, equals('taco')], 'taco');
+  this.addExpectation_([_, equals('burrito')], 'burrito');
+  this.addExpectation_([equals(1), _], 'one');
+
+  expectEq('taco', this.mockFunction_(2, 'taco'));
+  expectEq('one', this.mockFunction_(1, 'taco'));
+  expectEq('burrito', this.mockFunction_({}, 'burrito'));
+};
+
+IndexedMockFunctionTest.prototype.KeysDistinguishTypes = function() {
+  this.addExpectation_([equals(1)], 'number');
+  this.addExpectation_([equals('1')], 'string');
+  this.addExpectation_([equals(true)], 'true');
+  this.addExpectation_([equals('true')], 'string true');
+  this.addExpectation_([equals(null)], 'null');
+  this.addExpectation_([equals(undefined)], 'undefined');
+
+  expectEq('number', this.mockFunction_(1));
+  expectEq('string', this.mockFunction_('1'));
+  expectEq('true', this.mockFunction_(true));
+  expectEq('string true', this.mockFunction_('true'));
+  expectEq('null', this.mockFunction_(null));
+  expectEq('undefined', this.mockFunction_(undefined));
+  expectEq(0, this.failureMessages_.length);
+
+  this.mockFunction_(0);
+  this.mockFunction_();
+  expectEq(2, this.failureMessages_.length);
+};
+
+IndexedMockFunctionTest.prototype.ExpectationsRemoved = function() {
+  this.addExpectation_([equals(1)], 'one 0');
+  expectEq('one 0', this.mockFunction_(1));
+
+  this.mockFunction_.__gjstest_expectations.length = 0;
+  this.addExpectation_([equals(2)], 'two');
+
+  expectEq('two', this.mockFunction_(2));
+  this.mockFunction_(1);
+  expectEq(1, this.failureMessages_.length);
+};
+
+IndexedMockFunctionTest.prototype.FailureDescribesEveryExpectation =
+    function() {
+  this.addExpectation_([equals(1)], 'one');
+  this.addExpectation_([_, equals(2)], 'two');
+  this.addExpectation_([equals(3)], 'three');
+
+  this.mockFunction_(1, 3);
+
+  expectThat(this.failureMessages_, elementsAre([_]));
+  expectThat(
+      this.failureMessages_[0],
+      hasSubstr(
+          'Call matches no expectation.\n' +
+              '    Arg 0: 1\n' +
+              '    Arg 1: 3\n' +
+              '\n' +
+              'Tried expectation at foo.js:17, but number of arguments ' +
+                  'didn\'t match:\n' +
+              '    Arg 0: 3\n' +
+              '\n' +
+              'Tried expectation at foo.js:17, but arg 1 didn\'t match:\n' +
+              '    Arg 0: is anything\n' +
+              '    Arg 1: 2\n' +
+              '\n' +
+              'Tried expectation at foo.js:17, but number of arguments ' +
+                  'didn\'t match:\n' +
+              '    Arg 0: 1\n'));
+};
@@ -149,16 +149,50 @@ gjstest.internal.createMockOfPrototype_ =
   var result = new Tmp;
 
   // Mock each function in the prototype.
-  for (var name of gjstest.internal.getAllPrototypeProperties_(Tmp.prototype)) {
-    // Avoid mocking out the 'constructor' property.
-    if (name == 'constructor' || typeof(result[name]) != 'function') continue;
-
-    result[name] = createMockFunction(baseName + '.' + name);
+  var names = gjstest.internal.getMockableMethods_(prototype);
+  for (var i = 0; i < names.length; ++i) {
+    result[names[i]] = createMockFunction(baseName + '.' + names[i]);
   }
 
   return result;
 };
 
+/**
+ * The result of getMockableMethods_ for each prototype it has been called on.
+ *
+ * @type {!WeakMap.<!Object, !Array.<string>>}
+ * @private
+ */
+gjstest.internal.mockableMethods_ = new WeakMap;
+
+/**
+ * Return the names of the function properties of the supplied object and its
+ * prototype chain, other than 'constructor'. The result is computed once per
+ * object, so functions added to the chain later are not included.
+ *
+ * @param {!Object} prototype
+ * @return {!Array.<string>}
+ *
+ * @private
+ */
+gjstest.internal.getMockableMethods_ = function(prototype) {
+  var names = gjstest.internal.mockableMethods_.get(prototype);
+  if (names) {
+    return names;
+  }
+
+  names =
+      gjstest.internal.getAllPrototypeProperties_(prototype).filter(
+          function(name) {
+            // Avoid mocking out the 'constructor' property.
+            return name != 'constructor' &&
+                typeof(prototype[name]) == 'function';
+          });
+
+  gjstest.internal.mockableMethods_.set(prototype, names);
+  return names;
+};
+
 /**
  * Object.getOwnPropertyNames does not include inherited methods. This method
  * crawls up the inheritance chain and records all properties.
@@ -190,7 +224,9 @@ gjstest.internal.getAllPrototypeProperties_ = function(obj) {
 
 /**
  * Given a constructor for a class, create an instance of that class that has
- * mock functions for each of the class's prototype methods.
+ * mock functions for each of the class's prototype methods. The methods are
+ * found the first time a class is mocked and reused afterward, so add any
+ * methods to its prototype chain before then.
  *
  * @param {!Function} ctor
  *
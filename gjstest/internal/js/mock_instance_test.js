@@ -284,3 +284,63 @@ MockInstanceTest.prototype.ES6Inheritance = function() {
   expectTrue(result instanceof ParentClass);
   expectTrue(result instanceof ChildClass);
 };
+
+MockInstanceTest.prototype.MockingTwiceCreatesNewMethods = function() {
+  function MyClass() {}
+  MyClass.prototype.taco = function() {};
+
+  var mockFn_0 = function() {};
+  var mockFn_1 = function() {};
+
+  expectCall(this.createMockFunction_)('MyClass.taco')
+    .willOnce(returnWith(mockFn_0))
+    .willOnce(returnWith(mockFn_1));
+
+  expectEq(mockFn_0, this.createMockInstance_(MyClass).taco);
+  expectEq(mockFn_1, this.createMockInstance_(MyClass).taco);
+};
+
+MockInstanceTest.prototype.MethodsAreFoundOnce = function() {
+  function MyClass() {}
+  MyClass.prototype.taco = function() {};
+
+  var getAllPrototypeProperties =
+      gjstest.internal.getAllPrototypeProperties_;
+  var numCalls = 0;
+  gjstest.internal.getAllPrototypeProperties_ = function(obj) {
+    ++numCalls;
+    return getAllPrototypeProperties(obj);
+  };
+
+  expectCall(this.createMockFunction_)('MyClass.taco')
+    .willRepeatedly(returnWith(function() {}));
+
+  try {
+    for (var i = 0; i < 3; ++i) {
+      this.createMockInstance_(MyClass);
+    }
+  } finally {
+    gjstest.internal.getAllPrototypeProperties_ = getAllPrototypeProperties;
+  }
+
+  expectEq(1, numCalls);
+};
+
+MockInstanceTest.prototype.MethodsAddedAfterFirstMockAreNotMocked =
+    function() {
+  function MyClass() {}
+  MyClass.prototype.taco = function() {};
+
+  var mockFn = function() {};
+  expectCall(this.createMockFunction_)('MyClass.taco')
+    .willRepeatedly(returnWith(mockFn));
+
+  this.createMockInstance_(MyClass);
+
+  var burrito = function() {};
+  MyClass.prototype.burrito = burrito;
+
+  var result = this.createMockInstance_(MyClass);
+  expectEq(mockFn, result.taco);
+  expectEq(burrito, result.burrito);
+};
@@ -29,3 +29,22 @@ var gjstest = {};
 
 /** @const */
 gjstest.internal = {};
+
+/**
+ * Functions implemented in C++ by the gjstest binary, which installs them
+ * before any script runs. Null elsewhere, e.g. in the browser, in which case
+ * the JS implementations are used. See gjstest/internal/cpp/natives.h.
+ *
+ * @type {?{stringifyToDepth: function(*, number): string}}
+ */
+gjstest.internal.natives = globalContext['gjstestNatives'] || null;
+delete globalContext['gjstestNatives'];
+
+/**
+ * The functions behind gjstest.clock, implemented in C++ by the gjstest
+ * binary. Null elsewhere. See gjstest/internal/cpp/event_loop.h.
+ *
+ * @type {?{tick: function(number), runAll: function()}}
+ */
+gjstest.internal.clockNatives = globalContext['gjstestClock'] || null;
+delete globalContext['gjstestClock'];
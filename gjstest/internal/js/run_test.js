@@ -16,11 +16,20 @@
 /**
  * Run a test function returned by gjstest.internal.getTestFunctions.
  *
- * @param {function()} testFn
+ * If the test function returns a promise, the test isn't finished until it
+ * settles. In that case return a promise that is fulfilled once the test's
+ * failures have been reported and its mock expectations checked. Until then
+ * the test runner is responsible for making testEnvironment current whenever
+ * code belonging to the test runs. Otherwise finish the test before returning
+ * null.
+ *
+ * @param {function(): *} testFn
  *     The test function.
  *
  * @param {!gjstest.internal.TestEnvironment} testEnvironment
  *     The environment in which this test should be run.
+ *
+ * @return {Promise}
  */
 gjstest.internal.runTest = function runTest(testFn, testEnvironment) {
   // Register the test environment and run the test.
@@ -30,56 +39,99 @@ gjstest.internal.runTest = function runTest(testFn, testEnvironment) {
   // an error is thrown, we can obtain the structured stack trace.
   gjstest.internal.installPrepareStackTrace();
 
-  // Keep track of whether we reported an exception failure.
-  var threwException = false;
-
+  var result;
   try {
-    testFn();
+    result = testFn();
   } catch (error) {
-    var failureMessage = '' + gjstest.stringify(error);
+    gjstest.internal.reportException(error, testEnvironment);
+    gjstest.internal.finishTest_(testEnvironment, true);
+    return null;
+  }
+
+  if (!gjstest.internal.isThenable(result)) {
+    gjstest.internal.finishTest_(testEnvironment, false);
+    return null;
+  }
+
+  var finished =
+      Promise.resolve(result).then(
+          function() {
+            gjstest.internal.finishTest_(testEnvironment, false);
+          },
+          function(error) {
+            gjstest.internal.reportException(error, testEnvironment);
+            gjstest.internal.finishTest_(testEnvironment, true);
+          });
+
+  gjstest.internal.currentTestEnvironment = null;
+  return finished;
+};
+
+/**
+ * Report an exception thrown by a test, or the reason its promise was
+ * rejected, as a failure of the test.
+ *
+ * @param {*} error
+ * @param {!gjstest.internal.TestEnvironment} testEnvironment
+ */
+gjstest.internal.reportException = function(error, testEnvironment) {
+  var failureMessage = '' + gjstest.stringify(error);
+
+  // If the exception was thrown from within gjstest public code, the test
+  // environment has a user stack available and reportFailure will be able to
+  // automatically add the file name and line number of the user code at
+  // fault.
+  //
+  // Otherwise, this exception may have been thrown from deep within the code
+  // under test (for example in a file devoted to assertions). Add a stack
+  // trace to help with debugging.
+  if (testEnvironment.getUserStack().length == 0) {
+    var errorStack = gjstest.internal.getErrorStack(error);
 
-    // If the exception was thrown from within gjstest public code, the test
-    // environment has a user stack available and reportFailure will be able to
-    // automatically add the file name and line number of the user code at
-    // fault.
+    // Sometimes v8 will put a weird entry like the following on the top of
+    // the error stack:
     //
-    // Otherwise, this exception may have been thrown from deep within the code
-    // under test (for example in a file devoted to assertions). Add a stack
-    // trace to help with debugging.
-    if (testEnvironment.userStack.length == 0) {
-      var errorStack = gjstest.internal.getErrorStack(error);
-
-      // Sometimes v8 will put a weird entry like the following on the top of
-      // the error stack:
-      //
-      //     Object.CALL_NON_FUNCTION (native)
-      //
-      // This describes the error itself rather than the stack frame at which it
-      // was thrown, so skip the top frame if it doesn't have a line number but
-      // the second one does.
-      if (errorStack.length > 1 &&
-          errorStack[0].lineNumber == null &&
-          errorStack[1].lineNumber != null) {
-        errorStack = errorStack.slice(1);
-      }
-
-      // Add a stack trace to the message.
-      var formattedTrace = gjstest.internal.describeStack(errorStack);
-      failureMessage = failureMessage + '\n\nStack:\n' + formattedTrace;
+    //     Object.CALL_NON_FUNCTION (native)
+    //
+    // This describes the error itself rather than the stack frame at which it
+    // was thrown, so skip the top frame if it doesn't have a line number but
+    // the second one does.
+    if (errorStack.length > 1 &&
+        errorStack[0].lineNumber == null &&
+        errorStack[1].lineNumber != null) {
+      errorStack = errorStack.slice(1);
     }
 
-    testEnvironment.reportFailure(failureMessage);
-    threwException = true;
+    // Add a stack trace to the message.
+    var formattedTrace = gjstest.internal.describeStack(errorStack);
+    failureMessage = failureMessage + '\n\nStack:\n' + formattedTrace;
   }
 
+  testEnvironment.reportFailure(failureMessage);
+};
+
+/**
+ * Check the mock expectations of a test that has finished running, and reset
+ * the current test environment.
+ *
+ * @param {!gjstest.internal.TestEnvironment} testEnvironment
+ *
+ * @param {boolean} threwException
+ *     Whether the test failed with an exception, in which case unsatisfied
+ *     expectations aren't reported.
+ *
+ * @private
+ */
+gjstest.internal.finishTest_ = function(testEnvironment, threwException) {
   // Make sure each mock expectation was satisfied.
   //
   // NOTE(jacobsa): If the complexity of the interaction between gjstest the
   // testing framework and gjstest the mocking framework grows too much,
   // consider adding a facility for registering arbitrary pre-test and post-test
   // functions to be run, and moving this there.
-  for (var i = 0; i < gjstest.internal.registeredCallExpectations.length; ++i) {
-    var expectation = gjstest.internal.registeredCallExpectations[i];
+  var expectations = testEnvironment.callExpectations;
+  for (var i = 0; i < expectations.length; ++i) {
+    var expectation = expectations[i];
     var unsatisfiedMessage =
         gjstest.internal.checkExpectationSatisfied(expectation);
 
@@ -99,9 +151,7 @@ gjstest.internal.runTest = function runTest(testFn, testEnvironment) {
     }
   }
 
-  // Clear the list of registered expectations, so that we don't interfere with
-  // the next test.
-  gjstest.internal.registeredCallExpectations.length = 0;
+  expectations.length = 0;
 
   // Reset the test environment.
   gjstest.internal.currentTestEnvironment = null;
@@ -21,6 +21,8 @@
  * @return {!Array.<!gjstest.internal.StackFrame>}
  */
 gjstest.internal.getCurrentStack = function() {
+  ++gjstest.internal.stats.stackCaptures;
+
   // Create an error with the current stack, and get its frames.
   var stackFrames = gjstest.internal.getErrorStack(new Error);
 
@@ -30,6 +32,67 @@ gjstest.internal.getCurrentStack = function() {
   return stackFrames;
 };
 
+/**
+ * Capture the current stack up to the point at which this function was called,
+ * without building the stack frame objects that getCurrentStack returns. The
+ * returned function builds them when called. This makes it cheap to record a
+ * stack that will only be looked at if something goes wrong.
+ *
+ * @return {function(): !Array.<!gjstest.internal.StackFrame>}
+ */
+gjstest.internal.captureCurrentStack = function() {
+  ++gjstest.internal.stats.stackCaptures;
+
+  // v8 records the stack when the error is created, but doesn't create call
+  // sites for it until its stack property is first read. This is cheaper than
+  // natives.captureStack, which has to describe every frame up front.
+  var error = new Error;
+  return function() {
+    var stackFrames = gjstest.internal.getErrorStack(error);
+
+    // Skip the frame for captureCurrentStack itself.
+    stackFrames.splice(0, 1);
+
+    return stackFrames;
+  };
+};
+
+/**
+ * Return the stack frame the supplied number of frames above the caller, so
+ * that 0 means the caller itself. Only the frames down to that one are
+ * captured. Returns a frame with unknown location if the stack isn't that
+ * deep.
+ *
+ * @param {number} depth
+ * @return {!gjstest.internal.StackFrame}
+ */
+gjstest.internal.getStackFrame = function(depth) {
+  ++gjstest.internal.stats.stackCaptures;
+
+  // Either way, the first frame captured is for this function.
+  var stackFrame = new gjstest.internal.StackFrame;
+  var natives = gjstest.internal.natives;
+  if (natives) {
+    var locations = natives.captureStack(depth + 2);
+    if (locations.length == 2 * (depth + 2)) {
+      stackFrame.fileName = locations[2 * depth + 2];
+      stackFrame.lineNumber = locations[2 * depth + 3];
+    }
+
+    return stackFrame;
+  }
+
+  var stackTraceLimit = Error.stackTraceLimit;
+  Error.stackTraceLimit = depth + 2;
+  try {
+    var stackFrames = gjstest.internal.getErrorStack(new Error);
+  } finally {
+    Error.stackTraceLimit = stackTraceLimit;
+  }
+
+  return stackFrames[depth + 1] || stackFrame;
+};
+
 /**
  * Return a human-readable description of the supplied stack trace. Each line of
  * the description is indented, for convenient printing.
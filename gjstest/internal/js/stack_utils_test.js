@@ -75,6 +75,89 @@ GetCurrentStackTest.prototype.AnonymousClass = function() {
   expectEq('stack_utils_test.js', frame.fileName);
 };
 
+////////////////////////////////////////////////////////////////////////
+// captureCurrentStack
+////////////////////////////////////////////////////////////////////////
+
+function CaptureCurrentStackTest() {}
+registerTestSuite(CaptureCurrentStackTest);
+
+CaptureCurrentStackTest.prototype.MatchesGetCurrentStack = function() {
+  function fooBar() {
+    return [gjstest.internal.captureCurrentStack(), getCurrentStack()];
+  };
+
+  var captured = fooBar();
+  var expected = captured[1];
+  var frames = captured[0]();
+
+  expectEq(expected.length, frames.length);
+  for (var i = 0; i < expected.length; ++i) {
+    expectEq(expected[i].fileName, frames[i].fileName, 'Frame ' + i);
+    expectEq(expected[i].lineNumber, frames[i].lineNumber, 'Frame ' + i);
+  }
+
+  expectEq('stack_utils_test.js', frames[0].fileName);
+  expectEq('stack_utils_test.js', frames[1].fileName);
+};
+
+CaptureCurrentStackTest.prototype.FramesAreBuiltEachTime = function() {
+  var getFrames = gjstest.internal.captureCurrentStack();
+
+  var frames = getFrames();
+  var length = frames.length;
+  expectTrue(frames[0] instanceof gjstest.internal.StackFrame);
+  expectEq('stack_utils_test.js', frames[0].fileName);
+
+  frames.length = 0;
+  expectEq(length, getFrames().length);
+};
+
+////////////////////////////////////////////////////////////////////////
+// getStackFrame
+////////////////////////////////////////////////////////////////////////
+
+function GetStackFrameTest() {}
+registerTestSuite(GetStackFrameTest);
+
+GetStackFrameTest.prototype.Caller = function() {
+  var frame = gjstest.internal.getStackFrame(0);
+
+  expectTrue(frame instanceof gjstest.internal.StackFrame);
+  expectEq('stack_utils_test.js', frame.fileName);
+  expectEq(124, frame.lineNumber);
+};
+
+GetStackFrameTest.prototype.CallersCaller = function() {
+  function fooBar() {
+    return gjstest.internal.getStackFrame(1);
+  };
+
+  var frame = fooBar();
+
+  expectEq('stack_utils_test.js', frame.fileName);
+  expectEq(136, frame.lineNumber);
+};
+
+GetStackFrameTest.prototype.BottomOfStack = function() {
+  var frame = gjstest.internal.getStackFrame(2);
+  expectThat(frame.fileName, containsRegExp(/run_test\.js/));
+};
+
+GetStackFrameTest.prototype.PastBottomOfStack = function() {
+  var frame = gjstest.internal.getStackFrame(20);
+
+  expectTrue(frame instanceof gjstest.internal.StackFrame);
+  expectEq(null, frame.fileName);
+  expectEq(null, frame.lineNumber);
+};
+
+GetStackFrameTest.prototype.RestoresStackTraceLimit = function() {
+  var limit = Error.stackTraceLimit;
+  gjstest.internal.getStackFrame(0);
+  expectEq(limit, Error.stackTraceLimit);
+};
+
 ////////////////////////////////////////////////////////////////////////
 // getErrorStack
 ////////////////////////////////////////////////////////////////////////
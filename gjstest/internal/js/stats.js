@@ -0,0 +1,64 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Counters describing the work done by the framework itself, as opposed to the
+// code under test. The C++ test runner collects them after each test with
+// gjstest.internal.takeStats; see its --stats_output_file flag.
+
+/**
+ * The current value of each counter. Keep this a flat object of numbers; the
+ * runner reports every property it finds here, under the same name.
+ *
+ * @type {!Object.<number>}
+ */
+gjstest.internal.stats = {
+  // Calls to gjstest.internal.expectThat (expectThat, expectEq, etc.).
+  expectThatCalls: 0,
+
+  // Matcher predicates evaluated by expectThat and mock functions. Predicates
+  // called from within other matchers (e.g. by allOf) are not counted.
+  matcherPredicateCalls: 0,
+
+  // Calls to mock functions.
+  mockFunctionCalls: 0,
+
+  // Call expectations tried against the arguments of mock function calls.
+  mockExpectationChecks: 0,
+
+  // Stack traces captured with gjstest.internal.getCurrentStack,
+  // captureCurrentStack, or getStackFrame.
+  stackCaptures: 0,
+
+  // Calls to gjstest.stringify, and the total length of the strings they
+  // returned in UTF-16 code units.
+  stringifyCalls: 0,
+  stringifyChars: 0
+};
+
+/**
+ * Return a copy of the current counters and reset them all to zero.
+ *
+ * @return {!Object.<number>}
+ */
+gjstest.internal.takeStats = function() {
+  var stats = gjstest.internal.stats;
+  var result = {};
+
+  for (var key in stats) {
+    result[key] = stats[key];
+    stats[key] = 0;
+  }
+
+  return result;
+};
@@ -0,0 +1,90 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+var takeStats = gjstest.internal.takeStats;
+
+function TakeStatsTest() {
+  // Throw away anything counted so far.
+  takeStats();
+}
+registerTestSuite(TakeStatsTest);
+
+TakeStatsTest.prototype.ReturnsAllCounters = function() {
+  var stats = takeStats();
+
+  expectEq(0, stats.expectThatCalls);
+  expectEq(0, stats.matcherPredicateCalls);
+  expectEq(0, stats.mockFunctionCalls);
+  expectEq(0, stats.mockExpectationChecks);
+  expectEq(0, stats.stackCaptures);
+  expectEq(0, stats.stringifyCalls);
+  expectEq(0, stats.stringifyChars);
+};
+
+TakeStatsTest.prototype.CountsExpectations = function() {
+  expectTrue(true);
+  expectEq(1, 1);
+  expectThat(2, greaterThan(1));
+
+  var stats = takeStats();
+  expectEq(3, stats.expectThatCalls);
+  expectEq(3, stats.matcherPredicateCalls);
+};
+
+TakeStatsTest.prototype.CountsStringify = function() {
+  gjstest.stringify('taco');
+  gjstest.stringify([1, 2]);
+
+  var stats = takeStats();
+  expectEq(2, stats.stringifyCalls);
+  expectEq('\'taco\''.length + '[ 1, 2 ]'.length, stats.stringifyChars);
+};
+
+TakeStatsTest.prototype.CountsMockCalls = function() {
+  var mockFunc = createMockFunction();
+  expectCall(mockFunc)(1);
+  expectCall(mockFunc)(2);
+  takeStats();
+
+  mockFunc(1);
+  mockFunc(2);
+
+  // Each call is only checked against the expectation for its argument.
+  var stats = takeStats();
+  expectEq(2, stats.mockFunctionCalls);
+  expectEq(2, stats.mockExpectationChecks);
+  expectEq(2, stats.matcherPredicateCalls);
+};
+
+TakeStatsTest.prototype.CountsMockCallsWithoutPrimitiveArgs = function() {
+  var mockFunc = createMockFunction();
+  expectCall(mockFunc)(lessThan(2));
+  expectCall(mockFunc)(greaterThan(1));
+  takeStats();
+
+  mockFunc(1);
+  mockFunc(2);
+
+  var stats = takeStats();
+  expectEq(2, stats.mockFunctionCalls);
+  expectEq(3, stats.mockExpectationChecks);
+  expectEq(3, stats.matcherPredicateCalls);
+};
+
+TakeStatsTest.prototype.ResetsCounters = function() {
+  gjstest.stringify('taco');
+  takeStats();
+
+  expectEq(0, takeStats().stringifyCalls);
+};
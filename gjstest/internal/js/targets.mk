@@ -2,12 +2,20 @@ $(eval $(call compiled_js_library, \
     gjstest/internal/js/call_expectation, \
         gjstest/internal/js/namespace \
         gjstest/internal/js/stack_utils \
+        gjstest/internal/js/stats \
         gjstest/public/matcher_types \
         gjstest/public/stringify \
         gjstest/public/matchers/equality_matchers \
         gjstest/public/matchers/missing_arg_matchers \
 ))
 
+$(eval $(call compiled_js_library, \
+    gjstest/internal/js/diff, \
+        gjstest/internal/js/namespace \
+        gjstest/public/matcher_types \
+        gjstest/public/stringify \
+))
+
 $(eval $(call compiled_js_library, \
     gjstest/internal/js/error_utils, \
         gjstest/internal/js/namespace \
@@ -18,6 +26,7 @@ $(eval $(call compiled_js_library, \
 $(eval $(call compiled_js_library, \
     gjstest/internal/js/expect_that, \
         gjstest/internal/js/namespace \
+        gjstest/internal/js/stats \
         gjstest/public/matcher_types \
 ))
 
@@ -25,6 +34,8 @@ $(eval $(call compiled_js_library, \
     gjstest/internal/js/mock_function, \
         gjstest/internal/js/call_expectation \
         gjstest/internal/js/namespace \
+        gjstest/internal/js/stats \
+        gjstest/public/matcher_types \
 ))
 
 $(eval $(call compiled_js_library, \
@@ -63,6 +74,12 @@ $(eval $(call compiled_js_library, \
         gjstest/internal/js/error_utils \
         gjstest/internal/js/namespace \
         gjstest/internal/js/stack_frame \
+        gjstest/internal/js/stats \
+))
+
+$(eval $(call compiled_js_library, \
+    gjstest/internal/js/stats, \
+        gjstest/internal/js/namespace \
 ))
 
 $(eval $(call compiled_js_library, \
@@ -77,9 +94,12 @@ $(eval $(call compiled_js_library, \
         gjstest/internal/js/run_test \
         gjstest/internal/js/slice \
         gjstest/internal/js/stack_utils \
+        gjstest/internal/js/stats \
         gjstest/internal/js/browser/run_tests \
         gjstest/public/actions \
         gjstest/public/assertions \
+        gjstest/public/clock \
+        gjstest/public/fixtures \
         gjstest/public/logging \
         gjstest/public/mocking \
         gjstest/public/matchers/array_matchers \
@@ -90,6 +110,8 @@ $(eval $(call compiled_js_library, \
         gjstest/public/matchers/missing_arg_matchers \
         gjstest/public/matchers/number_matchers \
         gjstest/public/matchers/string_matchers \
+        gjstest/public/matchers/typed_array_matchers \
+        gjstest/public/test_data \
 ))
 
 ######################################################
@@ -97,9 +119,11 @@ $(eval $(call compiled_js_library, \
 ######################################################
 
 $(eval $(call js_test,gjstest/internal/js/call_expectation))
+$(eval $(call js_test,gjstest/internal/js/diff))
 $(eval $(call js_test,gjstest/internal/js/error_utils))
 $(eval $(call js_test,gjstest/internal/js/expect_that))
 $(eval $(call js_test,gjstest/internal/js/mock_function))
 $(eval $(call js_test,gjstest/internal/js/mock_instance))
 $(eval $(call js_test,gjstest/internal/js/stack_utils))
+$(eval $(call js_test,gjstest/internal/js/stats))
 $(eval $(call js_test,gjstest/internal/js/test_environment))
@@ -20,8 +20,6 @@
  * An object that encapsulates the mutable environment associated with a running
  * test, including functions for modifying that environment.
  *
- * TODO(jacobsa): Add registered call expectations to this class.
- *
  * @param {function(string)} log
  *     A function that knows how to log a message to the outside world.
  *
@@ -29,15 +27,24 @@
  *     A function that knows how to report a test failure message to the outside
  *     world.
  *
- * @param {function(): !Array.<!gjstest.internal.StackFrame>} getCurrentStack
- *     A function that knows how to return the current stack.
+ * @param {!Function} captureCurrentStack
+ *     A function that knows how to capture the current stack, returning a
+ *     function that returns its frames when called. See
+ *     gjstest.internal.captureCurrentStack.
  *
  * @constructor
  */
 gjstest.internal.TestEnvironment =
-    function(log, reportFailure, getCurrentStack) {
+    function(log, reportFailure, captureCurrentStack) {
   this.log = log;
-  this.userStack = [];
+
+  /**
+   * The mock call expectations registered by the test, which the test runner
+   * checks once it has finished.
+   *
+   * @type {!Array.<!gjstest.internal.CallExpectation>}
+   */
+  this.callExpectations = [];
 
   // Make sure the arguments are okay.
   if (typeof(log) != 'function') {
@@ -48,21 +55,39 @@ gjstest.internal.TestEnvironment =
     throw new TypeError('reportFailure must be a function.');
   }
 
-  if (typeof(getCurrentStack) != 'function') {
-    throw new TypeError('getCurrentStack must be a function.');
+  if (typeof(captureCurrentStack) != 'function') {
+    throw new TypeError('captureCurrentStack must be a function.');
   }
 
-  /** @type {function(): !Array.<!gjstest.internal.StackFrame>} **/
-  this.getCurrentStack_ = getCurrentStack;
+  /** @type {function(): function(): !Array.<!gjstest.internal.StackFrame>} **/
+  this.captureCurrentStack_ = captureCurrentStack;
+
+  /**
+   * The stack captured by the last call to recordUserStack, if it hasn't been
+   * cleared since, along with the number of frames to skip at its top.
+   *
+   * @type {?function(): !Array.<!gjstest.internal.StackFrame>}
+   */
+  this.capturedUserStack_ = null;
+  this.capturedUserStackSkip_ = 0;
 
   // Wrap the supplied failure reporting function in a version that adds nice
   // line number output if available.
   var me = this;
   this.reportFailure = function(message) {
-    var userStack = me.userStack;
-    // Don't print out the last 2 frames, as they're always the same
-    // and internal to gjstest.
-    for (var i = 0; i < userStack.length - 2; i++) {
+    var userStack = me.getUserStack();
+
+    // Don't print out the last 2 frames if they belong to runTest and the
+    // function that called the test method, as they're always the same and
+    // internal to gjstest. Code resumed by a promise or a timer isn't called
+    // from there.
+    var frameCount = userStack.length;
+    if (frameCount >= 2 &&
+        /(^|\/)run_test\.js$/.test(userStack[frameCount - 1].fileName)) {
+      frameCount -= 2;
+    }
+
+    for (var i = 0; i < frameCount; i++) {
       var frame = userStack[i];
       message += '\n        at ' + frame.fileName + ':' + frame.lineNumber;
     }
@@ -99,10 +124,11 @@ gjstest.internal.TestEnvironment.prototype.reportFailure = function(message) {};
  */
 gjstest.internal.TestEnvironment.prototype.recordUserStack =
     function(excludedTopSize) {
-  // Get the current stack and remove the number of frames requested, plus one
-  // more for this function itself.
-  this.userStack = this.getCurrentStack_();
-  this.userStack.splice(0, excludedTopSize + 1);
+  // Capture the current stack, but don't look at it unless a failure is
+  // reported. Remember to remove the number of frames requested, plus one more
+  // for this function itself.
+  this.capturedUserStack_ = this.captureCurrentStack_();
+  this.capturedUserStackSkip_ = excludedTopSize + 1;
 };
 
 /**
@@ -110,16 +136,22 @@ gjstest.internal.TestEnvironment.prototype.recordUserStack =
  * from a functions that used recordUserStack.
  */
 gjstest.internal.TestEnvironment.prototype.clearUserStack = function() {
-  this.userStack.length = 0;
+  this.capturedUserStack_ = null;
 };
 
 /**
- * The last recorded user stack, or the empty array if none has been recorded or
- * the last one was cleared.
+ * Return the last recorded user stack, or the empty array if none has been
+ * recorded or the last one was cleared.
  *
- * @type {!Array.<!gjstest.internal.StackFrame>}
+ * @return {!Array.<!gjstest.internal.StackFrame>}
  */
-gjstest.internal.TestEnvironment.prototype.userStack;
+gjstest.internal.TestEnvironment.prototype.getUserStack = function() {
+  if (!this.capturedUserStack_) {
+    return [];
+  }
+
+  return this.capturedUserStack_().slice(this.capturedUserStackSkip_);
+};
 
 /**
  * The currently registered global test environment, used by public functions
@@ -16,13 +16,13 @@
 function TestEnvironmentTest() {
   this.log_ = createMockFunction();
   this.reportFailure_ = createMockFunction();
-  this.getCurrentStack_ = createMockFunction();
+  this.captureCurrentStack_ = createMockFunction();
 
   this.testEnv_ =
       new gjstest.internal.TestEnvironment(
           this.log_,
           this.reportFailure_,
-          this.getCurrentStack_);
+          this.captureCurrentStack_);
 }
 registerTestSuite(TestEnvironmentTest);
 
@@ -31,16 +31,16 @@ TestEnvironmentTest.prototype.MissingFunctions = function() {
   var me = this;
 
   expectThat(
-      function() { new TE(null, me.reportFailure_, me.getCurrentStack_) },
+      function() { new TE(null, me.reportFailure_, me.captureCurrentStack_) },
       throwsError(/TypeError.*log.*function/));
 
   expectThat(
-      function() { new TE(me.log_, null, me.getCurrentStack_) },
+      function() { new TE(me.log_, null, me.captureCurrentStack_) },
       throwsError(/TypeError.*reportFailure.*function/));
 
   expectThat(
       function() { new TE(me.log_, me.reportFailure_, null) },
-      throwsError(/TypeError.*getCurrentStack.*function/));
+      throwsError(/TypeError.*captureCurrentStack.*function/));
 };
 
 TestEnvironmentTest.prototype.Log = function() {
@@ -54,12 +54,39 @@ TestEnvironmentTest.prototype.ReportFailureWithoutUserStack = function() {
 };
 
 TestEnvironmentTest.prototype.ReportFailureWithUserStack = function() {
-  this.testEnv_.userStack.push({fileName: 'taco.js', lineNumber: 17});
-  this.testEnv_.userStack.push({fileName: 'taco.js', lineNumber: 27});
-  // Shouldn't print out the last 2 frames, as they're always the same
-  // and internal to gjstest.
-  this.testEnv_.userStack.push({fileName: 'register.js', lineNumber: 173});
-  this.testEnv_.userStack.push({fileName: 'run_test.js', lineNumber: 37});
+  var frames = [
+    {fileName: 'gjstest.js', lineNumber: 11},
+    {fileName: 'taco.js', lineNumber: 17},
+    {fileName: 'taco.js', lineNumber: 27},
+    // Shouldn't print out the last 2 frames, as they're always the same
+    // and internal to gjstest.
+    {fileName: 'register.js', lineNumber: 173},
+    {fileName: 'run_test.js', lineNumber: 37}
+  ];
+
+  expectCall(this.captureCurrentStack_)()
+      .willOnce(returnWith(function() { return frames; }));
+
+  this.testEnv_.recordUserStack(0);
+
+  expectCall(this.reportFailure_)('burrito\n' +
+      '        at taco.js:17\n' +
+      '        at taco.js:27');
+  this.testEnv_.reportFailure('burrito');
+};
+
+TestEnvironmentTest.prototype.ReportFailureAfterAwait = function() {
+  // Code resumed after an await isn't called by gjstest's own functions.
+  var frames = [
+    {fileName: 'gjstest.js', lineNumber: 11},
+    {fileName: 'taco.js', lineNumber: 17},
+    {fileName: 'taco.js', lineNumber: 27},
+  ];
+
+  expectCall(this.captureCurrentStack_)()
+      .willOnce(returnWith(function() { return frames; }));
+
+  this.testEnv_.recordUserStack(0);
 
   expectCall(this.reportFailure_)('burrito\n' +
       '        at taco.js:17\n' +
@@ -74,17 +101,24 @@ TestEnvironmentTest.prototype.RecordAndClearUserStack = function() {
   var frame2 = new gjstest.internal.StackFrame;
   var frame3 = new gjstest.internal.StackFrame;
 
-  expectCall(this.getCurrentStack_)()
-      .willOnce(returnWith([frame0, frame1, frame2, frame3]));
+  var getFrames = createMockFunction();
+  expectCall(this.captureCurrentStack_)()
+      .willOnce(returnWith(getFrames));
 
   // Ask the test environment to record the stack, skipping the first frame. It
-  // should skip the top two frames (skipping recordUserStack itself).
+  // shouldn't look at the frames yet.
   this.testEnv_.recordUserStack(1);
-  expectThat(this.testEnv_.userStack, elementsAre([frame2, frame3]));
+
+  // When asked for the stack, it should skip the top two frames (skipping
+  // recordUserStack itself).
+  expectCall(getFrames)()
+      .willOnce(returnWith([frame0, frame1, frame2, frame3]));
+
+  expectThat(this.testEnv_.getUserStack(), elementsAre([frame2, frame3]));
 
   // Now clear the recorded stack.
   this.testEnv_.clearUserStack();
-  expectThat(this.testEnv_.userStack, elementsAre([]));
+  expectThat(this.testEnv_.getUserStack(), elementsAre([]));
 };
 
 TestEnvironmentTest.prototype.UserStacksAreNotShared = function() {
@@ -92,7 +126,12 @@ TestEnvironmentTest.prototype.UserStacksAreNotShared = function() {
       new gjstest.internal.TestEnvironment(
           this.log_,
           this.reportFailure_,
-          this.getCurrentStack_);
+          this.captureCurrentStack_);
+
+  expectCall(this.captureCurrentStack_)()
+      .willOnce(returnWith(function() { return [{}, {}]; }));
 
-  expectNe(this.testEnv_.userStack, otherEnv.userStack);
+  this.testEnv_.recordUserStack(0);
+  expectThat(this.testEnv_.getUserStack(), elementsAre([_]));
+  expectThat(otherEnv.getUserStack(), elementsAre([]));
 };
@@ -0,0 +1,94 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, measure how fast
+// passing expectations are checked. Each test checks 100,000 of them, so
+// that the rate per second is 100,000 divided by the time taken. Matchers are
+// built inside the loops, as they are in real tests, so that the cost of
+// constructing them is included.
+
+function AssertionsBenchmark() { }
+registerTestSuite(AssertionsBenchmark);
+
+var kNumExpectations = 100000;
+
+AssertionsBenchmark.prototype.ExpectEq = function() {
+  for (var i = 0; i < kNumExpectations; ++i) {
+    expectEq(i, i);
+  }
+};
+
+AssertionsBenchmark.prototype.NumberMatchers = function() {
+  for (var i = 0; i < kNumExpectations; ++i) {
+    expectThat(i, allOf([greaterOrEqual(0), lessThan(kNumExpectations)]));
+  }
+};
+
+AssertionsBenchmark.prototype.NotEqual = function() {
+  for (var i = 0; i < kNumExpectations; ++i) {
+    expectThat(i, not(-1));
+  }
+};
+
+AssertionsBenchmark.prototype.ElementsAre = function() {
+  var element = { taco: 'burrito' };
+  for (var i = 0; i < kNumExpectations; ++i) {
+    expectThat([i, 'taco', element], elementsAre([i, 'taco', element]));
+  }
+};
+
+AssertionsBenchmark.prototype.ContainsObject = function() {
+  var elements = [{ taco: 1 }, { burrito: 2 }, { enchilada: 3 }];
+  for (var i = 0; i < kNumExpectations; ++i) {
+    expectThat(elements, contains(elements[i % elements.length]));
+  }
+};
+
+AssertionsBenchmark.prototype.HasSubstrOfLongString = function() {
+  var str = new Array(1001).join('taco');
+  for (var i = 0; i < kNumExpectations; ++i) {
+    expectThat(str, hasSubstr(str));
+  }
+};
+
+// Mock expectations capture a stack trace each, so there are fewer of them.
+// Only a few are called, as in tests that set up optional expectations.
+AssertionsBenchmark.prototype.MockExpectations = function() {
+  var kNumMockExpectations = 10000;
+
+  var f = createMockFunction();
+  for (var i = 0; i < kNumMockExpectations; ++i) {
+    expectCall(f)(i, contains(i), anyOf([isNull, 'taco']))
+        .willRepeatedly(returnWith(i));
+  }
+
+  for (var i = kNumMockExpectations - 100; i < kNumMockExpectations; ++i) {
+    expectEq(i, f(i, [i], null));
+  }
+};
+
+// A table-driven test, with an expectation for each of many primitive
+// arguments. Every expectation is called, oldest first.
+AssertionsBenchmark.prototype.MockExpectationTable = function() {
+  var kNumMockExpectations = 10000;
+
+  var f = createMockFunction();
+  for (var i = 0; i < kNumMockExpectations; ++i) {
+    expectCall(f)(i, 'taco').willOnce(returnWith(i));
+  }
+
+  for (var i = 0; i < kNumMockExpectations; ++i) {
+    expectEq(i, f(i, 'taco'));
+  }
+};
@@ -0,0 +1,70 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Control over the virtual clock on which timers run. Under the gjstest binary,
+// setTimeout, setInterval, Date and performance.now use a clock on which time
+// passes only when timers run, so tests can simulate long stretches of time
+// without waiting for them. Each test gets a fresh clock, starting at the same
+// time and with no timers pending. These functions are only available under
+// the gjstest binary.
+//
+// When a test returns a promise, the runner moves the clock on to each of the
+// test's timers in turn until the promise settles. Use the functions below to
+// do the same from synchronous code.
+
+/** @const */
+gjstest.clock = {};
+
+/**
+ * Move the current test's clock forward by the supplied number of
+ * milliseconds, running the timers that become due on the way, in order. A
+ * timer set by one of those timers also runs if it becomes due in time.
+ *
+ * Promise reactions queued by the timers don't run until the calling code
+ * returns or awaits.
+ *
+ * @param {number} ms
+ */
+gjstest.clock.tick = function(ms) {
+  gjstest.internal.getClockNatives_().tick(ms);
+};
+
+/**
+ * Run the current test's timers, including any they set, until there are none
+ * left, moving its clock forward to each in turn. Throws an error if that
+ * seems to go on forever, e.g. because of an interval that is never cleared.
+ */
+gjstest.clock.runAll = function() {
+  gjstest.internal.getClockNatives_().runAll();
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Return the clock natives, throwing an error if there aren't any.
+ *
+ * @return {{tick: function(number), runAll: function()}}
+ * @private
+ */
+gjstest.internal.getClockNatives_ = function() {
+  var natives = gjstest.internal.clockNatives;
+  if (!natives) {
+    throw new Error(
+        'The virtual clock is only available under the gjstest binary.');
+  }
+
+  return natives;
+};
@@ -0,0 +1,211 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The virtual clock exists only under the gjstest binary, so most of these
+// tests do nothing elsewhere.
+
+function ClockTest() {
+  this.log_ = [];
+}
+registerTestSuite(ClockTest);
+
+ClockTest.prototype.logLater_ = function(message) {
+  var log = this.log_;
+  return function() { log.push(message + '@' + performance.now()); };
+};
+
+ClockTest.prototype.NotUnderGjstestBinary = function() {
+  if (gjstest.internal.clockNatives) return;
+
+  expectThat(function() { gjstest.clock.tick(1); },
+             throwsError(/only available under the gjstest binary/));
+  expectThat(function() { gjstest.clock.runAll(); },
+             throwsError(/only available under the gjstest binary/));
+};
+
+ClockTest.prototype.EachTestStartsAfresh = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  // Earlier tests have moved their clocks on and left timers behind.
+  expectEq(0, performance.now());
+  gjstest.clock.runAll();
+  expectEq(0, performance.now());
+
+  setTimeout(this.logLater_('leftover'), 1000);
+  gjstest.clock.tick(3600 * 1000);
+  expectThat(this.log_, elementsAre(['leftover@1000']));
+};
+
+ClockTest.prototype.TickRunsDueTimersInOrder = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  setTimeout(this.logLater_('c'), 30);
+  setTimeout(this.logLater_('a'), 10);
+  setTimeout(this.logLater_('b'), 10);
+  setTimeout(this.logLater_('d'), 31);
+
+  gjstest.clock.tick(5);
+  expectThat(this.log_, elementsAre([]));
+  expectEq(5, performance.now());
+
+  gjstest.clock.tick(25);
+  expectThat(this.log_, elementsAre(['a@10', 'b@10', 'c@30']));
+  expectEq(30, performance.now());
+
+  gjstest.clock.tick(1);
+  expectThat(this.log_, elementsAre(['a@10', 'b@10', 'c@30', 'd@31']));
+};
+
+ClockTest.prototype.TickRunsTimersSetByTimers = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var logLater = this.logLater_.bind(this);
+  setTimeout(function() {
+    setTimeout(logLater('inner'), 10);
+    setTimeout(logLater('too late'), 100);
+  }, 10);
+
+  gjstest.clock.tick(50);
+  expectThat(this.log_, elementsAre(['inner@20']));
+};
+
+ClockTest.prototype.TimerArgumentsAndDelays = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var log = this.log_;
+  setTimeout(function(a, b) { log.push(a + b); }, 1, 'taco', 'burrito');
+  setTimeout(this.logLater_('negative'), -10);
+  setTimeout(this.logLater_('missing'));
+
+  gjstest.clock.tick(1);
+  expectThat(log, elementsAre(['negative@0', 'missing@0', 'tacoburrito']));
+
+  expectThat(function() { setTimeout('code', 1); },
+             throwsError(/setTimeout requires a function/));
+};
+
+ClockTest.prototype.ClearTimeout = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var id = setTimeout(this.logLater_('cleared'), 10);
+  setTimeout(this.logLater_('kept'), 10);
+  clearTimeout(id);
+  clearTimeout(id);
+  clearTimeout(undefined);
+
+  gjstest.clock.tick(10);
+  expectThat(this.log_, elementsAre(['kept@10']));
+};
+
+ClockTest.prototype.Intervals = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var log = this.log_;
+  var count = 0;
+  var id = setInterval(function() {
+    log.push(performance.now());
+    if (++count == 3) clearInterval(id);
+  }, 1000);
+
+  gjstest.clock.tick(3600 * 1000);
+  expectThat(log, elementsAre([1000, 2000, 3000]));
+};
+
+ClockTest.prototype.DateAndPerformanceNow = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var start = Date.now();
+  expectEq(start, new Date().getTime());
+  expectEq(0, performance.now());
+
+  gjstest.clock.tick(1.5);
+  expectEq(start + 1, Date.now());
+  expectEq(1.5, performance.now());
+
+  gjstest.clock.tick(86400 * 1000);
+  expectEq(start + 86400 * 1000 + 1, new Date().getTime());
+};
+
+ClockTest.prototype.DateConstructor = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  expectEq(0, new Date(0).getTime());
+  expectEq(Date.UTC(2012, 1, 3), new Date(Date.UTC(2012, 1, 3)).getTime());
+  expectEq(Date.parse('2012-02-03T00:00:00Z'),
+           new Date('2012-02-03T00:00:00Z').getTime());
+
+  expectEq('string', typeof Date());
+  expectTrue(new Date() instanceof Date);
+  expectEq(Date, new Date().constructor);
+
+  class MyDate extends Date {}
+  var myDate = new MyDate(17);
+  expectTrue(myDate instanceof MyDate);
+  expectEq(17, myDate.getTime());
+};
+
+ClockTest.prototype.TickRejectsBadDurations = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  expectThat(function() { gjstest.clock.tick(-1); },
+             throwsError(/non-negative number/));
+  expectThat(function() { gjstest.clock.tick(NaN); },
+             throwsError(/non-negative number/));
+  expectThat(function() { gjstest.clock.tick('1'); },
+             throwsError(/non-negative number/));
+};
+
+ClockTest.prototype.RunAll = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var logLater = this.logLater_.bind(this);
+  setTimeout(logLater('b'), 3600 * 1000);
+  setTimeout(function() { setTimeout(logLater('c'), 1); }, 3600 * 1000);
+  setTimeout(logLater('a'), 1);
+
+  gjstest.clock.runAll();
+  expectThat(this.log_, elementsAre(['a@1', 'b@3600000', 'c@3600001']));
+};
+
+ClockTest.prototype.RunAllGivesUpOnEndlessIntervals = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  setInterval(function() {}, 10);
+  expectThat(function() { gjstest.clock.runAll(); },
+             throwsError(/interval that is never cleared/));
+};
+
+ClockTest.prototype.ExceptionsInTimersFailTheTest = function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  var failures = [];
+  var env = gjstest.internal.currentTestEnvironment;
+  var reportFailure = env.reportFailure;
+  env.reportFailure = function(message) { failures.push(message); };
+
+  setTimeout(function() { throw new Error('taco'); }, 1);
+  setTimeout(this.logLater_('later'), 2);
+  gjstest.clock.tick(2);
+
+  env.reportFailure = reportFailure;
+  expectThat(failures, elementsAre([containsRegExp(/taco/)]));
+  expectThat(this.log_, elementsAre(['later@2']));
+};
+
+ClockTest.prototype.AsyncTestsWaitOnVirtualTime = async function() {
+  if (!gjstest.internal.clockNatives) return;
+
+  await new Promise(function(resolve) { setTimeout(resolve, 3600 * 1000); });
+  expectEq(3600 * 1000, performance.now());
+};
@@ -0,0 +1,186 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * Return a deep copy of the supplied fixture, for tests that need a pristine
+ * copy of a large object that they may modify. Use it as follows:
+ *
+ *     function MyTestFixture() {
+ *       this.table_ = cloneFixture(MyTestFixture.table_);
+ *     }
+ *     registerTestSuite(MyTestFixture);
+ *
+ *     MyTestFixture.setUpSuite = function() {
+ *       MyTestFixture.table_ = JSON.parse(hugeJsonString);
+ *     };
+ *
+ * The copy is made as by the structured clone algorithm: arrays, plain
+ * objects, Maps, Sets, Dates, RegExps, array buffers and typed arrays are all
+ * copied, and shared references and cycles are preserved. Other objects become
+ * plain objects holding copies of their own enumerable properties. Functions,
+ * symbols, errors, arguments objects and objects with hidden state such as
+ * Promises and WeakMaps can't be cloned, and cause an error to be thrown.
+ *
+ * The fixture is captured the first time it is cloned, and later calls make
+ * copies of that snapshot rather than of the fixture itself, so that they are
+ * cheap. Changes made to the fixture after it is first cloned are therefore
+ * not seen.
+ *
+ * @param {T} fixture
+ * @return {T}
+ * @template T
+ */
+gjstest.cloneFixture = function(fixture) {
+  // Primitives other than symbols are their own copies.
+  var type = typeof fixture;
+  if (fixture === null ||
+      (type != 'object' && type != 'function' && type != 'symbol')) {
+    return fixture;
+  }
+
+  // Under the gjstest binary, snapshots are serialized by V8 itself.
+  // Elsewhere, they are private copies made in JS.
+  var natives = gjstest.internal.natives;
+  var snapshots = gjstest.internal.fixtureSnapshots_;
+  var snapshot = snapshots.get(fixture);
+  if (!snapshot) {
+    snapshot = natives ?
+        natives.serializeValue(fixture) :
+        gjstest.internal.structuredCopy(fixture, new Map);
+    snapshots.set(fixture, snapshot);
+  }
+
+  return natives ?
+      natives.deserializeValue(snapshot) :
+      gjstest.internal.structuredCopy(snapshot, new Map);
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * The snapshots taken by gjstest.cloneFixture, keyed by fixture.
+ *
+ * @type {!WeakMap.<!Object, *>}
+ * @private
+ */
+gjstest.internal.fixtureSnapshots_ = new WeakMap;
+
+/**
+ * The JS implementation of the copying done by gjstest.cloneFixture, used where
+ * V8's serializer isn't available.
+ *
+ * @param {*} value
+ *     The value to copy.
+ *
+ * @param {!Map.<!Object, !Object>} copies
+ *     The copies already made of objects found within the outermost value.
+ *
+ * @return {*}
+ */
+gjstest.internal.structuredCopy = function(value, copies) {
+  var type = typeof value;
+  if (type == 'symbol') {
+    throw new TypeError(String(value) + ' could not be cloned.');
+  }
+
+  if (type == 'function') {
+    throw new TypeError(gjstest.stringify(value) + ' could not be cloned.');
+  }
+
+  if (type != 'object' || value === null) {
+    return value;
+  }
+
+  // Preserve shared references and cycles.
+  var copy = copies.get(value);
+  if (copy) {
+    return copy;
+  }
+
+  var copyValue = function(value) {
+    return gjstest.internal.structuredCopy(value, copies);
+  };
+
+  // Copy the contents of each kind of object that has them.
+  if (value instanceof ArrayBuffer) {
+    copy = value.slice(0);
+    copies.set(value, copy);
+    return copy;
+  }
+
+  if (ArrayBuffer.isView(value)) {
+    var buffer = copyValue(value.buffer);
+    copy = value instanceof DataView ?
+        new DataView(buffer, value.byteOffset, value.byteLength) :
+        new value.constructor(buffer, value.byteOffset, value.length);
+    copies.set(value, copy);
+    return copy;
+  }
+
+  var tag = Object.prototype.toString.call(value);
+  switch (tag) {
+    case '[object Arguments]':
+    case '[object Error]':
+    case '[object Promise]':
+    case '[object WeakMap]':
+    case '[object WeakSet]':
+      throw new TypeError(gjstest.stringify(value) + ' could not be cloned.');
+
+    case '[object Date]':
+      copy = new Date(value.getTime());
+      copies.set(value, copy);
+      return copy;
+
+    case '[object RegExp]':
+      copy = new RegExp(value.source, value.flags);
+      copies.set(value, copy);
+      return copy;
+
+    case '[object Boolean]':
+    case '[object Number]':
+    case '[object String]':
+      copy = Object(value.valueOf());
+      copies.set(value, copy);
+      return copy;
+
+    case '[object Map]':
+      copy = new Map;
+      copies.set(value, copy);
+      value.forEach(function(entryValue, key) {
+        copy.set(copyValue(key), copyValue(entryValue));
+      });
+      return copy;
+
+    case '[object Set]':
+      copy = new Set;
+      copies.set(value, copy);
+      value.forEach(function(element) {
+        copy.add(copyValue(element));
+      });
+      return copy;
+  }
+
+  // Anything else is copied property by property.
+  copy = Array.isArray(value) ? new Array(value.length) : {};
+  copies.set(value, copy);
+
+  var keys = Object.keys(value);
+  for (var i = 0; i < keys.length; ++i) {
+    copy[keys[i]] = copyValue(value[keys[i]]);
+  }
+
+  return copy;
+};
@@ -0,0 +1,60 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, measure how fast
+// copies of a large fixture are made. Each test makes 20 copies of a fixture
+// of 10,000 records, as a suite of 20 tests each wanting a pristine copy
+// might.
+
+function FixturesBenchmark() {}
+registerTestSuite(FixturesBenchmark);
+
+var kNumCopies = 20;
+
+// Build a fixture resembling parsed JSON records.
+FixturesBenchmark.setUpSuite = function() {
+  var records = [];
+  for (var i = 0; i < 10000; ++i) {
+    records.push({
+      id: i,
+      name: 'record ' + i,
+      tags: ['taco', 'burrito', String(i % 17)],
+      location: {lat: i / 7, lng: -i / 11},
+      active: i % 2 == 0,
+    });
+  }
+
+  FixturesBenchmark.fixture = {records: records};
+};
+
+FixturesBenchmark.prototype.JsonRoundTrip = function() {
+  var fixture = FixturesBenchmark.fixture;
+  for (var i = 0; i < kNumCopies; ++i) {
+    JSON.parse(JSON.stringify(fixture));
+  }
+};
+
+FixturesBenchmark.prototype.CloneFixture = function() {
+  var fixture = FixturesBenchmark.fixture;
+  for (var i = 0; i < kNumCopies; ++i) {
+    cloneFixture(fixture);
+  }
+};
+
+FixturesBenchmark.prototype.StructuredCopy = function() {
+  var fixture = FixturesBenchmark.fixture;
+  for (var i = 0; i < kNumCopies; ++i) {
+    gjstest.internal.structuredCopy(fixture, new Map);
+  }
+};
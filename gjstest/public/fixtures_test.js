@@ -0,0 +1,135 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Check that the supplied function, given a value, returns a structured copy
+// of it. The same checks apply to both gjstest.cloneFixture, which uses V8's
+// serializer when it's available, and the JS copy used where it isn't.
+function checkCopies(copy) {
+  // Primitives.
+  expectEq(17, copy(17));
+  expectEq('taco', copy('taco'));
+  expectEq(true, copy(true));
+  expectEq(null, copy(null));
+  expectEq(undefined, copy(undefined));
+  expectTrue(isNaN(copy(NaN)));
+
+  // Nested objects and arrays.
+  var obj = {taco: [1, 'burrito', {enchilada: null}], queso: {salsa: 2}};
+  var objCopy = copy(obj);
+  expectNe(obj, objCopy);
+  expectNe(obj.taco, objCopy.taco);
+  expectNe(obj.taco[2], objCopy.taco[2]);
+  expectThat(objCopy, recursivelyEquals(obj));
+
+  // Class instances become plain objects.
+  function SomeClass() { this.taco = 1; }
+  SomeClass.prototype.burrito = function() {};
+  var instanceCopy = copy(new SomeClass);
+  expectFalse(instanceCopy instanceof SomeClass);
+  expectThat(instanceCopy, recursivelyEquals({taco: 1}));
+
+  // Shared references and cycles.
+  var shared = {taco: 1};
+  var cyclic = {a: shared, b: shared};
+  cyclic.self = cyclic;
+  var cyclicCopy = copy(cyclic);
+  expectNe(shared, cyclicCopy.a);
+  expectEq(cyclicCopy.a, cyclicCopy.b);
+  expectEq(cyclicCopy, cyclicCopy.self);
+
+  // Maps and sets.
+  var map = new Map([['taco', {burrito: 1}]]);
+  var mapCopy = copy(map);
+  expectTrue(mapCopy instanceof Map);
+  expectNe(map.get('taco'), mapCopy.get('taco'));
+  expectThat(mapCopy.get('taco'), recursivelyEquals({burrito: 1}));
+
+  var set = new Set([1, 'taco']);
+  var setCopy = copy(set);
+  expectTrue(setCopy instanceof Set);
+  expectThat(Array.from(setCopy), elementsAre([1, 'taco']));
+
+  // Dates and regular expressions.
+  var date = new Date(1985, 5, 7);
+  var dateCopy = copy(date);
+  expectNe(date, dateCopy);
+  expectEq(date.getTime(), dateCopy.getTime());
+
+  var regExpCopy = copy(/ta+co/gi);
+  expectEq('ta+co', regExpCopy.source);
+  expectEq('gi', regExpCopy.flags);
+
+  // Typed arrays sharing a buffer.
+  var buffer = new ArrayBuffer(8);
+  var views = [new Uint8Array(buffer, 2, 4), new Float32Array(buffer, 4, 1)];
+  views[0][0] = 17;
+  var viewsCopy = copy(views);
+  expectNe(buffer, viewsCopy[0].buffer);
+  expectEq(viewsCopy[0].buffer, viewsCopy[1].buffer);
+  expectTrue(viewsCopy[1] instanceof Float32Array);
+  expectEq(2, viewsCopy[0].byteOffset);
+  expectEq(4, viewsCopy[0].length);
+  expectEq(17, viewsCopy[0][0]);
+
+  // Values that can't be cloned.
+  expectThat(function() { copy(function foo() {}); },
+             throwsError(/could not be cloned/));
+  expectThat(function() { copy({taco: Symbol('burrito')}); },
+             throwsError(/could not be cloned/));
+  expectThat(function() { copy([new WeakMap]); },
+             throwsError(/could not be cloned/));
+}
+
+////////////////////////////////////////////////////////////////////////
+// cloneFixture
+////////////////////////////////////////////////////////////////////////
+
+function CloneFixtureTest() {}
+registerTestSuite(CloneFixtureTest);
+
+CloneFixtureTest.prototype.Copies = function() {
+  checkCopies(cloneFixture);
+};
+
+CloneFixtureTest.prototype.CopiesAreIndependent = function() {
+  var fixture = {taco: [1, 2, 3]};
+
+  var copy1 = cloneFixture(fixture);
+  copy1.taco.push(4);
+
+  var copy2 = cloneFixture(fixture);
+  expectThat(copy2.taco, elementsAre([1, 2, 3]));
+  expectThat(fixture.taco, elementsAre([1, 2, 3]));
+};
+
+CloneFixtureTest.prototype.CopiesFirstSnapshot = function() {
+  var fixture = {taco: 1};
+  cloneFixture(fixture);
+
+  fixture.taco = 2;
+  expectThat(cloneFixture(fixture), recursivelyEquals({taco: 1}));
+};
+
+////////////////////////////////////////////////////////////////////////
+// structuredCopy
+////////////////////////////////////////////////////////////////////////
+
+function StructuredCopyTest() {}
+registerTestSuite(StructuredCopyTest);
+
+StructuredCopyTest.prototype.Copies = function() {
+  checkCopies(function(value) {
+    return gjstest.internal.structuredCopy(value, new Map);
+  });
+};
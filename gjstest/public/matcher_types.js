@@ -62,37 +62,75 @@ gjstest.Predicate;
  * @param {!gjstest.Predicate} predicate
  *     A predicate defining the set of values that should be matched.
  *
+ * @param {*=} opt_descriptionArg
+ *     A value passed to description functions.
+ *
+ * Descriptions are only needed when an expectation fails, so matchers should
+ * pass functions for any description that takes work to build. Each function
+ * is called at most once, with the matcher as this and opt_descriptionArg as
+ * its argument, and the result is reused. Matchers can therefore share
+ * description functions rather than creating closures for each instance.
+ *
  * @constructor
  */
-gjstest.Matcher = function(description, negativeDescription, predicate) {
+gjstest.Matcher = function(
+    description, negativeDescription, predicate, opt_descriptionArg) {
   this.predicate = predicate;
+  this.description_ = description;
+  this.negativeDescription_ = negativeDescription;
+  this.descriptionArg_ = opt_descriptionArg;
+};
 
-  if (description instanceof Function) {
-    this.getDescription = description;
-  } else {
-    this.getDescription =
-        function() { return /** @type {string} */ (description); };
+/**
+ * Return a description of objects matched by this matcher.
+ *
+ * @return {string}
+ */
+gjstest.Matcher.prototype.getDescription = function() {
+  if (this.description_ instanceof Function) {
+    this.description_ = this.description_(this.descriptionArg_);
   }
 
-  if (negativeDescription instanceof Function) {
-    this.getNegativeDescription = negativeDescription;
-  } else {
-    this.getNegativeDescription =
-        function() { return /** @type {string} */ (negativeDescription); };
+  return /** @type {string} */ (this.description_);
+};
+
+/**
+ * Return a description of objects not matched by this matcher.
+ *
+ * @return {string}
+ */
+gjstest.Matcher.prototype.getNegativeDescription = function() {
+  if (this.negativeDescription_ instanceof Function) {
+    this.negativeDescription_ =
+        this.negativeDescription_(this.descriptionArg_);
   }
+
+  return /** @type {string} */ (this.negativeDescription_);
 };
 
 /**
- * A function that returns a description of objects matched by this matcher.
- * @type {function():string}
+ * The description, or a function that computes it.
+ *
+ * @type {(string|function():string)}
+ * @private
+ */
+gjstest.Matcher.prototype.description_;
+
+/**
+ * The negative description, or a function that computes it.
+ *
+ * @type {(string|function():string)}
+ * @private
  */
-gjstest.Matcher.prototype.getDescription;
+gjstest.Matcher.prototype.negativeDescription_;
 
 /**
- * A function that returns a description of objects not matched by this matcher.
- * @type {function():string}
+ * The value passed to the description functions.
+ *
+ * @type {*}
+ * @private
  */
-gjstest.Matcher.prototype.getNegativeDescription;
+gjstest.Matcher.prototype.descriptionArg_;
 
 /**
  * The predicate that defines the set of objects matched by this matcher.
@@ -115,6 +153,64 @@ gjstest.Matcher.prototype.predicate;
  */
 gjstest.Matcher.prototype.understandsMissingArgs = false;
 
+/**
+ * An optional function that, given a value the predicate didn't match, returns
+ * a description of where it differs from what was expected, or null if there is
+ * nothing to add to the value's description. expectThat adds this to its
+ * failure messages, which helps with large values whose descriptions are long
+ * or truncated.
+ *
+ * @type {?function(*):?string}
+ */
+gjstest.Matcher.prototype.describeDifferences = null;
+
+/**
+ * If the predicate returns true for exactly those values that are identical
+ * (===) to some primitive, the key that gjstest.internal.getPrimitiveKey
+ * returns for that primitive. Otherwise null.
+ *
+ * Mock functions use this to skip call expectations whose matchers can't match
+ * a call's arguments without evaluating them.
+ *
+ * @type {?string}
+ */
+gjstest.Matcher.prototype.primitiveKey = null;
+
+/**
+ * If primitiveKey isn't null, the primitive it was computed from.
+ *
+ * @type {*}
+ */
+gjstest.Matcher.prototype.primitiveValue;
+
+/**
+ * Return a string that identifies the supplied value if it's a number, string,
+ * boolean, null, or undefined, such that two values get the same string iff
+ * they're identical (===). Return null for other values, and for NaN.
+ *
+ * @param {*} value
+ * @return {?string}
+ */
+gjstest.internal.getPrimitiveKey = function(value) {
+  switch (typeof(value)) {
+    case 'number':
+      // NaN isn't identical to anything. 0 and -0 are identical, and both
+      // become '0'.
+      return value === value ? 'number:' + value : null;
+
+    case 'string':
+      return 'string:' + value;
+
+    case 'boolean':
+      return value ? 'true' : 'false';
+
+    case 'undefined':
+      return 'undefined';
+  }
+
+  return value === null ? 'null' : null;
+};
+
 /**
  * A special sentinel object for missing arguments in mock function calls, used
  * for implementing matching of missing arguments. See
@@ -0,0 +1,89 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+function MatcherTest() {}
+registerTestSuite(MatcherTest);
+
+MatcherTest.prototype.StringDescriptions = function() {
+  var matcher = new gjstest.Matcher('is a taco', 'is not a taco', function() {});
+
+  expectEq('is a taco', matcher.getDescription());
+  expectEq('is not a taco', matcher.getNegativeDescription());
+};
+
+MatcherTest.prototype.FunctionDescriptionsAreComputedOnDemand = function() {
+  var calls = [];
+  var matcher = new gjstest.Matcher(
+      function() { calls.push(this); return 'is a taco'; },
+      function() { calls.push(this); return 'is not a taco'; },
+      function() { return true; });
+
+  // Nothing should be computed until asked for.
+  expectTrue(matcher.predicate(17));
+  expectEq(0, calls.length);
+
+  // Each function should then be called once, with the matcher as this.
+  expectEq('is a taco', matcher.getDescription());
+  expectEq('is a taco', matcher.getDescription());
+  expectEq('is not a taco', matcher.getNegativeDescription());
+  expectEq('is not a taco', matcher.getNegativeDescription());
+
+  expectThat(calls, elementsAre([matcher, matcher]));
+};
+
+MatcherTest.prototype.FunctionDescriptionsReceiveDescriptionArg = function() {
+  var describe = function(x) { return 'is ' + x; };
+  var describeNot = function(x) { return 'is not ' + x; };
+
+  var taco = new gjstest.Matcher(describe, describeNot, function() {}, 'taco');
+  var burrito =
+      new gjstest.Matcher(describe, describeNot, function() {}, 'burrito');
+
+  expectEq('is taco', taco.getDescription());
+  expectEq('is not taco', taco.getNegativeDescription());
+  expectEq('is burrito', burrito.getDescription());
+  expectEq('is not burrito', burrito.getNegativeDescription());
+};
+
+////////////////////////////////////////////////////////////////////////
+// getPrimitiveKey
+////////////////////////////////////////////////////////////////////////
+
+function GetPrimitiveKeyTest() {}
+registerTestSuite(GetPrimitiveKeyTest);
+
+GetPrimitiveKeyTest.prototype.Primitives = function() {
+  var getPrimitiveKey = gjstest.internal.getPrimitiveKey;
+  var values = [0, 1, 1.5, -1, Infinity, '', '0', '1', 'true', 'null', true,
+                false, null, undefined];
+
+  for (var i = 0; i < values.length; ++i) {
+    for (var j = 0; j < values.length; ++j) {
+      var keysEqual = getPrimitiveKey(values[i]) === getPrimitiveKey(values[j]);
+      expectEq(i == j, keysEqual, 'Values ' + i + ' and ' + j);
+    }
+  }
+
+  expectEq(getPrimitiveKey(0), getPrimitiveKey(-0));
+};
+
+GetPrimitiveKeyTest.prototype.NonPrimitives = function() {
+  var getPrimitiveKey = gjstest.internal.getPrimitiveKey;
+
+  expectEq(null, getPrimitiveKey(NaN));
+  expectEq(null, getPrimitiveKey({}));
+  expectEq(null, getPrimitiveKey([]));
+  expectEq(null, getPrimitiveKey(new String('taco')));
+  expectEq(null, getPrimitiveKey(function() {}));
+};
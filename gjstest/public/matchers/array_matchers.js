@@ -54,45 +54,55 @@ gjstest.elementsAre = function(matchers) {
     throw new TypeError('elementsAre requires an array or Arguments argument.');
   }
 
-  // Iteratively build up a description that looks like:
-  //
-  //     [ anything, 2, object evaluating to false ]
-  //
-  // as well as a transformed list of matchers where we've substituted equals(x)
-  // for each raw x.
-  var matcherDescriptions = [];
+  // Build a transformed list of matchers where we've substituted equals(x) for
+  // each raw x. Keep a copy of the originals for the description.
+  var values = [];
   var transformedMatchers = [];
 
   for (var i = 0; i < matchers.length; ++i) {
     var val = matchers[i];
+    values.push(val);
 
     // Is this actually a matcher?
     if (val && val instanceof gjstest.Matcher) {
-      matcherDescriptions.push(val.getDescription());
       transformedMatchers.push(val);
       continue;
     }
 
     // Otherwise, use equals(val).
-    matcherDescriptions.push(gjstest.stringify(val));
     transformedMatchers.push(gjstest.equals(val));
   }
 
-  var description =
-      'is an array or Arguments object of length ' + matchers.length +
-      ' with elements matching: [ ' + matcherDescriptions.join(', ') + ' ]';
+  // Build up a description that looks like:
+  //
+  //     [ anything, 2, object evaluating to false ]
+  //
+  var getDescription = function() {
+    // Special case.
+    if (values.length == 0) {
+      return 'is an empty array or Arguments object';
+    }
 
-  var negativeDescription = description.replace('is an', 'is not an');
+    var matcherDescriptions = [];
+    for (var i = 0; i < values.length; ++i) {
+      var val = values[i];
+      matcherDescriptions.push(
+          val && val instanceof gjstest.Matcher ?
+              val.getDescription() :
+              gjstest.stringify(val));
+    }
 
-  // Special case.
-  if (matchers.length == 0) {
-    description = 'is an empty array or Arguments object';
-    negativeDescription = 'is not an empty array or Arguments object';
-  }
+    return 'is an array or Arguments object of length ' + values.length +
+        ' with elements matching: [ ' + matcherDescriptions.join(', ') + ' ]';
+  };
 
-  return new gjstest.Matcher(
-      description,
-      negativeDescription,
+  var getNegativeDescription = function() {
+    return this.getDescription().replace('is an', 'is not an');
+  };
+
+  var result = new gjstest.Matcher(
+      getDescription,
+      getNegativeDescription,
       function(obj) {
         // Is this object an array or Arguments object of the appropriate
         // length?
@@ -116,6 +126,13 @@ gjstest.elementsAre = function(matchers) {
         return true;
       }
   );
+
+  // Show where long arrays differ, if the elements are plain values.
+  result.describeDifferences = function(obj) {
+    return gjstest.internal.describeDiff(values, obj);
+  };
+
+  return result;
 };
 
 /**
@@ -138,19 +155,22 @@ gjstest.elementsAre = function(matchers) {
  */
 gjstest.contains = function(x) {
   // Is this actually a matcher?
-  var matcher;
-  var nounPhrase;
-  if (x && x instanceof gjstest.Matcher) {
-    matcher = x;
-    nounPhrase = 'an element that ' + matcher.getDescription();
-  } else {
-    matcher = gjstest.equals(x);
-    nounPhrase = gjstest.stringify(x);
-  }
+  var isMatcher = x && x instanceof gjstest.Matcher;
+  var matcher = isMatcher ? x : gjstest.equals(x);
+
+  var getNounPhrase = function() {
+    return isMatcher ?
+        'an element that ' + matcher.getDescription() :
+        gjstest.stringify(x);
+  };
 
   return new gjstest.Matcher(
-      'is an array or Arguments object containing ' + nounPhrase,
-      'is not an array or Arguments object containing ' + nounPhrase,
+      function() {
+        return 'is an array or Arguments object containing ' + getNounPhrase();
+      },
+      function() {
+        return this.getDescription().replace('is an', 'is not an');
+      },
       function(candidate) {
         if (!gjstest.internal.isArrayLike(candidate)) {
           return "which isn't an array or Arguments object";
@@ -188,8 +208,8 @@ gjstest.whenSorted = function(matcher) {
   }
 
   return new gjstest.Matcher(
-      'when sorted, ' + matcher.getDescription(),
-      'when sorted, ' + matcher.getNegativeDescription(),
+      function() { return 'when sorted, ' + matcher.getDescription(); },
+      function() { return 'when sorted, ' + matcher.getNegativeDescription(); },
       function(candidate) {
         if (!(candidate instanceof Array)) {
           return 'which isn\'t an array';
@@ -206,3 +226,360 @@ gjstest.whenSorted = function(matcher) {
         return false;
       });
 };
+
+/**
+ * Match arrays and Arguments objects with the same length as matchers, whose
+ * elements can be paired off with the matchers such that each element matches
+ * its matcher. This is elementsAre for arrays whose order is undefined.
+ *
+ * For example:
+ *
+ *     // Passes
+ *     expectThat([19, 'taco', 17], unorderedElementsAre([17, 19, _]));
+ *
+ * Expected values that aren't matchers, and equals matchers for primitives, are
+ * counted by value, so large arrays of primitives are compared in linear time.
+ * Other matchers are paired off with the elements left over by that, which
+ * takes time proportional to the product of their numbers.
+ *
+ * @param {!Array|{length:number}} matchers
+ *     An array-like list of matchers that the elements of the array must
+ *     satisfy. If an element x is not a gjstest.Matcher, it is treated as the
+ *     matcher equals(x).
+ *
+ * @return {!gjstest.Matcher}
+ */
+gjstest.unorderedElementsAre = function(matchers) {
+  if (!gjstest.internal.isArrayLike(matchers)) {
+    gjstest.internal.currentTestEnvironment.recordUserStack(1);
+    throw new TypeError(
+        'unorderedElementsAre requires an array or Arguments argument.');
+  }
+
+  var values = Array.prototype.slice.call(matchers);
+
+  return new gjstest.Matcher(
+      function() {
+        if (values.length == 0) {
+          return 'is an empty array or Arguments object';
+        }
+
+        return 'is an array or Arguments object of length ' + values.length +
+            ' with elements matching in any order: ' +
+            gjstest.internal.describeElementMatchers_(values);
+      },
+      function() {
+        return this.getDescription().replace('is an', 'is not an');
+      },
+      function(candidate) {
+        if (!gjstest.internal.isArrayLike(candidate)) {
+          return "which isn't an array or Arguments object";
+        } else if (candidate.length !== values.length) {
+          return 'which has length ' + candidate.length;
+        }
+
+        var unmatched = gjstest.internal.pairElements_(values, candidate);
+        if (unmatched.values.length == 0) {
+          return true;
+        }
+
+        return 'which has no element matching: ' +
+            gjstest.internal.describeElementMatchers_(unmatched.values) +
+            ', and whose unmatched elements are: ' +
+            gjstest.internal.describeElementMatchers_(unmatched.elements);
+      });
+};
+
+/**
+ * Match arrays and Arguments objects that contain a different element matching
+ * each of the supplied matchers, in any order. Elements not needed for that
+ * are ignored.
+ *
+ * For example:
+ *
+ *     expectThat([17, 19, 23], containsAll([19, 17]));     // Passes
+ *     expectThat([17, 19, 23], containsAll([17, 17]));     // Fails
+ *
+ * Like unorderedElementsAre, this counts expected primitives by value.
+ *
+ * @param {!Array|{length:number}} matchers
+ *     An array-like list of matchers, each of which a different element of the
+ *     array must satisfy. If an element x is not a gjstest.Matcher, it is
+ *     treated as the matcher equals(x).
+ *
+ * @return {!gjstest.Matcher}
+ */
+gjstest.containsAll = function(matchers) {
+  if (!gjstest.internal.isArrayLike(matchers)) {
+    gjstest.internal.currentTestEnvironment.recordUserStack(1);
+    throw new TypeError('containsAll requires an array or Arguments argument.');
+  }
+
+  var values = Array.prototype.slice.call(matchers);
+
+  return new gjstest.Matcher(
+      function() {
+        return 'is an array or Arguments object containing elements ' +
+            'matching each of: ' +
+            gjstest.internal.describeElementMatchers_(values);
+      },
+      function() {
+        return this.getDescription().replace('is an', 'is not an');
+      },
+      function(candidate) {
+        if (!gjstest.internal.isArrayLike(candidate)) {
+          return "which isn't an array or Arguments object";
+        }
+
+        var unmatched = gjstest.internal.pairElements_(values, candidate);
+        if (unmatched.values.length == 0) {
+          return true;
+        }
+
+        return 'which has no element matching: ' +
+            gjstest.internal.describeElementMatchers_(unmatched.values);
+      });
+};
+
+/**
+ * The most elements that describeElementMatchers_ lists before summarizing the
+ * rest.
+ *
+ * @type {number}
+ * @const
+ */
+gjstest.internal.kMaxDescribedElements_ = 10;
+
+/**
+ * Describe a list of expected values or matchers in the manner of elementsAre,
+ * listing at most the first few.
+ *
+ * @param {!Array} values
+ * @return {string}
+ */
+gjstest.internal.describeElementMatchers_ = function(values) {
+  var limit = gjstest.internal.kMaxDescribedElements_;
+
+  var descriptions = [];
+  for (var i = 0; i < values.length && i < limit; ++i) {
+    var val = values[i];
+    descriptions.push(
+        val && val instanceof gjstest.Matcher ?
+            val.getDescription() :
+            gjstest.stringify(val));
+  }
+
+  if (values.length > limit) {
+    descriptions.push('(' + (values.length - limit) + ' more)');
+  }
+
+  return '[ ' + descriptions.join(', ') + ' ]';
+};
+
+/**
+ * Return true iff gjstest.internal.getPrimitiveKey would return a key for the
+ * supplied value, without building the key.
+ *
+ * @param {*} value
+ * @return {boolean}
+ */
+gjstest.internal.hasPrimitiveKey_ = function(value) {
+  switch (typeof(value)) {
+    case 'number':
+      return value === value;
+
+    case 'string':
+    case 'boolean':
+    case 'undefined':
+      return true;
+  }
+
+  return value === null;
+};
+
+/**
+ * Pair off as many of the supplied expected values with different elements of
+ * the candidate as possible, such that each element matches its value, and
+ * return the values and elements left over.
+ *
+ * Values that must be identical to some primitive are paired off by counting
+ * first. Since identical elements are interchangeable this never costs a
+ * pairing, and it leaves only the remaining matchers to be paired off by
+ * searching for augmenting paths.
+ *
+ * @param {!Array} values
+ *     Matchers, or values that are treated as equals(x).
+ *
+ * @param {!Array|{length:number}} candidate
+ *
+ * @return {{values: !Array, elements: !Array}}
+ */
+gjstest.internal.pairElements_ = function(values, candidate) {
+  // Count the primitives, and set the other matchers aside. Maps compare keys
+  // the way === does, except for NaN, which isn't counted.
+  var counts = new Map;
+  var counted = new Array(values.length);
+  var matchers = [];
+
+  for (var i = 0; i < values.length; ++i) {
+    var val = values[i];
+    var isMatcher = val && val instanceof gjstest.Matcher;
+
+    if (isMatcher ?
+            val.primitiveKey !== null :
+            gjstest.internal.hasPrimitiveKey_(val)) {
+      var primitive = isMatcher ? val.primitiveValue : val;
+      counts.set(primitive, (counts.get(primitive) || 0) + 1);
+      counted[i] = true;
+      continue;
+    }
+
+    matchers.push(isMatcher ? val : gjstest.equals(val));
+  }
+
+  // Pair off the elements identical to those primitives.
+  var elements = [];
+  for (var i = 0; i < candidate.length; ++i) {
+    var element = candidate[i];
+    var count = counts.size == 0 ? 0 : (counts.get(element) || 0);
+
+    if (count > 0) {
+      counts.set(element, count - 1);
+    } else {
+      elements.push(element);
+    }
+  }
+
+  // Pair off the remaining matchers with the remaining elements.
+  var elementPairs = gjstest.internal.findMaximumMatching_(matchers, elements);
+
+  var result = {values: [], elements: []};
+
+  var pairedMatchers = new Array(matchers.length);
+  for (var i = 0; i < elements.length; ++i) {
+    if (elementPairs[i] == -1) {
+      result.elements.push(elements[i]);
+    } else {
+      pairedMatchers[elementPairs[i]] = true;
+    }
+  }
+
+  // Collect the values left over, in their original order.
+  var matcherIndex = 0;
+  for (var i = 0; i < values.length; ++i) {
+    var val = values[i];
+
+    if (!counted[i]) {
+      if (!pairedMatchers[matcherIndex++]) {
+        result.values.push(val);
+      }
+
+      continue;
+    }
+
+    var primitive =
+        val && val instanceof gjstest.Matcher ? val.primitiveValue : val;
+
+    if (counts.get(primitive) > 0) {
+      counts.set(primitive, counts.get(primitive) - 1);
+      result.values.push(val);
+    }
+  }
+
+  return result;
+};
+
+/**
+ * Find a maximum matching in the bipartite graph with an edge between each
+ * matcher and each element that it matches, using Kuhn's algorithm. Return an
+ * array giving the index of the matcher paired with each element, or -1.
+ *
+ * @param {!Array.<!gjstest.Matcher>} matchers
+ * @param {!Array} elements
+ * @return {!Array.<number>}
+ */
+gjstest.internal.findMaximumMatching_ = function(matchers, elements) {
+  var elementPairs = new Array(elements.length);
+  for (var j = 0; j < elements.length; ++j) {
+    elementPairs[j] = -1;
+  }
+
+  if (matchers.length == 0) {
+    return elementPairs;
+  }
+
+  // Find the elements that each matcher matches.
+  var edges = [];
+  var order = [];
+
+  for (var i = 0; i < matchers.length; ++i) {
+    var predicate = matchers[i].predicate;
+    var matched = [];
+
+    for (var j = 0; j < elements.length; ++j) {
+      if (predicate(elements[j]) === true) matched.push(j);
+    }
+
+    edges.push(matched);
+    order.push(i);
+  }
+
+  // Greedily pair off what we can, starting with the matchers that match the
+  // fewest elements. That's often all of them, leaving nothing to search for.
+  order.sort(function(a, b) { return edges[a].length - edges[b].length; });
+
+  var unpaired = [];
+  for (var k = 0; k < order.length; ++k) {
+    var matched = edges[order[k]];
+    var paired = false;
+
+    for (var m = 0; m < matched.length && !paired; ++m) {
+      if (elementPairs[matched[m]] == -1) {
+        elementPairs[matched[m]] = order[k];
+        paired = true;
+      }
+    }
+
+    if (!paired) unpaired.push(order[k]);
+  }
+
+  // Try to find an augmenting path starting at each matcher left over. The
+  // search is iterative so that long paths can't overflow the stack.
+  for (var u = 0; u < unpaired.length; ++u) {
+    var visited = new Uint8Array(elements.length);
+    var path = [unpaired[u]];
+    var positions = [0];
+    var via = [];
+
+    while (path.length > 0) {
+      var top = path.length - 1;
+      var matched = edges[path[top]];
+
+      if (positions[top] == matched.length) {
+        path.pop();
+        positions.pop();
+        via.pop();
+        continue;
+      }
+
+      var j = matched[positions[top]++];
+      if (visited[j]) continue;
+      visited[j] = 1;
+      via[top] = j;
+
+      // If the element is free, flip the pairings along the path.
+      if (elementPairs[j] == -1) {
+        for (var k = 0; k <= top; ++k) {
+          elementPairs[via[k]] = path[k];
+        }
+
+        break;
+      }
+
+      path.push(elementPairs[j]);
+      positions.push(0);
+    }
+  }
+
+  return elementPairs;
+};
@@ -0,0 +1,62 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, compare ways of
+// checking the contents of large arrays whose order is undefined.
+
+function ArrayMatchersBenchmark() { }
+registerTestSuite(ArrayMatchersBenchmark);
+
+var kNumElements = 100000;
+
+// The numbers [0, kNumElements) in a scrambled order, and the same numbers
+// sorted as whenSorted sorts them.
+var kScrambled = [];
+for (var i = 0; i < kNumElements; ++i) {
+  kScrambled.push((i * 7919) % kNumElements);
+}
+
+var kSortedAsStrings = kScrambled.concat([]).sort();
+
+ArrayMatchersBenchmark.prototype.WhenSorted = function() {
+  expectThat(kScrambled, whenSorted(elementsAre(kSortedAsStrings)));
+};
+
+ArrayMatchersBenchmark.prototype.UnorderedElementsAre = function() {
+  expectThat(kScrambled, unorderedElementsAre(kSortedAsStrings));
+};
+
+ArrayMatchersBenchmark.prototype.ContainsAll = function() {
+  expectThat(kScrambled, containsAll(kSortedAsStrings.slice(0, 50000)));
+};
+
+ArrayMatchersBenchmark.prototype.ContainsEach = function() {
+  // What containsAll replaces, for a much smaller number of elements.
+  for (var i = 0; i < 1000; ++i) {
+    expectThat(kScrambled, contains(kSortedAsStrings[i]));
+  }
+};
+
+ArrayMatchersBenchmark.prototype.ArbitraryMatchers = function() {
+  // Each matcher matches about half of the elements, so the search has plenty
+  // of choices to make.
+  var matchers = [];
+  var elements = [];
+  for (var i = 0; i < 1000; ++i) {
+    matchers.push(greaterOrEqual(i));
+    elements.push(1000 - i);
+  }
+
+  expectThat(elements, unorderedElementsAre(matchers));
+};
@@ -391,3 +391,286 @@ WhenSortedTest.prototype.WrappedPredicateReturnsTrue = function() {
 
   expectTrue(matcher.predicate([]));
 };
+
+////////////////////////////////////////////////////////////////////////
+// unorderedElementsAre
+////////////////////////////////////////////////////////////////////////
+
+function UnorderedElementsAreTest() {}
+registerTestSuite(UnorderedElementsAreTest);
+
+UnorderedElementsAreTest.prototype.NonArrayArgument = function() {
+  expectThat(function() { unorderedElementsAre(null) },
+             throwsError(/TypeError.*unorderedElementsAre.*array or Arg/));
+
+  expectThat(function() { unorderedElementsAre(2) },
+             throwsError(/TypeError.*unorderedElementsAre.*array or Arg/));
+};
+
+UnorderedElementsAreTest.prototype.NonArrayCandidates = function() {
+  var pred = unorderedElementsAre([]).predicate;
+
+  expectEq('which isn\'t an array or Arguments object', pred(undefined));
+  expectEq('which isn\'t an array or Arguments object', pred(null));
+  expectEq('which isn\'t an array or Arguments object', pred({}));
+  expectEq('which isn\'t an array or Arguments object', pred(2));
+};
+
+UnorderedElementsAreTest.prototype.WrongLength = function() {
+  var pred = unorderedElementsAre([1, 2]).predicate;
+
+  expectEq('which has length 0', pred([]));
+  expectEq('which has length 3', pred([1, 2, 3]));
+};
+
+UnorderedElementsAreTest.prototype.Primitives = function() {
+  var pred =
+      unorderedElementsAre([1, 'taco', null, undefined, true, 1]).predicate;
+
+  expectTrue(pred([1, 'taco', null, undefined, true, 1]));
+  expectTrue(pred([undefined, 1, true, 1, 'taco', null]));
+  expectTrue(pred(returnArgs(null, 1, 1, 'taco', undefined, true)));
+
+  expectThat(pred([1, 'taco', null, undefined, true, '1']),
+             containsRegExp(/no element matching: \[ 1 \].*: \[ '1' \]/));
+
+  expectThat(pred([1, 'taco', null, null, true, 1]),
+             containsRegExp(/no element matching: \[ undefined \]/));
+
+  expectThat(pred([1, 'taco', null, undefined, true, true]),
+             containsRegExp(/no element matching: \[ 1 \].*: \[ true \]/));
+};
+
+UnorderedElementsAreTest.prototype.EqualsMatchers = function() {
+  var pred = unorderedElementsAre([equals(2), equals('2')]).predicate;
+
+  expectTrue(pred(['2', 2]));
+  expectThat(pred([2, 2]), containsRegExp(/no element matching: \[ '2' \]/));
+};
+
+UnorderedElementsAreTest.prototype.ObjectsAreComparedByReference = function() {
+  var obj = {};
+  var pred = unorderedElementsAre([obj, 1]).predicate;
+
+  expectTrue(pred([1, obj]));
+  expectThat(pred([1, {}]), containsRegExp(/no element matching/));
+};
+
+UnorderedElementsAreTest.prototype.NaN = function() {
+  var pred = unorderedElementsAre([NaN]).predicate;
+  expectThat(pred([NaN]), containsRegExp(/no element matching: \[ NaN \]/));
+
+  var isNan = new gjstest.Matcher('is NaN', 'is not NaN', function(x) {
+    return x !== x;
+  });
+
+  pred = unorderedElementsAre([isNan]).predicate;
+  expectTrue(pred([NaN]));
+};
+
+UnorderedElementsAreTest.prototype.ArbitraryMatchers = function() {
+  var pred =
+      unorderedElementsAre([
+        lessThan(10),
+        greaterThan(0),
+        containsRegExp(/taco/),
+      ]).predicate;
+
+  expectTrue(pred([5, 'taco', 50]));
+  expectTrue(pred(['burrito taco', 50, 5]));
+  expectTrue(pred([5, -1, 'taco']));
+
+  expectThat(pred([5, 50, 'burrito']),
+             containsRegExp(/no element matching: \[ .*taco.* \]/));
+};
+
+UnorderedElementsAreTest.prototype.GreedyPairingIsUndone = function() {
+  var pred =
+      unorderedElementsAre([
+        greaterThan(1),
+        lessThan(6),
+        lessThan(1),
+      ]).predicate;
+
+  // lessThan(1) must take 0, and greaterThan(1) may take 5 if it goes next.
+  // Then lessThan(6) can only have 5 if greaterThan(1) takes 10 instead.
+  expectTrue(pred([0, 5, 10]));
+  expectTrue(pred([10, 5, 0]));
+};
+
+UnorderedElementsAreTest.prototype.MixedMatchersAndPrimitives = function() {
+  var pred = unorderedElementsAre([1, _, 1, greaterThan(1)]).predicate;
+
+  expectTrue(pred([1, 1, 1, 2]));
+  expectTrue(pred([2, 1, 'taco', 1]));
+
+  expectThat(
+      pred([1, 2, 'taco', 'burrito']),
+      containsRegExp(
+          /no element matching: \[ 1 \].*elements are: \[ 'burrito' \]/));
+};
+
+UnorderedElementsAreTest.prototype.ReportsAtMostTenElements = function() {
+  var expected = [];
+  var actual = [];
+  for (var i = 0; i < 15; ++i) {
+    expected.push(i);
+    actual.push(i + 100);
+  }
+
+  var result = unorderedElementsAre(expected).predicate(actual);
+
+  expectThat(result, containsRegExp(/\[ 0, 1, .*, 9, \(5 more\) \]/));
+  expectThat(result, containsRegExp(/\[ 100, 101, .*, 109, \(5 more\) \]/));
+};
+
+UnorderedElementsAreTest.prototype.LargeArrays = function() {
+  var expected = [];
+  var actual = [];
+  for (var i = 0; i < 100000; ++i) {
+    expected.push(i % 1000);
+    actual.push((99999 - i) % 1000);
+  }
+
+  expectTrue(unorderedElementsAre(expected).predicate(actual));
+
+  actual[7] = 'taco';
+  expectThat(unorderedElementsAre(expected).predicate(actual),
+             containsRegExp(/no element matching: \[ 992 \]/));
+};
+
+UnorderedElementsAreTest.prototype.Descriptions = function() {
+  var matcher = unorderedElementsAre([17, containsRegExp(/taco/)]);
+
+  expectEq('is an array or Arguments object of length 2 with elements ' +
+               'matching in any order: [ 17, partially matches regex: /taco/ ]',
+           matcher.getDescription());
+
+  expectEq('is not an array or Arguments object of length 2 with elements ' +
+               'matching in any order: [ 17, partially matches regex: /taco/ ]',
+           matcher.getNegativeDescription());
+
+  matcher = unorderedElementsAre([]);
+  expectEq('is an empty array or Arguments object', matcher.getDescription());
+  expectEq('is not an empty array or Arguments object',
+           matcher.getNegativeDescription());
+};
+
+////////////////////////////////////////////////////////////////////////
+// containsAll
+////////////////////////////////////////////////////////////////////////
+
+function ContainsAllTest() {}
+registerTestSuite(ContainsAllTest);
+
+ContainsAllTest.prototype.NonArrayArgument = function() {
+  expectThat(function() { containsAll(null) },
+             throwsError(/TypeError.*containsAll.*array or Arguments/));
+
+  expectThat(function() { containsAll('taco') },
+             throwsError(/TypeError.*containsAll.*array or Arguments/));
+};
+
+ContainsAllTest.prototype.NonArrayCandidates = function() {
+  var pred = containsAll([]).predicate;
+
+  expectEq('which isn\'t an array or Arguments object', pred(undefined));
+  expectEq('which isn\'t an array or Arguments object', pred(null));
+  expectEq('which isn\'t an array or Arguments object', pred(2));
+};
+
+ContainsAllTest.prototype.NoMatchers = function() {
+  var pred = containsAll([]).predicate;
+
+  expectTrue(pred([]));
+  expectTrue(pred([1, 2]));
+};
+
+ContainsAllTest.prototype.Primitives = function() {
+  var pred = containsAll([17, 'taco', 17]).predicate;
+
+  expectTrue(pred([17, 'taco', 17]));
+  expectTrue(pred([19, 17, 23, 'taco', 'burrito', 17]));
+  expectTrue(pred(returnArgs(17, 17, 'taco')));
+
+  expectEq('which has no element matching: [ 17 ]',
+           pred([17, 'taco', 19]));
+
+  expectEq('which has no element matching: [ 17, \'taco\', 17 ]',
+           pred([]));
+};
+
+ContainsAllTest.prototype.ArbitraryMatchers = function() {
+  var pred = containsAll([lessThan(10), lessThan(5), 7]).predicate;
+
+  expectTrue(pred([4, 9, 7]));
+  expectTrue(pred([100, 4, 7, 3]));
+
+  // Only one element is less than 10 besides the 7 that's needed.
+  expectEq('which has no element matching: [ is less than 5 ]',
+           pred([100, 4, 7]));
+};
+
+ContainsAllTest.prototype.LargeArrays = function() {
+  var actual = [];
+  for (var i = 0; i < 100000; ++i) {
+    actual.push('item ' + i);
+  }
+
+  var expected = actual.filter(function(x, i) { return i % 3 == 0; });
+  expectTrue(containsAll(expected).predicate(actual));
+
+  expected.push('item 0');
+  expectEq('which has no element matching: [ \'item 0\' ]',
+           containsAll(expected).predicate(actual));
+};
+
+ContainsAllTest.prototype.Descriptions = function() {
+  var matcher = containsAll([17, lessThan(3)]);
+
+  expectEq('is an array or Arguments object containing elements matching ' +
+               'each of: [ 17, is less than 3 ]',
+           matcher.getDescription());
+
+  expectEq('is not an array or Arguments object containing elements ' +
+               'matching each of: [ 17, is less than 3 ]',
+           matcher.getNegativeDescription());
+};
+
+////////////////////////////////////////////////////////////////////////
+// Descriptions
+////////////////////////////////////////////////////////////////////////
+
+function ArrayMatcherDescriptionsTest() {}
+registerTestSuite(ArrayMatcherDescriptionsTest);
+
+ArrayMatcherDescriptionsTest.prototype.AreComputedOnDemand = function() {
+  var valueCalls = 0;
+  var value = { toString: function() { ++valueCalls; return 'taco'; } };
+
+  var innerCalls = 0;
+  var inner = new gjstest.Matcher(
+      function() { ++innerCalls; return 'is a taco'; },
+      function() { ++innerCalls; return 'is not a taco'; },
+      function() {});
+
+  var matchers = [
+    elementsAre([value, inner]),
+    contains(value),
+    contains(inner),
+    whenSorted(inner),
+    unorderedElementsAre([value, inner]),
+    containsAll([value, inner]),
+  ];
+
+  expectEq(0, valueCalls);
+  expectEq(0, innerCalls);
+
+  for (var i = 0; i < matchers.length; ++i) {
+    matchers[i].getDescription();
+    matchers[i].getNegativeDescription();
+  }
+
+  expectEq(2, innerCalls);
+  expectThat(valueCalls, greaterThan(0));
+};
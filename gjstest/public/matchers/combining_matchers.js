@@ -62,23 +62,18 @@ gjstest.allOf = function(matchers) {
     return matchers[0];
   }
 
-  // Otherwise, build an appropriate description. Also keep track of whether
-  // every matcher supports missing args, since we should support them only if
-  // every sub-matcher does.
-  var descriptions = [];
-  var negativeDescriptions = [];
+  // Otherwise, keep track of whether every matcher supports missing args,
+  // since we should support them only if every sub-matcher does.
   var understandsMissingArgs = true;
 
   for (var i = 0; i < matchers.length; ++i) {
-    descriptions[i] = matchers[i].getDescription();
-    negativeDescriptions[i] = matchers[i].getNegativeDescription();
     understandsMissingArgs =
         understandsMissingArgs && matchers[i].understandsMissingArgs;
   }
 
   var result = new gjstest.Matcher(
-      descriptions.join(', and '),
-      negativeDescriptions.join(', or '),
+      gjstest.internal.joinDescriptions_(matchers, false, ', and '),
+      gjstest.internal.joinDescriptions_(matchers, true, ', or '),
       function(candidate) {
         for (var i = 0; i < matchers.length; ++i) {
           var result = matchers[i].predicate(candidate);
@@ -146,18 +141,9 @@ gjstest.anyOf = function(matchers) {
     return matchers[0];
   }
 
-  // Otherwise, build an appropriate description.
-  var descriptions = [];
-  var negativeDescriptions = [];
-
-  for (var i = 0; i < matchers.length; ++i) {
-    descriptions[i] = matchers[i].getDescription();
-    negativeDescriptions[i] = matchers[i].getNegativeDescription();
-  }
-
   var result = new gjstest.Matcher(
-      descriptions.join(', or '),
-      negativeDescriptions.join(', and '),
+      gjstest.internal.joinDescriptions_(matchers, false, ', or '),
+      gjstest.internal.joinDescriptions_(matchers, true, ', and '),
       function(candidate) {
         for (var i = 0; i < matchers.length; ++i) {
           // Special case: don't pass on the missing arg sentinel if the matcher
@@ -198,8 +184,8 @@ gjstest.not = function(x) {
   }
 
   return new gjstest.Matcher(
-      matcher.getNegativeDescription(),
-      matcher.getDescription(),
+      function() { return matcher.getNegativeDescription(); },
+      function() { return matcher.getDescription(); },
       function(obj) {
         // Ask the inner matcher.
         var innerResult = matcher.predicate(obj);
@@ -213,3 +199,32 @@ gjstest.not = function(x) {
         return !innerResult;
       });
 };
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Return a function that joins the descriptions, or negative descriptions, of
+ * the supplied matchers with the supplied separator.
+ *
+ * @param {!Array.<!gjstest.Matcher>} matchers
+ * @param {boolean} negative
+ * @param {string} separator
+ * @return {function():string}
+ *
+ * @private
+ */
+gjstest.internal.joinDescriptions_ = function(matchers, negative, separator) {
+  return function() {
+    var descriptions = [];
+    for (var i = 0; i < matchers.length; ++i) {
+      descriptions.push(
+          negative ?
+              matchers[i].getNegativeDescription() :
+              matchers[i].getDescription());
+    }
+
+    return descriptions.join(separator);
+  };
+};
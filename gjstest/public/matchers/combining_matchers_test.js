@@ -331,3 +331,30 @@ NotTest.prototype.Description = function() {
   expectEq('burrito', matcher.getDescription());
   expectEq('taco', matcher.getNegativeDescription());
 };
+
+////////////////////////////////////////////////////////////////////////
+// Descriptions
+////////////////////////////////////////////////////////////////////////
+
+function CombiningMatcherDescriptionsTest() {}
+registerTestSuite(CombiningMatcherDescriptionsTest);
+
+CombiningMatcherDescriptionsTest.prototype.AreComputedOnDemand = function() {
+  var calls = [];
+  var inner = new gjstest.Matcher(
+      function() { calls.push('positive'); return 'is a taco'; },
+      function() { calls.push('negative'); return 'is not a taco'; },
+      function() {});
+
+  var allOfMatcher = allOf([inner, inner]);
+  var anyOfMatcher = anyOf([inner, inner]);
+  var notMatcher = not(inner);
+  expectThat(calls, elementsAre([]));
+
+  expectEq('is a taco, and is a taco', allOfMatcher.getDescription());
+  expectEq('is not a taco, and is not a taco',
+           anyOfMatcher.getNegativeDescription());
+  expectEq('is not a taco', notMatcher.getDescription());
+
+  expectThat(calls, elementsAre(['positive', 'negative']));
+};
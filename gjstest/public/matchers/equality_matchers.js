@@ -65,7 +65,7 @@ gjstest.equals = function(rhs) {
     return 'does not equal: ' + gjstest.stringify(rhs);
   };
 
-  return new gjstest.Matcher(
+  var result = new gjstest.Matcher(
       getDescription,
       getNegativeDescription,
       function(obj) {
@@ -88,6 +88,19 @@ gjstest.equals = function(rhs) {
         return false;
       }
   );
+
+  // Primitives match only themselves, so mock functions can index them.
+  result.primitiveKey = gjstest.internal.getPrimitiveKey(rhs);
+  result.primitiveValue = rhs;
+
+  // Strings are compared by value, so show where long ones differ.
+  if (typeof(rhs) == 'string') {
+    result.describeDifferences = function(obj) {
+      return gjstest.internal.describeDiff(rhs, obj);
+    };
+  }
+
+  return result;
 };
 
 /**
@@ -166,8 +179,7 @@ gjstest.recursivelyEquals = function(expected) {
     var compareResult =
         gjstest.internal.compareRecursively_(
             /** @type {!Object} */(expected),
-            actual,
-            '');
+            actual);
 
     return compareResult || true;
   };
@@ -180,10 +192,16 @@ gjstest.recursivelyEquals = function(expected) {
     return 'does not recursively equal ' + gjstest.stringify(expected);
   };
 
-  return new gjstest.Matcher(
+  var result = new gjstest.Matcher(
       getDescription,
       getNegativeDescription,
       predicate);
+
+  result.describeDifferences = function(actual) {
+    return gjstest.internal.describeDiff(expected, actual);
+  };
+
+  return result;
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -194,14 +212,19 @@ gjstest.recursivelyEquals = function(expected) {
  * Decide whether the supplied object contains a cycle.
  *
  * @param {(!Object|!Array)} obj
+ * @param {Array.<!Object>=} opt_ancestors
+ *     The nodes on the path from the root to obj, for recursive calls.
  * @return {boolean}
  *
  * @private
  */
-gjstest.internal.containsCycle_ = function(obj) {
+gjstest.internal.containsCycle_ = function(obj, opt_ancestors) {
   // Do a depth-first search of the object, regarding elements that aren't
-  // Objects or Arrays as leaves and keeping track of the non-leaf nodes we've
-  // already seen.
+  // Objects or Arrays as leaves and keeping track of the non-leaf nodes on the
+  // path to the current one. Keep the path on the side rather than marking the
+  // nodes, so that the objects aren't modified.
+  var ancestors = opt_ancestors || [];
+
   for (var key in obj) {
     var node = obj[key];
 
@@ -210,18 +233,14 @@ gjstest.internal.containsCycle_ = function(obj) {
       continue;
     }
 
-    // Have we already seen this node?
-    if (node.__gjstest_containsCycle_already_seen) return true;
+    // Have we already seen this node on the way down?
+    if (ancestors.indexOf(node) != -1) return true;
 
-    // Mark this node as having already been seen; clean up later.
-    node.__gjstest_containsCycle_already_seen = true;
-
-    // See if any of the node's children contain a reference to something we've
-    // already seen.
-    var foundCycle = gjstest.internal.containsCycle_(node);
-
-    // Clean up the property we set above.
-    delete node.__gjstest_containsCycle_already_seen;
+    // See if any of the node's children contain a reference to it or one of
+    // its ancestors.
+    ancestors.push(node);
+    var foundCycle = gjstest.internal.containsCycle_(node, ancestors);
+    ancestors.pop();
 
     if (foundCycle) return true;
   }
@@ -230,24 +249,72 @@ gjstest.internal.containsCycle_ = function(obj) {
 };
 
 /**
- * Compare the two supplied objects recursively, keeping track of the full chain
- * of keys, for use in error messages.
+ * A difference found by gjstest.internal.findDifference_.
+ *
+ * @param {string} prefix
+ * @param {string} suffix
+ * @param {string} key
+ * @constructor
+ *
+ * @private
+ */
+gjstest.internal.RecursiveDifference_ = function(prefix, suffix, key) {
+  /**
+   * The text before and after the path to the difference in its description.
+   * @type {string}
+   */
+  this.prefix = prefix;
+  this.suffix = suffix;
+
+  /**
+   * The keys leading to the difference, innermost first.
+   * @type {!Array.<string>}
+   */
+  this.reversedPath = [key];
+};
+
+/**
+ * Compare the two supplied objects recursively, returning a description of the
+ * first difference found, or null if there is none.
+ *
+ * @param {(!Object|!Array)} lhs
+ * @param {(!Object|!Array)} rhs
+ * @return {?string}
+ *
+ * @private
+ */
+gjstest.internal.compareRecursively_ = function(lhs, rhs) {
+  var difference = gjstest.internal.findDifference_(lhs, rhs);
+  if (!difference) return null;
+
+  // Only now that there is a difference to describe, build the full chain of
+  // keys leading to it.
+  var path = difference.reversedPath;
+  var keyPath = '';
+  for (var i = path.length - 1; i >= 0; --i) {
+    keyPath = keyPath ? keyPath + '.' + path[i] : path[i];
+  }
+
+  return difference.prefix + keyPath + difference.suffix;
+};
+
+/**
+ * Find the first difference between the two supplied objects, comparing them
+ * recursively.
  *
  * @param {(!Object|!Array)} lhs
  * @param {(!Object|!Array)} rhs
- * @param {string} keyPrefix
- * @return {string?}
+ * @return {gjstest.internal.RecursiveDifference_}
  *
  * @private
  */
-gjstest.internal.compareRecursively_ = function(lhs, rhs, keyPrefix) {
+gjstest.internal.findDifference_ = function(lhs, rhs) {
+  var Difference = gjstest.internal.RecursiveDifference_;
+
   // Iterate over the keys in lhs, checking each one against rhs.
   for (var key in lhs) {
-    // Compute the full path to this key.
-    var keyPath = keyPrefix ? keyPrefix + '.' + key : key;
-
     if (!(key in rhs)) {
-      return 'which differs in key ' + keyPath;
+      return new Difference('which differs in key ', '', key);
     }
 
     // If the value for this key is not a plain Object or Array, compare it for
@@ -259,8 +326,10 @@ gjstest.internal.compareRecursively_ = function(lhs, rhs, keyPrefix) {
     if (lhsValue instanceof gjstest.Matcher) {
       var matches = lhsValue.predicate(rhsValue);
       if (matches == true) continue;
-      return 'which does not satisfy matcher for key ' + keyPath +
-          ' (' + (matches || lhsValue.getNegativeDescription()) + ')';
+      return new Difference(
+          'which does not satisfy matcher for key ',
+          ' (' + (matches || lhsValue.getNegativeDescription()) + ')',
+          key);
     }
 
     if (!lhsValue ||
@@ -276,37 +345,36 @@ gjstest.internal.compareRecursively_ = function(lhs, rhs, keyPrefix) {
         if (lhsValue['gjstestEquals'](rhsValue)) {
           continue;
         } else {
-          return 'which differs in value for key ' + keyPath;
+          return new Difference('which differs in value for key ', '', key);
         }
       }
 
       // Return a special error for things that are compared by reference.
       if (lhsValue instanceof Object) {
-        return 'which differs in reference for key ' + keyPath;
+        return new Difference('which differs in reference for key ', '', key);
       }
 
-      return 'which differs in value for key ' + keyPath;
+      return new Difference('which differs in value for key ', '', key);
     }
 
     // Otherwise, we'll want to compare recursively. Make sure that the rhs
     // value is of the same type.
     if (!rhsValue || rhsValue.constructor != lhsValue.constructor) {
-      return 'which has wrong type for key ' + keyPath;
+      return new Difference('which has wrong type for key ', '', key);
     }
 
     // Compare recursively.
-    var subResult =
-        gjstest.internal.compareRecursively_(lhsValue, rhsValue, keyPath);
-    if (subResult) return subResult;
+    var subResult = gjstest.internal.findDifference_(lhsValue, rhsValue);
+    if (subResult) {
+      subResult.reversedPath.push(key);
+      return subResult;
+    }
   }
 
   // rhs should also be a subset of lhs.
   for (var key in rhs) {
-    // Compute the full path to this key.
-    var keyPath = keyPrefix ? keyPrefix + '.' + key : key;
-
     if (!(key in lhs)) {
-      return 'which differs in key ' + keyPath;
+      return new Difference('which differs in key ', '', key);
     }
   }
 
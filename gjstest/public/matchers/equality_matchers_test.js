@@ -202,6 +202,23 @@ EqualsTest.prototype.GjstestEqualsWithDifferentTypes = function() {
   expectEq('which is a reference to a different object', pred(new MyClass2));
 };
 
+EqualsTest.prototype.PrimitiveKey = function() {
+  var getPrimitiveKey = gjstest.internal.getPrimitiveKey;
+
+  expectEq(getPrimitiveKey(17), equals(17).primitiveKey);
+  expectEq(getPrimitiveKey('taco'), equals('taco').primitiveKey);
+  expectEq(getPrimitiveKey(null), equals(null).primitiveKey);
+  expectEq(getPrimitiveKey(undefined), equals(undefined).primitiveKey);
+
+  expectEq(null, equals(NaN).primitiveKey);
+  expectEq(null, equals({}).primitiveKey);
+  expectEq(null, _.primitiveKey);
+
+  expectEq(17, equals(17).primitiveValue);
+  expectEq('taco', equals('taco').primitiveValue);
+  expectEq(null, equals(null).primitiveValue);
+};
+
 ////////////////////////////////////////////////////////////////////////
 // isNull
 ////////////////////////////////////////////////////////////////////////
@@ -289,6 +306,31 @@ RecursivelyEqualsTest.prototype.SelfReferenceInExpected = function() {
   expectFalse('__gjstest_containsCycle_already_seen' in nonTree);
 };
 
+RecursivelyEqualsTest.prototype.SelfReferenceInFrozenExpected = function() {
+  var nonTree = {foo: {bar: [17]}};
+  nonTree.foo.bar.push(nonTree.foo);
+
+  Object.freeze(nonTree.foo.bar);
+  Object.freeze(nonTree.foo);
+  Object.freeze(nonTree);
+
+  var expected = /TypeError.*recursivelyEquals.*non-tree/;
+  expectThat(function() { recursivelyEquals(nonTree); }, throwsError(expected));
+};
+
+RecursivelyEqualsTest.prototype.SharedSubtreesInExpected = function() {
+  var shared = {taco: [1, 2]};
+  var obj = {foo: shared, bar: [shared, shared]};
+
+  var pred = recursivelyEquals(obj).predicate;
+  expectTrue(pred({foo: {taco: [1, 2]}, bar: [{taco: [1, 2]}, shared]}));
+  expectEq('which differs in value for key bar.1.taco.0',
+           pred({foo: shared, bar: [shared, {taco: [3, 2]}]}));
+
+  expectThat(Object.keys(shared), elementsAre(['taco']));
+  expectThat(Object.keys(obj), elementsAre(['foo', 'bar']));
+};
+
 RecursivelyEqualsTest.prototype.SelfReferenceInActual = function() {
   var pred;
   var someObj = {foo: 2, bar: [17]};
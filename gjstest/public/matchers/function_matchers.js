@@ -26,12 +26,9 @@ gjstest.throwsError = function(re) {
     throw new TypeError('throwsError requires a RegExp argument.');
   }
 
-  var description = 'is a function that throws an error matching ' + re;
-  var negativeDescription = description.replace('is a', 'is not a');
-
   return new gjstest.Matcher(
-      description,
-      negativeDescription,
+      gjstest.internal.describeThrowsError_,
+      gjstest.internal.describeNotThrowsError_,
       function(func) {
         // The argument must be a function that takes no arguments.
         if (!(func instanceof Function)) {
@@ -50,6 +47,35 @@ gjstest.throwsError = function(re) {
         }
 
         return 'which threw no errors';
-      }
-  );
+      },
+      re);
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Describe throwsError, given its regular expression. This and the function
+ * below are shared by all matchers rather than created for each one.
+ *
+ * @param {!RegExp} re
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeThrowsError_ = function(re) {
+  return 'is a function that throws an error matching ' + re;
+};
+
+/**
+ * Describe the negation of throwsError.
+ *
+ * @param {!RegExp} re
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNotThrowsError_ = function(re) {
+  return 'is not a function that throws an error matching ' + re;
 };
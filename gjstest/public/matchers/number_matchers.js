@@ -26,12 +26,13 @@ gjstest.greaterThan = function(x) {
   }
 
   return new gjstest.Matcher(
-      'is greater than ' + x,
-      'is less than or equal to ' + x,
+      gjstest.internal.describeGreaterThan_,
+      gjstest.internal.describeLessOrEqual_,
       function(actual) {
         return typeof(actual) == 'number' ?
             actual > x : 'which is not a number';
-      });
+      },
+      x);
 };
 
 /**
@@ -47,12 +48,13 @@ gjstest.greaterOrEqual = function(x) {
   }
 
   return new gjstest.Matcher(
-      'is greater than or equal to ' + x,
-      'is less than ' + x,
+      gjstest.internal.describeGreaterOrEqual_,
+      gjstest.internal.describeLessThan_,
       function(actual) {
         return typeof(actual) == 'number' ?
             actual >= x : 'which is not a number';
-      });
+      },
+      x);
 };
 
 /**
@@ -68,12 +70,13 @@ gjstest.lessThan = function(x) {
   }
 
   return new gjstest.Matcher(
-      'is less than ' + x,
-      'is greater than or equal to ' + x,
+      gjstest.internal.describeLessThan_,
+      gjstest.internal.describeGreaterOrEqual_,
       function(actual) {
         return typeof(actual) == 'number' ?
             actual < x : 'which is not a number';
-      });
+      },
+      x);
 };
 
 /**
@@ -89,12 +92,13 @@ gjstest.lessOrEqual = function(x) {
   }
 
   return new gjstest.Matcher(
-      'is less than or equal to ' + x,
-      'is greater than ' + x,
+      gjstest.internal.describeLessOrEqual_,
+      gjstest.internal.describeGreaterThan_,
       function(actual) {
         return typeof(actual) == 'number' ?
             actual <= x : 'which is not a number';
-      });
+      },
+      x);
 };
 
 /**
@@ -111,11 +115,90 @@ gjstest.isNearNumber = function(x, absoluteError) {
   }
 
   return new gjstest.Matcher(
-      'is a number within ' + absoluteError + ' of ' + x,
-      'is not a number within ' + absoluteError + ' of ' + x,
+      gjstest.internal.describeNear_,
+      gjstest.internal.describeNotNear_,
       function(actual) {
         if (typeof(actual) != 'number') return 'which is not a number';
 
         return Math.abs(x - actual) <= absoluteError;
-      });
+      },
+      [x, absoluteError]);
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Describe greaterThan, or the negation of lessOrEqual, given the number
+ * compared with. Like the functions below, this is shared by all matchers
+ * rather than created for each one.
+ *
+ * @param {number} x
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeGreaterThan_ = function(x) {
+  return 'is greater than ' + x;
+};
+
+/**
+ * Describe greaterOrEqual, or the negation of lessThan.
+ *
+ * @param {number} x
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeGreaterOrEqual_ = function(x) {
+  return 'is greater than or equal to ' + x;
+};
+
+/**
+ * Describe lessThan, or the negation of greaterOrEqual.
+ *
+ * @param {number} x
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeLessThan_ = function(x) {
+  return 'is less than ' + x;
+};
+
+/**
+ * Describe lessOrEqual, or the negation of greaterThan.
+ *
+ * @param {number} x
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeLessOrEqual_ = function(x) {
+  return 'is less than or equal to ' + x;
+};
+
+/**
+ * Describe isNearNumber, given the number and the absolute error as a pair.
+ *
+ * @param {!Array.<number>} args
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNear_ = function(args) {
+  return 'is a number within ' + args[1] + ' of ' + args[0];
+};
+
+/**
+ * Describe the negation of isNearNumber.
+ *
+ * @param {!Array.<number>} args
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNotNear_ = function(args) {
+  return 'is not a number within ' + args[1] + ' of ' + args[0];
 };
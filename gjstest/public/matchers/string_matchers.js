@@ -26,16 +26,44 @@ gjstest.containsRegExp = function(re) {
   }
 
   return new gjstest.Matcher(
-      'partially matches regex: ' + re,
-      'doesn\'t partially match regex: ' + re,
+      gjstest.internal.describeContainsRegExp_,
+      gjstest.internal.describeNotContainsRegExp_,
       function(candidate) {
         if (typeof(candidate) != 'string') {
           return 'which is not a string';
         }
 
         return re.test(candidate);
-      }
-  );
+      },
+      re);
+};
+
+/**
+ * Match strings that contain a match for the supplied RE2 pattern, given as a
+ * string, without an implied anchor to the start and end of the string. That
+ * is, 'a' matches 'bar'.
+ *
+ * Under the gjstest binary the pattern is matched by RE2, which takes time
+ * linear in the length of the string no matter the pattern, so prefer this to
+ * containsRegExp for checking large strings. Elsewhere the pattern is used as
+ * a JS regular expression, which understands most RE2 syntax.
+ *
+ * @param {string} pattern
+ * @return {!gjstest.Matcher}
+ */
+gjstest.containsRe2 = function(pattern) {
+  return gjstest.internal.makeRe2Matcher_('containsRe2', pattern, false);
+};
+
+/**
+ * Like containsRe2, but match only strings that match the pattern in full.
+ * That is, 'a' matches 'a' but not 'bar'.
+ *
+ * @param {string} pattern
+ * @return {!gjstest.Matcher}
+ */
+gjstest.fullMatchRe2 = function(pattern) {
+  return gjstest.internal.makeRe2Matcher_('fullMatchRe2', pattern, true);
 };
 
 /**
@@ -50,14 +78,163 @@ gjstest.hasSubstr = function(substr) {
   }
 
   return new gjstest.Matcher(
-      'is a string containing the substring ' + gjstest.stringify(substr),
-      'is not a string containing the substring ' + gjstest.stringify(substr),
+      gjstest.internal.describeHasSubstr_,
+      gjstest.internal.describeNotHasSubstr_,
       function(candidate) {
         if (typeof(candidate) != 'string') {
           return 'which is not a string';
         }
 
         return candidate.indexOf(substr) != -1;
-      }
-  );
+      },
+      substr);
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Create a matcher for containsRe2 or fullMatchRe2, with the supplied name.
+ *
+ * @param {string} name
+ * @param {string} pattern
+ * @param {boolean} fullMatch
+ * @return {!gjstest.Matcher}
+ *
+ * @private
+ */
+gjstest.internal.makeRe2Matcher_ = function(name, pattern, fullMatch) {
+  if (typeof(pattern) != 'string') {
+    throw new TypeError(name + ' requires a string argument.');
+  }
+
+  // Check the pattern up front, so that the error points at the matcher's
+  // creation. The natives compile each pattern once.
+  var natives = gjstest.internal.natives;
+  var test;
+  if (natives) {
+    natives.matchRe2(pattern, '', fullMatch);
+    test = function(candidate) {
+      return natives.matchRe2(pattern, candidate, fullMatch);
+    };
+  } else {
+    var re = new RegExp(fullMatch ? '^(?:' + pattern + ')$' : pattern);
+    test = function(candidate) { return re.test(candidate); };
+  }
+
+  return new gjstest.Matcher(
+      fullMatch ?
+          gjstest.internal.describeFullMatchRe2_ :
+          gjstest.internal.describeContainsRe2_,
+      fullMatch ?
+          gjstest.internal.describeNotFullMatchRe2_ :
+          gjstest.internal.describeNotContainsRe2_,
+      function(candidate) {
+        if (typeof(candidate) != 'string') {
+          return 'which is not a string';
+        }
+
+        return test(candidate);
+      },
+      pattern);
+};
+
+/**
+ * Describe containsRegExp, given its regular expression. This and the
+ * functions below are shared by all matchers rather than created for each
+ * one.
+ *
+ * @param {!RegExp} re
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeContainsRegExp_ = function(re) {
+  return 'partially matches regex: ' + re;
+};
+
+/**
+ * Describe the negation of containsRegExp.
+ *
+ * @param {!RegExp} re
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNotContainsRegExp_ = function(re) {
+  return 'doesn\'t partially match regex: ' + re;
+};
+
+/**
+ * Describe containsRe2, given its pattern.
+ *
+ * @param {string} pattern
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeContainsRe2_ = function(pattern) {
+  return 'partially matches RE2 pattern: ' + gjstest.stringify(pattern);
+};
+
+/**
+ * Describe the negation of containsRe2.
+ *
+ * @param {string} pattern
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNotContainsRe2_ = function(pattern) {
+  return 'doesn\'t partially match RE2 pattern: ' + gjstest.stringify(pattern);
+};
+
+/**
+ * Describe fullMatchRe2, given its pattern.
+ *
+ * @param {string} pattern
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeFullMatchRe2_ = function(pattern) {
+  return 'fully matches RE2 pattern: ' + gjstest.stringify(pattern);
+};
+
+/**
+ * Describe the negation of fullMatchRe2.
+ *
+ * @param {string} pattern
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNotFullMatchRe2_ = function(pattern) {
+  return 'doesn\'t fully match RE2 pattern: ' + gjstest.stringify(pattern);
+};
+
+/**
+ * Describe hasSubstr, given its substring.
+ *
+ * @param {string} substr
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeHasSubstr_ = function(substr) {
+  return 'is a string containing the substring ' + gjstest.stringify(substr);
+};
+
+/**
+ * Describe the negation of hasSubstr.
+ *
+ * @param {string} substr
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeNotHasSubstr_ = function(substr) {
+  return 'is not a string containing the substring ' +
+      gjstest.stringify(substr);
 };
@@ -0,0 +1,57 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, compare the RE2
+// matchers with containsRegExp on large strings, both for an ordinary pattern
+// that must scan the whole string and for one that makes a backtracking
+// implementation take exponential time.
+
+function StringMatchersBenchmark() { }
+registerTestSuite(StringMatchersBenchmark);
+
+// About 8 MB of log-like output that doesn't contain a match.
+var kLargeString = (function() {
+  var lines = [];
+  for (var i = 0; i < 100000; ++i) {
+    lines.push('I1018 12:34:56.789 ' + i + ' server.cc:123] Request taco ok');
+  }
+
+  return lines.join('\n');
+})();
+
+var kLargePattern = 'E\\d{4} [^\\n]*burrito';
+
+// A string that /^(a+)+$/ takes about 2^25 steps to reject.
+var kPathologicalString = new Array(26).join('a') + 'b';
+
+StringMatchersBenchmark.prototype.LargeStringRegExp = function() {
+  var re = new RegExp(kLargePattern);
+  for (var i = 0; i < 10; ++i) {
+    expectThat(kLargeString, not(containsRegExp(re)));
+  }
+};
+
+StringMatchersBenchmark.prototype.LargeStringRe2 = function() {
+  for (var i = 0; i < 10; ++i) {
+    expectThat(kLargeString, not(containsRe2(kLargePattern)));
+  }
+};
+
+StringMatchersBenchmark.prototype.PathologicalRegExp = function() {
+  expectThat(kPathologicalString, not(containsRegExp(/^(a+)+$/)));
+};
+
+StringMatchersBenchmark.prototype.PathologicalRe2 = function() {
+  expectThat(kPathologicalString, not(containsRe2('^(a+)+$')));
+};
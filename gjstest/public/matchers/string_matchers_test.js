@@ -78,6 +78,121 @@ ContainsRegExpTest.prototype.Description = function() {
            matcher.getNegativeDescription());
 };
 
+////////////////////////////////////////////////////////////////////////
+// containsRe2
+////////////////////////////////////////////////////////////////////////
+
+function ContainsRe2Test() {}
+registerTestSuite(ContainsRe2Test);
+
+ContainsRe2Test.prototype.WrongTypeArgs = function() {
+  function callFunc(arg) { return function() { containsRe2(arg) } }
+
+  expectThat(callFunc(null), throwsError(/TypeError.*containsRe2.*string/));
+  expectThat(callFunc(17), throwsError(/TypeError.*containsRe2.*string/));
+  expectThat(callFunc(/a/), throwsError(/TypeError.*containsRe2.*string/));
+};
+
+ContainsRe2Test.prototype.InvalidPattern = function() {
+  expectThat(function() { containsRe2('ta(co'); },
+             throwsError(/ta\(co/));
+};
+
+ContainsRe2Test.prototype.NonStringCandidates = function() {
+  var pred = containsRe2('.+taco.*').predicate;
+
+  expectEq('which is not a string', pred(null));
+  expectEq('which is not a string', pred(undefined));
+  expectEq('which is not a string', pred(17));
+  expectEq('which is not a string', pred([]));
+  expectEq('which is not a string', pred(function() {}));
+};
+
+ContainsRe2Test.prototype.PartialMatch = function() {
+  var pred = containsRe2('t.*o').predicate;
+
+  expectTrue(pred('to'));
+  expectTrue(pred('taco'));
+  expectTrue(pred('burrito and taco filling'));
+  expectFalse(pred(''));
+  expectFalse(pred('tac'));
+};
+
+ContainsRe2Test.prototype.AnchoredToEdges = function() {
+  var pred = containsRe2('^t.*o$').predicate;
+
+  expectTrue(pred('to'));
+  expectTrue(pred('taco'));
+  expectFalse(pred('burrito and taco filling'));
+};
+
+ContainsRe2Test.prototype.NonAsciiStrings = function() {
+  var pred = containsRe2('^caf.$').predicate;
+
+  expectTrue(pred('café'));
+  expectFalse(pred('cafés'));
+};
+
+ContainsRe2Test.prototype.PathologicalPattern = function() {
+  // This takes exponential time with a backtracking implementation.
+  if (!gjstest.internal.natives) return;
+
+  var pred = containsRe2('^(a+)+$').predicate;
+  expectFalse(pred(new Array(10000).join('a') + 'b'));
+};
+
+ContainsRe2Test.prototype.NativeImplementationRejectsBadArguments =
+    function() {
+  var natives = gjstest.internal.natives;
+  if (!natives) return;
+
+  expectThat(function() { natives.matchRe2(/taco/, 'taco', false); },
+             throwsError(/TypeError.*matchRe2.*string/));
+  expectThat(function() { natives.matchRe2('taco', 17, false); },
+             throwsError(/TypeError.*matchRe2.*string/));
+};
+
+ContainsRe2Test.prototype.Description = function() {
+  var matcher = containsRe2('.+taco.*');
+  expectEq('partially matches RE2 pattern: \'.+taco.*\'',
+           matcher.getDescription());
+  expectEq('doesn\'t partially match RE2 pattern: \'.+taco.*\'',
+           matcher.getNegativeDescription());
+};
+
+////////////////////////////////////////////////////////////////////////
+// fullMatchRe2
+////////////////////////////////////////////////////////////////////////
+
+function FullMatchRe2Test() {}
+registerTestSuite(FullMatchRe2Test);
+
+FullMatchRe2Test.prototype.WrongTypeArgs = function() {
+  function callFunc(arg) { return function() { fullMatchRe2(arg) } }
+
+  expectThat(callFunc(null), throwsError(/TypeError.*fullMatchRe2.*string/));
+  expectThat(callFunc(/a/), throwsError(/TypeError.*fullMatchRe2.*string/));
+};
+
+FullMatchRe2Test.prototype.FullMatch = function() {
+  var pred = fullMatchRe2('t.*o|burrito').predicate;
+
+  expectTrue(pred('to'));
+  expectTrue(pred('taco'));
+  expectTrue(pred('burrito'));
+  expectFalse(pred('burrito and taco filling'));
+  expectFalse(pred('a taco'));
+  expectFalse(pred('burritos'));
+  expectEq('which is not a string', pred(17));
+};
+
+FullMatchRe2Test.prototype.Description = function() {
+  var matcher = fullMatchRe2('t.*o');
+  expectEq('fully matches RE2 pattern: \'t.*o\'', matcher.getDescription());
+  expectEq('doesn\'t fully match RE2 pattern: \'t.*o\'',
+           matcher.getNegativeDescription());
+};
+
 ////////////////////////////////////////////////////////////////////////
 // hasSubstr
 ////////////////////////////////////////////////////////////////////////
@@ -1,5 +1,6 @@
 $(eval $(call compiled_js_library, \
     gjstest/public/matchers/array_matchers, \
+        gjstest/internal/js/diff \
         gjstest/internal/js/namespace \
         gjstest/internal/js/test_environment \
         gjstest/public/matcher_types \
@@ -24,6 +25,7 @@ $(eval $(call compiled_js_library, \
 
 $(eval $(call compiled_js_library, \
     gjstest/public/matchers/equality_matchers, \
+        gjstest/internal/js/diff \
         gjstest/internal/js/namespace \
         gjstest/internal/js/test_environment \
         gjstest/public/matcher_types \
@@ -60,6 +62,13 @@ $(eval $(call compiled_js_library, \
         gjstest/public/stringify \
 ))
 
+$(eval $(call compiled_js_library, \
+    gjstest/public/matchers/typed_array_matchers, \
+        gjstest/internal/js/namespace \
+        gjstest/internal/js/test_environment \
+        gjstest/public/matcher_types \
+))
+
 ######################################################
 # Tests
 ######################################################
@@ -72,3 +81,12 @@ $(eval $(call js_test,gjstest/public/matchers/function_matchers))
 $(eval $(call js_test,gjstest/public/matchers/missing_arg_matchers))
 $(eval $(call js_test,gjstest/public/matchers/number_matchers))
 $(eval $(call js_test,gjstest/public/matchers/string_matchers))
+$(eval $(call js_test,gjstest/public/matchers/typed_array_matchers))
+
+######################################################
+# Benchmarks
+######################################################
+
+$(eval $(call js_benchmark,gjstest/public/matchers/array_matchers))
+$(eval $(call js_benchmark,gjstest/public/matchers/string_matchers))
+$(eval $(call js_benchmark,gjstest/public/matchers/typed_array_matchers))
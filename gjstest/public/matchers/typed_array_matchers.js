@@ -0,0 +1,433 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Matchers that compare the contents of typed arrays and array buffers as a
+// whole, rather than element by element through other matchers. Under the
+// gjstest binary the comparison is done natively; see
+// gjstest/internal/cpp/buffer_compare.h.
+
+/**
+ * Match array buffers, shared array buffers, typed arrays, and DataViews whose
+ * bytes are the same as those of the supplied one. Failures report the first
+ * differing byte along with a hex dump of the bytes around it.
+ *
+ * For example:
+ *
+ *     expectThat(encode(message), bytesEqual(new Uint8Array([0x08, 0x96])));
+ *
+ * @param {!ArrayBuffer|!ArrayBufferView} expected
+ * @return {!gjstest.Matcher}
+ */
+gjstest.bytesEqual = function(expected) {
+  if (!gjstest.internal.isBinaryData_(expected)) {
+    gjstest.internal.currentTestEnvironment.recordUserStack(1);
+    throw new TypeError(
+        'bytesEqual requires an ArrayBuffer or ArrayBufferView.');
+  }
+
+  var expectedBytes = gjstest.internal.getBytes_(expected);
+
+  return new gjstest.Matcher(
+      function() {
+        return 'has bytes ' + gjstest.internal.describeBytes_(expectedBytes);
+      },
+      function() {
+        return 'does not have bytes ' +
+            gjstest.internal.describeBytes_(expectedBytes);
+      },
+      function(actual) {
+        if (!gjstest.internal.isBinaryData_(actual)) {
+          return 'which is not an ArrayBuffer or ArrayBufferView';
+        }
+
+        var natives = gjstest.internal.natives;
+        var findByteDifference =
+            natives ?
+                natives.findByteDifference :
+                gjstest.internal.findByteDifference;
+
+        var actualBytes = gjstest.internal.getBytes_(actual);
+        var offset = findByteDifference(expectedBytes, actualBytes);
+
+        if (offset != -1) {
+          return 'which differs first at byte ' + offset + ':\n' +
+              gjstest.internal.dumpBytes_(expectedBytes, actualBytes, offset);
+        }
+
+        if (actualBytes.length != expectedBytes.length) {
+          return 'which has ' + actualBytes.length + ' bytes';
+        }
+
+        return true;
+      });
+};
+
+/**
+ * Match typed arrays of the same type as the supplied one, with the same
+ * elements. For Float32Array and Float64Array, opt_maxUlps allows elements to
+ * differ by up to that many units in the last place, i.e. representable values
+ * in between. NaN never matches anything but an identical NaN. Failures report
+ * the first differing element along with those around it.
+ *
+ * For example:
+ *
+ *     expectThat(transform(input), typedArrayEquals(expectedOutput, 4));
+ *
+ * @param {!ArrayBufferView} expected
+ * @param {number=} opt_maxUlps
+ * @return {!gjstest.Matcher}
+ */
+gjstest.typedArrayEquals = function(expected, opt_maxUlps) {
+  if (!gjstest.internal.isTypedArray_(expected)) {
+    gjstest.internal.currentTestEnvironment.recordUserStack(1);
+    throw new TypeError('typedArrayEquals requires a typed array.');
+  }
+
+  var isFloat =
+      expected instanceof Float32Array || expected instanceof Float64Array;
+  var maxUlps = opt_maxUlps === undefined ? 0 : opt_maxUlps;
+
+  if (typeof(maxUlps) != 'number' || !(maxUlps >= 0) ||
+      (maxUlps && !isFloat)) {
+    gjstest.internal.currentTestEnvironment.recordUserStack(1);
+    throw new TypeError(
+        'typedArrayEquals requires a non-negative ULP tolerance, and only ' +
+        'for a Float32Array or Float64Array.');
+  }
+
+  var type = expected.constructor;
+  var getDescription = function() {
+    var description =
+        'is a ' + type.name + ' with elements ' +
+        gjstest.internal.describeElements_(expected);
+
+    if (maxUlps) {
+      description += ' within ' + maxUlps + ' ulps';
+    }
+
+    return description;
+  };
+
+  var getNegativeDescription = function() {
+    return this.getDescription().replace('is a', 'is not a');
+  };
+
+  return new gjstest.Matcher(
+      getDescription,
+      getNegativeDescription,
+      function(actual) {
+        if (!gjstest.internal.isTypedArray_(actual) ||
+            actual.constructor != type) {
+          return 'which is not a ' + type.name;
+        }
+
+        var natives = gjstest.internal.natives;
+        var findElementDifference =
+            natives ?
+                natives.findElementDifference :
+                gjstest.internal.findElementDifference;
+
+        var index = findElementDifference(expected, actual, maxUlps);
+
+        if (index != -1) {
+          var clause = 'which differs first at index ' + index;
+          if (isFloat) {
+            var distance = gjstest.internal.ulpDistance_(
+                expected, actual, index);
+            if (distance != Infinity) clause += ' by ' + distance + ' ulps';
+          }
+
+          return clause + ':\n' +
+              gjstest.internal.dumpElements_(expected, actual, index);
+        }
+
+        if (actual.length != expected.length) {
+          return 'which has length ' + actual.length;
+        }
+
+        return true;
+      });
+};
+
+/**
+ * Return the offset of the first byte that differs between the supplied arrays,
+ * among those that both have, or -1 if there is none.
+ *
+ * @param {!Uint8Array} a
+ * @param {!Uint8Array} b
+ * @return {number}
+ */
+gjstest.internal.findByteDifference = function(a, b) {
+  var length = Math.min(a.length, b.length);
+  for (var i = 0; i < length; ++i) {
+    if (a[i] !== b[i]) return i;
+  }
+
+  return -1;
+};
+
+/**
+ * Return the index of the first element that differs between the supplied typed
+ * arrays, which must be of the same type, among those that both have, or -1 if
+ * there is none. See gjstest.typedArrayEquals for the meaning of maxUlps.
+ *
+ * @param {!ArrayBufferView} a
+ * @param {!ArrayBufferView} b
+ * @param {number} maxUlps
+ * @return {number}
+ */
+gjstest.internal.findElementDifference = function(a, b, maxUlps) {
+  var length = Math.min(a.length, b.length);
+  var isFloat = a instanceof Float32Array || a instanceof Float64Array;
+
+  for (var i = 0; i < length; ++i) {
+    if (a[i] === b[i]) continue;
+
+    // Only floats have a tolerance. Identical NaNs also end up here.
+    if (!isFloat || gjstest.internal.ulpDistance_(a, b, i) > maxUlps) {
+      return i;
+    }
+  }
+
+  return -1;
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * @param {*} obj
+ * @return {boolean}
+ *
+ * @private
+ */
+gjstest.internal.isBinaryData_ = function(obj) {
+  return obj instanceof ArrayBuffer ||
+      ArrayBuffer.isView(obj) ||
+      (typeof(SharedArrayBuffer) != 'undefined' &&
+           obj instanceof SharedArrayBuffer);
+};
+
+/**
+ * @param {*} obj
+ * @return {boolean}
+ *
+ * @private
+ */
+gjstest.internal.isTypedArray_ = function(obj) {
+  return ArrayBuffer.isView(obj) && !(obj instanceof DataView);
+};
+
+/**
+ * Return a Uint8Array viewing the bytes of the supplied buffer or view.
+ *
+ * @param {!ArrayBuffer|!ArrayBufferView} obj
+ * @return {!Uint8Array}
+ *
+ * @private
+ */
+gjstest.internal.getBytes_ = function(obj) {
+  if (ArrayBuffer.isView(obj)) {
+    return new Uint8Array(obj.buffer, obj.byteOffset, obj.byteLength);
+  }
+
+  return new Uint8Array(obj);
+};
+
+/**
+ * Return the number of units in the last place between the elements with the
+ * supplied index in two arrays of the same float type, or Infinity if either is
+ * NaN. Elements with the same bits are zero apart.
+ *
+ * @param {!Float32Array|!Float64Array} a
+ * @param {!Float32Array|!Float64Array} b
+ * @param {number} index
+ * @return {number}
+ *
+ * @private
+ */
+gjstest.internal.ulpDistance_ = function(a, b, index) {
+  // Look at the bits of each element as 32-bit words.
+  var wordsPerElement = a.BYTES_PER_ELEMENT / 4;
+  var aWords =
+      new Uint32Array(a.buffer, a.byteOffset, a.length * wordsPerElement);
+  var bWords =
+      new Uint32Array(b.buffer, b.byteOffset, b.length * wordsPerElement);
+
+  var high = index * wordsPerElement;
+  var low = high;
+  if (wordsPerElement == 2) {
+    if (gjstest.internal.isLittleEndian_()) {
+      ++high;
+    } else {
+      ++low;
+    }
+  }
+
+  if (aWords[high] === bWords[high] && aWords[low] === bWords[low]) return 0;
+  if (a[index] !== a[index] || b[index] !== b[index]) return Infinity;
+
+  // Order the values by treating their bits as sign and magnitude, so that
+  // adjacent floats are one apart. Keep the high and low words of doubles
+  // apart, so that the distance is exact whenever it is small enough to
+  // matter.
+  var scale = wordsPerElement == 2 ? 4294967296 : 1;
+  var aHigh = aWords[high] & 0x7fffffff;
+  var bHigh = bWords[high] & 0x7fffffff;
+  var aLow = wordsPerElement == 2 ? aWords[low] : 0;
+  var bLow = wordsPerElement == 2 ? bWords[low] : 0;
+
+  if ((aWords[high] >= 0x80000000) == (bWords[high] >= 0x80000000)) {
+    return Math.abs((aHigh - bHigh) * scale + (aLow - bLow));
+  }
+
+  // The values are on opposite sides of zero.
+  return aHigh * scale + aLow + bHigh * scale + bLow;
+};
+
+/**
+ * @return {boolean}
+ *
+ * @private
+ */
+gjstest.internal.isLittleEndian_ = function() {
+  return new Uint8Array(new Uint16Array([1]).buffer)[0] == 1;
+};
+
+/**
+ * Describe the supplied bytes in hex, abbreviating long arrays.
+ *
+ * @param {!Uint8Array} bytes
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeBytes_ = function(bytes) {
+  var kMaxBytes = 16;
+
+  var parts = [];
+  for (var i = 0; i < bytes.length && i < kMaxBytes; ++i) {
+    parts.push(gjstest.internal.hexByte_(bytes[i]));
+  }
+
+  if (bytes.length > kMaxBytes) {
+    return '[ ' + parts.join(' ') + ' ... ] (' + bytes.length + ' bytes)';
+  }
+
+  return parts.length ? '[ ' + parts.join(' ') + ' ]' : '[]';
+};
+
+/**
+ * Describe the elements of the supplied typed array, abbreviating long arrays.
+ *
+ * @param {!ArrayBufferView} array
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.describeElements_ = function(array) {
+  var kMaxElements = 8;
+
+  var parts = [];
+  for (var i = 0; i < array.length && i < kMaxElements; ++i) {
+    parts.push(String(array[i]));
+  }
+
+  if (array.length > kMaxElements) {
+    return '[ ' + parts.join(', ') + ', ... ] (length ' + array.length + ')';
+  }
+
+  return parts.length ? '[ ' + parts.join(', ') + ' ]' : '[]';
+};
+
+/**
+ * @param {number} b
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.hexByte_ = function(b) {
+  return (b < 0x10 ? '0' : '') + b.toString(16);
+};
+
+/**
+ * Return a hex dump of the line of 16 bytes containing the supplied offset in
+ * each array, with the byte at the offset bracketed. For example:
+ *
+ *     expected: 000004d0  00 01[12]03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f
+ *     actual:   000004d0  00 01[34]03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f
+ *
+ * @param {!Uint8Array} expected
+ * @param {!Uint8Array} actual
+ * @param {number} offset
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.dumpBytes_ = function(expected, actual, offset) {
+  var start = offset - offset % 16;
+  var address = start.toString(16);
+  while (address.length < 8) address = '0' + address;
+
+  var dumpLine = function(bytes) {
+    var line = '';
+    for (var i = start; i < start + 16 && i < bytes.length; ++i) {
+      var hex = gjstest.internal.hexByte_(bytes[i]);
+      if (i == offset) {
+        line += '[' + hex + ']';
+      } else {
+        line += (i == offset + 1 ? '' : ' ') + hex;
+      }
+    }
+
+    return address + ' ' + line;
+  };
+
+  return '    expected: ' + dumpLine(expected) + '\n' +
+      '    actual:   ' + dumpLine(actual);
+};
+
+/**
+ * Return a listing of the elements around the supplied index in each array,
+ * with the element at the index bracketed. For example:
+ *
+ *     expected: [1232..1236] 1, 2, [3], 4, 5
+ *     actual:   [1232..1236] 1, 2, [3.0000002384185791], 4, 5
+ *
+ * @param {!ArrayBufferView} expected
+ * @param {!ArrayBufferView} actual
+ * @param {number} index
+ * @return {string}
+ *
+ * @private
+ */
+gjstest.internal.dumpElements_ = function(expected, actual, index) {
+  var kContext = 2;
+  var start = Math.max(0, index - kContext);
+
+  var dumpLine = function(array) {
+    var end = Math.min(array.length, index + kContext + 1);
+
+    var parts = [];
+    for (var i = start; i < end; ++i) {
+      parts.push(i == index ? '[' + array[i] + ']' : String(array[i]));
+    }
+
+    return '[' + start + '..' + (end - 1) + '] ' + parts.join(', ');
+  };
+
+  return '    expected: ' + dumpLine(expected) + '\n' +
+      '    actual:   ' + dumpLine(actual);
+};
@@ -0,0 +1,84 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, measure how long
+// the typed array matchers take to compare large buffers that are equal, which
+// is the common case and the one where every element must be looked at.
+
+function TypedArrayMatchersBenchmark() { }
+registerTestSuite(TypedArrayMatchersBenchmark);
+
+function buildBytes(length) {
+  var result = new Uint8Array(length);
+  for (var i = 0; i < length; ++i) {
+    result[i] = i * 31;
+  }
+
+  return result;
+}
+
+function buildFloats(length) {
+  var result = new Float32Array(length);
+  for (var i = 0; i < length; ++i) {
+    result[i] = Math.sin(i);
+  }
+
+  return result;
+}
+
+TypedArrayMatchersBenchmark.prototype.LargeBytes = function() {
+  var expected = buildBytes(1 << 20);
+  var actual = new Uint8Array(expected);
+
+  for (var i = 0; i < 100; ++i) {
+    expectThat(actual, bytesEqual(expected));
+  }
+};
+
+TypedArrayMatchersBenchmark.prototype.LargeBytesJsFallback = function() {
+  var expected = buildBytes(1 << 20);
+  var actual = new Uint8Array(expected);
+
+  for (var i = 0; i < 100; ++i) {
+    expectEq(-1, gjstest.internal.findByteDifference(actual, expected));
+  }
+};
+
+TypedArrayMatchersBenchmark.prototype.LargeFloatsWithTolerance = function() {
+  var expected = buildFloats(1 << 18);
+  var actual = new Float32Array(expected);
+
+  for (var i = 0; i < 100; ++i) {
+    expectThat(actual, typedArrayEquals(expected, 4));
+  }
+};
+
+TypedArrayMatchersBenchmark.prototype.LargeFloatsJsFallback = function() {
+  var expected = buildFloats(1 << 18);
+  var actual = new Float32Array(expected);
+
+  for (var i = 0; i < 100; ++i) {
+    expectEq(-1, gjstest.internal.findElementDifference(actual, expected, 4));
+  }
+};
+
+// For comparison, the element-by-element matcher previously needed for this.
+TypedArrayMatchersBenchmark.prototype.ElementsAre = function() {
+  var expected = buildFloats(1 << 12);
+  var actual = new Float32Array(expected);
+
+  for (var i = 0; i < 10; ++i) {
+    expectThat(actual, elementsAre(Array.prototype.slice.call(expected)));
+  }
+};
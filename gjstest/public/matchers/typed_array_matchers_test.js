@@ -0,0 +1,326 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+////////////////////////////////////////////////////////////////////////
+// bytesEqual
+////////////////////////////////////////////////////////////////////////
+
+function BytesEqualTest() {}
+registerTestSuite(BytesEqualTest);
+
+BytesEqualTest.prototype.BadArgs = function() {
+  var expected = /TypeError.*bytesEqual requires an ArrayBuffer/;
+
+  expectThat(function() { bytesEqual(null); }, throwsError(expected));
+  expectThat(function() { bytesEqual([1, 2]); }, throwsError(expected));
+  expectThat(function() { bytesEqual('taco'); }, throwsError(expected));
+};
+
+BytesEqualTest.prototype.NonBinaryCandidates = function() {
+  var pred = bytesEqual(new ArrayBuffer(2)).predicate;
+
+  expectEq('which is not an ArrayBuffer or ArrayBufferView', pred(null));
+  expectEq('which is not an ArrayBuffer or ArrayBufferView', pred([0, 0]));
+  expectEq('which is not an ArrayBuffer or ArrayBufferView', pred('\0\0'));
+};
+
+BytesEqualTest.prototype.Descriptions = function() {
+  var matcher;
+
+  matcher = bytesEqual(new Uint8Array([0x01, 0xab, 0x10]));
+  expectEq('has bytes [ 01 ab 10 ]', matcher.getDescription());
+  expectEq('does not have bytes [ 01 ab 10 ]',
+           matcher.getNegativeDescription());
+
+  matcher = bytesEqual(new ArrayBuffer(0));
+  expectEq('has bytes []', matcher.getDescription());
+
+  matcher = bytesEqual(new Uint16Array(100));
+  expectEq(
+      'has bytes [ 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 ... ] ' +
+          '(200 bytes)',
+      matcher.getDescription());
+};
+
+BytesEqualTest.prototype.ComparesBytesOfAnyView = function() {
+  var bytes = new Uint8Array([0x01, 0x02, 0x03, 0x04, 0x05, 0x06]);
+  var pred = bytesEqual(bytes).predicate;
+
+  expectTrue(pred(bytes));
+  expectTrue(pred(bytes.buffer));
+  expectTrue(pred(new Uint8Array([1, 2, 3, 4, 5, 6]).buffer));
+  expectTrue(pred(new DataView(bytes.buffer)));
+  expectTrue(pred(new Uint16Array(bytes.buffer)));
+
+  // Only the viewed bytes count.
+  var larger = new Uint8Array([0xff, 1, 2, 3, 4, 5, 6, 0xff]);
+  expectTrue(pred(new Uint8Array(larger.buffer, 1, 6)));
+  expectTrue(bytesEqual(larger.subarray(2, 4)).predicate(bytes.subarray(1, 3)));
+};
+
+BytesEqualTest.prototype.DifferentLengths = function() {
+  var pred = bytesEqual(new Uint8Array([1, 2, 3])).predicate;
+
+  expectEq('which has 2 bytes', pred(new Uint8Array([1, 2])));
+  expectEq('which has 4 bytes', pred(new Uint8Array([1, 2, 3, 4])));
+  expectEq('which has 0 bytes', pred(new ArrayBuffer(0)));
+};
+
+BytesEqualTest.prototype.ReportsFirstDifference = function() {
+  var expected = new Uint8Array(100);
+  for (var i = 0; i < expected.length; ++i) expected[i] = i;
+
+  var actual = new Uint8Array(expected);
+  actual[35] = 0xff;
+  actual[36] = 0xee;
+  actual[90] = 0;
+
+  expectEq(
+      'which differs first at byte 35:\n' +
+          '    expected: 00000020  20 21 22[23]24 25 26 27 28 29 2a 2b 2c ' +
+          '2d 2e 2f\n' +
+          '    actual:   00000020  20 21 22[ff]ee 25 26 27 28 29 2a 2b 2c ' +
+          '2d 2e 2f',
+      bytesEqual(expected).predicate(actual));
+
+  // A difference takes precedence over the length, and lines stop at the end
+  // of each array.
+  expectEq(
+      'which differs first at byte 1:\n' +
+          '    expected: 00000000  00[01]02\n' +
+          '    actual:   00000000  00[09]',
+      bytesEqual(expected.subarray(0, 3)).predicate(new Uint8Array([0, 9])));
+};
+
+BytesEqualTest.prototype.SharedArrayBuffers = function() {
+  if (typeof(SharedArrayBuffer) == 'undefined') return;
+
+  var shared = new SharedArrayBuffer(4);
+  new Uint8Array(shared).set([1, 2, 3, 4]);
+
+  expectThat(shared, bytesEqual(new Uint8Array([1, 2, 3, 4])));
+  expectThat(new Uint8Array([1, 2, 3, 4]), bytesEqual(shared));
+  expectThat(new Int8Array(shared), not(bytesEqual(new Uint8Array(4))));
+};
+
+////////////////////////////////////////////////////////////////////////
+// typedArrayEquals
+////////////////////////////////////////////////////////////////////////
+
+function TypedArrayEqualsTest() {}
+registerTestSuite(TypedArrayEqualsTest);
+
+TypedArrayEqualsTest.prototype.BadArgs = function() {
+  var expected = /TypeError.*typedArrayEquals requires a typed array/;
+
+  expectThat(function() { typedArrayEquals([1]); }, throwsError(expected));
+  expectThat(function() { typedArrayEquals(new ArrayBuffer(1)); },
+             throwsError(expected));
+  expectThat(function() { typedArrayEquals(new DataView(new ArrayBuffer(1))); },
+             throwsError(expected));
+
+  expected = /TypeError.*typedArrayEquals requires a non-negative ULP/;
+
+  expectThat(function() { typedArrayEquals(new Float32Array(1), -1); },
+             throwsError(expected));
+  expectThat(function() { typedArrayEquals(new Float64Array(1), NaN); },
+             throwsError(expected));
+  expectThat(function() { typedArrayEquals(new Float64Array(1), '1'); },
+             throwsError(expected));
+  expectThat(function() { typedArrayEquals(new Int32Array(1), 1); },
+             throwsError(expected));
+};
+
+TypedArrayEqualsTest.prototype.WrongTypeCandidates = function() {
+  var pred = typedArrayEquals(new Int16Array([1, 2])).predicate;
+
+  expectEq('which is not a Int16Array', pred(null));
+  expectEq('which is not a Int16Array', pred([1, 2]));
+  expectEq('which is not a Int16Array', pred(new Uint16Array([1, 2])));
+  expectEq('which is not a Int16Array', pred(new Int16Array([1, 2]).buffer));
+};
+
+TypedArrayEqualsTest.prototype.Descriptions = function() {
+  var matcher;
+
+  matcher = typedArrayEquals(new Int32Array([1, -2, 3]));
+  expectEq('is a Int32Array with elements [ 1, -2, 3 ]',
+           matcher.getDescription());
+  expectEq('is not a Int32Array with elements [ 1, -2, 3 ]',
+           matcher.getNegativeDescription());
+
+  matcher = typedArrayEquals(new Float64Array(10), 4);
+  expectEq(
+      'is a Float64Array with elements [ 0, 0, 0, 0, 0, 0, 0, 0, ... ] ' +
+          '(length 10) within 4 ulps',
+      matcher.getDescription());
+};
+
+TypedArrayEqualsTest.prototype.Integers = function() {
+  var pred = typedArrayEquals(new Uint16Array([1, 2, 3, 4, 5, 60000]))
+      .predicate;
+
+  expectTrue(pred(new Uint16Array([1, 2, 3, 4, 5, 60000])));
+  expectEq('which has length 5', pred(new Uint16Array([1, 2, 3, 4, 5])));
+  expectEq(
+      'which differs first at index 5:\n' +
+          '    expected: [3..5] 4, 5, [60000]\n' +
+          '    actual:   [3..5] 4, 5, [60001]',
+      pred(new Uint16Array([1, 2, 3, 4, 5, 60001])));
+  expectEq(
+      'which differs first at index 0:\n' +
+          '    expected: [0..2] [1], 2, 3\n' +
+          '    actual:   [0..2] [0], 2, 3',
+      pred(new Uint16Array([0, 2, 3, 4, 5, 60000])));
+};
+
+TypedArrayEqualsTest.prototype.ExactFloats = function() {
+  var pred = typedArrayEquals(new Float32Array([0, 1.5, NaN, -2])).predicate;
+
+  expectTrue(pred(new Float32Array([-0, 1.5, NaN, -2])));
+  expectEq(
+      'which differs first at index 3 by 1 ulps:\n' +
+          '    expected: [1..3] 1.5, NaN, [-2]\n' +
+          '    actual:   [1..3] 1.5, NaN, [-2.000000238418579]',
+      pred(new Float32Array([0, 1.5, NaN, -2.0000002])));
+  expectEq(
+      'which differs first at index 1:\n' +
+          '    expected: [0..3] 0, [1.5], NaN, -2\n' +
+          '    actual:   [0..3] 0, [NaN], NaN, -2',
+      pred(new Float32Array([0, NaN, NaN, -2])));
+};
+
+TypedArrayEqualsTest.prototype.FloatTolerance = function() {
+  // Find floats a few ulps away from one by going through their bits.
+  var bits = new Uint32Array([0x3f800000, 0x3f800002, 0x3f7ffffd]);
+  var floats = new Float32Array(bits.buffer);
+  expectEq(1, floats[0]);
+
+  var pred = typedArrayEquals(new Float32Array([1, 1]), 2).predicate;
+  expectTrue(pred(new Float32Array([1, floats[1]])));
+  expectEq(
+      'which differs first at index 1 by 3 ulps:\n' +
+          '    expected: [0..1] 1, [1]\n' +
+          '    actual:   [0..1] ' + floats[1] + ', [' + floats[2] + ']',
+      pred(new Float32Array([floats[1], floats[2]])));
+};
+
+TypedArrayEqualsTest.prototype.DoubleTolerance = function() {
+  var words = new Uint32Array(4);
+  var doubles = new Float64Array(words.buffer);
+  doubles[0] = 1;
+  doubles[1] = 1;
+
+  // Step the second double forward five ulps, across a carry into the high
+  // word.
+  var high = gjstest.internal.isLittleEndian_() ? 3 : 2;
+  var low = 5 - high;
+  words[low] = 0xfffffffe;
+  words[high] -= 1;
+  var below = doubles[1];
+  words[low] = 0x00000003;
+  words[high] += 1;
+  var above = doubles[1];
+
+  var expected = new Float64Array([below, 0]);
+  expectEq(
+      'which differs first at index 0 by 5 ulps:\n' +
+          '    expected: [0..1] [' + below + '], 0\n' +
+          '    actual:   [0..1] [' + above + '], 0',
+      typedArrayEquals(expected, 4).predicate(new Float64Array([above, -0])));
+
+  expectTrue(
+      typedArrayEquals(expected, 5).predicate(new Float64Array([above, -0])));
+};
+
+TypedArrayEqualsTest.prototype.ZeroesOnEitherSide = function() {
+  var tiny = new Float64Array(new Uint32Array([1, 0]).buffer)[0];
+  if (!gjstest.internal.isLittleEndian_()) {
+    tiny = new Float64Array(new Uint32Array([0, 1]).buffer)[0];
+  }
+
+  var pred = typedArrayEquals(new Float64Array([tiny]), 1).predicate;
+  expectTrue(pred(new Float64Array([0])));
+  expectTrue(pred(new Float64Array([-0])));
+  expectEq(
+      'which differs first at index 0 by 2 ulps:\n' +
+          '    expected: [0..0] [' + tiny + ']\n' +
+          '    actual:   [0..0] [' + -tiny + ']',
+      pred(new Float64Array([-tiny])));
+};
+
+TypedArrayEqualsTest.prototype.NativeImplementationMatchesJs = function() {
+  var natives = gjstest.internal.natives;
+  if (!natives) return;
+
+  var floats = new Float32Array(1000);
+  var doubles = new Float64Array(1000);
+  var ints = new Int32Array(1000);
+  for (var i = 0; i < 1000; ++i) {
+    floats[i] = doubles[i] = Math.sqrt(i);
+    ints[i] = i * 7919;
+  }
+
+  var cases = [
+    [floats, new Float32Array(floats), 0],
+    [floats, new Float32Array(floats), 3],
+    [doubles, new Float64Array(doubles), 0],
+    [ints, new Int32Array(ints), 0],
+    [ints, ints.subarray(1), 0],
+    [floats.subarray(10, 20), floats.subarray(10, 15), 0]
+  ];
+
+  // Perturb some of the copies.
+  cases[1][1][999] = floats[999] * (1 + 1e-7);
+  cases[2][1][513] = NaN;
+  cases[3][1][300] = 0;
+
+  for (var i = 0; i < cases.length; ++i) {
+    var a = cases[i][0];
+    var b = cases[i][1];
+
+    expectEq(gjstest.internal.findElementDifference(a, b, cases[i][2]),
+             natives.findElementDifference(a, b, cases[i][2]),
+             'Case ' + i);
+
+    var aBytes = gjstest.internal.getBytes_(a);
+    var bBytes = gjstest.internal.getBytes_(b);
+    expectEq(gjstest.internal.findByteDifference(aBytes, bBytes),
+             natives.findByteDifference(aBytes, bBytes),
+             'Case ' + i);
+  }
+};
+
+TypedArrayEqualsTest.prototype.NativeImplementationRejectsBadArguments =
+    function() {
+  var natives = gjstest.internal.natives;
+  if (!natives) return;
+
+  var ints = new Int32Array([1, 2]);
+  var floats = new Float32Array([1, 2]);
+  var bytes = new Int8Array([1, 2]);
+
+  expectThat(function() { natives.findElementDifference(ints, [1, 2], 0); },
+             throwsError(/TypeError.*two typed arrays/));
+  expectThat(function() { natives.findElementDifference(ints, floats, 0); },
+             throwsError(/TypeError.*same type/));
+  expectThat(function() { natives.findElementDifference(floats, ints, 0); },
+             throwsError(/TypeError.*same type/));
+  expectThat(function() { natives.findElementDifference(ints, bytes, 0); },
+             throwsError(/TypeError.*same type/));
+  expectThat(function() { natives.findElementDifference(floats, floats, -1); },
+             throwsError(/TypeError.*non-negative/));
+  expectThat(function() { natives.findByteDifference(ints, 'taco'); },
+             throwsError(/TypeError.*array buffers/));
+};
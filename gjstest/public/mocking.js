@@ -45,10 +45,21 @@ gjstest.createMockFunction = function(opt_name) {
  * @return {!Object}
  */
 gjstest.createMockInstance = function(ctor) {
-  gjstest.internal.currentTestEnvironment.recordUserStack(1);
-  var result =
-      gjstest.internal.createMockInstance(ctor, gjstest.createMockFunction);
-  gjstest.internal.currentTestEnvironment.clearUserStack();
+  var testEnvironment = gjstest.internal.currentTestEnvironment;
+  testEnvironment.recordUserStack(1);
+
+  // Create the mock methods directly, rather than with
+  // gjstest.createMockFunction, so that the user stack is recorded only once.
+  var createMockFunction = function(name) {
+    return gjstest.internal.createMockFunction(
+        gjstest.stringify,
+        gjstest.internal.checkArgsAgainstExpectation,
+        testEnvironment.reportFailure,
+        name);
+  };
+
+  var result = gjstest.internal.createMockInstance(ctor, createMockFunction);
+  testEnvironment.clearUserStack();
 
   return result;
 };
@@ -180,26 +191,19 @@ gjstest.internal.makeMockFunctionStub_ = function(expectations) {
 
     // Create a call expectation. Add to it the stack frame before this one,
     // which is the frame in the test that created this expectation.
-    var stackFrames = gjstest.internal.getCurrentStack();
     var expectation =
         new gjstest.internal.CallExpectation(
             matchers,
-            stackFrames[1]);
+            gjstest.internal.getStackFrame(1));
 
-    // Register the expectation.
+    // Register the expectation with the mock function and the running test.
     expectations.push(expectation);
-    gjstest.internal.registeredCallExpectations.push(expectation);
+
+    var testEnvironment = gjstest.internal.currentTestEnvironment;
+    testEnvironment.callExpectations.push(expectation);
 
     // Return an object with additional methods that can be called to modify the
     // expectation.
     return gjstest.internal.makeExpectationWrapper_(expectation);
   };
 };
-
-/**
- * A list of mock expectations that have been created, for use by the test
- * runner in verifying whether or not all expectations were fulfilled.
- *
- * @type {!Array.<!gjstest.internal.CallExpectation>}
- */
-gjstest.internal.registeredCallExpectations = [];
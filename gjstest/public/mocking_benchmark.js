@@ -0,0 +1,68 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, measure how fast
+// mock instances are created. Each test creates 10,000 of them, as a large
+// suite whose constructor mocks a few classes might.
+
+function MockingBenchmark() { }
+registerTestSuite(MockingBenchmark);
+
+var kNumMockInstances = 10000;
+
+// Define a class with the supplied number of methods, half of them inherited
+// from a base class.
+function defineClass(numMethods) {
+  function Base() {}
+  function Derived() {}
+  Derived.prototype = Object.create(Base.prototype);
+  Derived.prototype.constructor = Derived;
+
+  for (var i = 0; i < numMethods; ++i) {
+    var prototype = i % 2 ? Base.prototype : Derived.prototype;
+    prototype['method' + i] = function() {};
+  }
+
+  return Derived;
+}
+
+MockingBenchmark.prototype.SmallClass = function() {
+  var SmallClass = defineClass(10);
+  for (var i = 0; i < kNumMockInstances; ++i) {
+    createMockInstance(SmallClass);
+  }
+};
+
+MockingBenchmark.prototype.LargeClass = function() {
+  var LargeClass = defineClass(200);
+  for (var i = 0; i < kNumMockInstances; ++i) {
+    createMockInstance(LargeClass);
+  }
+};
+
+MockingBenchmark.prototype.ES6Class = function() {
+  class Base {
+    taco() {}
+    burrito() {}
+  }
+
+  class Derived extends Base {
+    enchilada() {}
+    queso() {}
+  }
+
+  for (var i = 0; i < kNumMockInstances; ++i) {
+    createMockInstance(Derived);
+  }
+};
@@ -26,7 +26,7 @@ registerTestSuite(ExpectCallTest);
 
 ExpectCallTest.prototype.tearDown = function() {
   // Clean up after any mock functions registered.
-  gjstest.internal.registeredCallExpectations.length = 0;
+  gjstest.internal.currentTestEnvironment.callExpectations.length = 0;
 };
 
 ExpectCallTest.prototype.NotAMockFunction = function() {
@@ -44,7 +44,8 @@ ExpectCallTest.prototype.AddsExpectationsToMockAndArray = function() {
 
   // Each place should have two expectations, and they should be the same ones.
   var funcExpectations = this.mockFunc_.__gjstest_expectations;
-  var registeredExpectations = gjstest.internal.registeredCallExpectations;
+  var registeredExpectations =
+      gjstest.internal.currentTestEnvironment.callExpectations;
 
   expectEq(2, funcExpectations.length);
   expectEq(2, registeredExpectations.length);
@@ -58,7 +59,7 @@ ExpectCallTest.prototype.UsesSuppliedMatchers = function() {
   var matcher_1 = equals(2);
   expectCall(this.mockFunc_)(matcher_0, matcher_1);
 
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
   var matchers = expectation.argMatchers;
 
   expectEq(2, matchers.length);
@@ -69,18 +70,18 @@ ExpectCallTest.prototype.UsesSuppliedMatchers = function() {
 ExpectCallTest.prototype.SetsStackFrame = function() {
   expectCall(this.mockFunc_)();
 
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
   var stackFrame = expectation.stackFrame;
 
   expectEq('mocking_test.js', stackFrame.fileName);
-  expectEq(70, stackFrame.lineNumber);
+  expectEq(71, stackFrame.lineNumber);
 };
 
 ExpectCallTest.prototype.NonMatcherValues = function() {
   var obj = {};
   expectCall(this.mockFunc_)(0, undefined, obj);
 
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
   var matchers = expectation.argMatchers;
 
   expectEq(3, matchers.length);
@@ -110,7 +111,7 @@ ExpectCallTest.prototype.NonMatcherValues = function() {
 
 ExpectCallTest.prototype.Times = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectEq(null, expectation.expectedNumMatches);
 
@@ -120,7 +121,7 @@ ExpectCallTest.prototype.Times = function() {
 
 ExpectCallTest.prototype.TimesCalledTwice = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectThat(
       function() {
@@ -133,7 +134,7 @@ ExpectCallTest.prototype.TimesCalledTwice = function() {
 
 ExpectCallTest.prototype.NoActionsRegistered = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectEq(0, expectation.oneTimeActions.length);
   expectEq(null, expectation.fallbackAction);
@@ -141,7 +142,7 @@ ExpectCallTest.prototype.NoActionsRegistered = function() {
 
 ExpectCallTest.prototype.WillOnce = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   var func_0 = function() {};
   var func_1 = function() {};
@@ -157,7 +158,7 @@ ExpectCallTest.prototype.WillOnce = function() {
 
 ExpectCallTest.prototype.WillRepeatedly = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   var func = function() {};
   result.willRepeatedly(func);
@@ -167,7 +168,7 @@ ExpectCallTest.prototype.WillRepeatedly = function() {
 
 ExpectCallTest.prototype.WillRepeatedlyCalledTwice = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectThat(
       function() {
@@ -180,7 +181,7 @@ ExpectCallTest.prototype.WillRepeatedlyCalledTwice = function() {
 
 ExpectCallTest.prototype.WillOnceCalledAfterWillRepeatedly = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectThat(
       function() {
@@ -194,7 +195,7 @@ ExpectCallTest.prototype.WillOnceCalledAfterWillRepeatedly = function() {
 
 ExpectCallTest.prototype.TimesCalledAfterWillOnce = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectThat(
       function() {
@@ -207,7 +208,7 @@ ExpectCallTest.prototype.TimesCalledAfterWillOnce = function() {
 
 ExpectCallTest.prototype.TimesCalledAfterWillRepeatedly = function() {
   var result = expectCall(this.mockFunc_)();
-  var expectation = gjstest.internal.registeredCallExpectations[0];
+  var expectation = gjstest.internal.currentTestEnvironment.callExpectations[0];
 
   expectThat(
       function() {
@@ -217,3 +218,38 @@ ExpectCallTest.prototype.TimesCalledAfterWillRepeatedly = function() {
       },
       throwsError(/times\(\) called after willRepeatedly\(\)/));
 };
+
+////////////////////////////////////////////////////////////////////////
+// createMockInstance
+////////////////////////////////////////////////////////////////////////
+
+function CreateMockInstanceTest() {}
+registerTestSuite(CreateMockInstanceTest);
+
+CreateMockInstanceTest.prototype.tearDown = function() {
+  gjstest.internal.currentTestEnvironment.callExpectations.length = 0;
+};
+
+CreateMockInstanceTest.prototype.MockMethodsWork = function() {
+  function MyClass() {}
+  MyClass.prototype.taco = function() { return 'real'; };
+  MyClass.prototype.burrito = function() { return 'real'; };
+
+  var instance = createMockInstance(MyClass);
+  expectCall(instance.taco)(17).willOnce(returnWith('mock'));
+
+  expectEq('mock', instance.taco(17));
+  expectNe(MyClass.prototype.burrito, instance.burrito);
+};
+
+CreateMockInstanceTest.prototype.RecordsUserStackOnce = function() {
+  function MyClass() {}
+  MyClass.prototype.taco = function() {};
+  MyClass.prototype.burrito = function() {};
+  MyClass.prototype.enchilada = function() {};
+
+  gjstest.internal.takeStats();
+  createMockInstance(MyClass);
+
+  expectEq(1, gjstest.internal.takeStats().stackCaptures);
+};
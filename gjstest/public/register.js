@@ -30,6 +30,18 @@
 //       expectFalse(this.objectUnderTest_.bar());
 //     });
 //
+//     // Optionally build expensive fixtures once for the whole suite, rather
+//     // than once per test in the constructor.
+//     MyTestFixture.setUpSuite = function() {
+//       MyTestFixture.table_ = buildLookupTable();
+//     };
+//
+//     // Tests of asynchronous code can return a promise. The test isn't
+//     // finished until it settles.
+//     addTest(MyTestFixture, async function fetchesTaco() {
+//       expectEq('taco', await this.objectUnderTest_.fetch());
+//     });
+//
 
 /**
  * Register a test constructor to be executed by the test runner.
@@ -44,6 +56,22 @@
  *     helpers. If you use leading-upper-case CamelCase for test names, you
  *     don't need to worry about this exception.
  *
+ *  *  The property's name is 'setUpSuite' or 'tearDownSuite', which are
+ *     reserved for the suite-level hooks described below.
+ *
+ * If ctor itself has a function-valued property named setUpSuite, the test
+ * runner calls it once, with ctor as its receiver, before running the first of
+ * the suite's tests. Likewise tearDownSuite is called once after the last of
+ * them, even if setUpSuite failed. Use these for fixtures that are expensive to
+ * build and safe to share between tests, storing them on ctor. Neither is
+ * called if none of the suite's tests are selected by the test filter, and if
+ * setUpSuite fails then the suite's tests are skipped.
+ *
+ * A test function or hook may return a promise, in which case it is finished
+ * when the promise settles, and fails if it is rejected. The tearDown method
+ * of an asynchronous test is called once the test's promise has settled, and
+ * may itself return a promise for the test to wait on.
+ *
  * Rather than attaching tests to ctor.prototype directly, consider using the
  * addTest function below. See its documentation for the benefits of doing so.
  *
@@ -56,11 +84,19 @@ gjstest.registerTestSuite = function(ctor) {
   }
 
   // Make sure this constructor hasn't already been registered.
-  if (gjstest.internal.testSuites.indexOf(ctor) != -1) {
-    throw new Error('Test suite already registered: ' + ctor.name);
+  var existing = gjstest.internal.testSuites.get(ctor);
+  if (existing) {
+    var frame = existing.stackFrame;
+    throw new Error(
+        'Test suite already registered: ' + ctor.name +
+        ' (at ' + frame.fileName + ':' + frame.lineNumber + ')');
   }
 
-  gjstest.internal.testSuites.push(ctor);
+  gjstest.internal.testSuites.set(
+      ctor,
+      new gjstest.internal.TestSuiteInfo(
+          ctor,
+          gjstest.internal.getStackFrame(1)));
 };
 
 /**
@@ -109,7 +145,7 @@ gjstest.addTest = function(testSuite, testFunc) {
   }
 
   // Make sure the suite has been registered.
-  if (gjstest.internal.testSuites.indexOf(testSuite) == -1) {
+  if (!gjstest.internal.testSuites.has(testSuite)) {
     throw new Error('Test suite has not been registered: ' + testSuite.name);
   }
 
@@ -119,7 +155,7 @@ gjstest.addTest = function(testSuite, testFunc) {
     throw new Error('Test functions must have names.');
   }
 
-  if (/_$/.test(testFuncName) || testFuncName == 'tearDown') {
+  if (gjstest.internal.isReservedName_(testFuncName)) {
     throw new Error('Illegal test function name: ' + testFuncName);
   }
 
@@ -152,10 +188,78 @@ gjstest.addTest = function(testSuite, testFunc) {
 ////////////////////////////////////////////////////////////////////////
 
 /**
- * A list of test suites that have been registered.
- * @type {!Array.<!Function>}
+ * What is known about a registered test suite.
+ *
+ * @param {!Function} ctor
+ * @param {!gjstest.internal.StackFrame} stackFrame
+ * @constructor
+ */
+gjstest.internal.TestSuiteInfo = function(ctor, stackFrame) {
+  this.ctor = ctor;
+  this.name = ctor.name;
+  this.stackFrame = stackFrame;
+  this.testNames = [];
+  this.testFunctions = [];
+  this.setUpSuite = null;
+  this.tearDownSuite = null;
+};
+
+/**
+ * The constructor for the test suite class.
+ *
+ * @type {!Function}
+ */
+gjstest.internal.TestSuiteInfo.prototype.ctor;
+
+/**
+ * The name of the suite, which prefixes the full names of its tests.
+ *
+ * @type {string}
+ */
+gjstest.internal.TestSuiteInfo.prototype.name;
+
+/**
+ * The place where the suite was registered.
+ *
+ * @type {!gjstest.internal.StackFrame}
+ */
+gjstest.internal.TestSuiteInfo.prototype.stackFrame;
+
+/**
+ * The full names of the suite's tests and the functions that run them, as
+ * found by the last call to gjstest.internal.listTestSuites. Tests may be
+ * added to the suite's prototype after it's registered, so these are empty
+ * until then.
+ *
+ * @type {!Array.<string>}
+ */
+gjstest.internal.TestSuiteInfo.prototype.testNames;
+
+/**
+ * @type {!Array.<function()>}
+ */
+gjstest.internal.TestSuiteInfo.prototype.testFunctions;
+
+/**
+ * Functions that run the suite's setUpSuite and tearDownSuite hooks, if it has
+ * them, as found by the last call to gjstest.internal.listTestSuites. Test
+ * runners run these like tests.
+ *
+ * @type {?function()}
  */
-gjstest.internal.testSuites = [];
+gjstest.internal.TestSuiteInfo.prototype.setUpSuite;
+
+/**
+ * @type {?function()}
+ */
+gjstest.internal.TestSuiteInfo.prototype.tearDownSuite;
+
+/**
+ * The test suites that have been registered, in order of registration.
+ *
+ * @type {!Map.<!Function, !gjstest.internal.TestSuiteInfo>}
+ */
+gjstest.internal.testSuites = new Map;
 
 /**
  * Given a constructor and the name of a test method on that contructor, return
@@ -163,26 +267,116 @@ gjstest.internal.testSuites = [];
  *
  * @param {!Function} ctor
  * @param {string} propertyName
- * @return {function()}
+ * @return {function(): (Promise|undefined)}
  *
  * @private
  */
 gjstest.internal.makeTestFunction_ = function(ctor, propertyName) {
+  // NOTE(jacobsa): We quote 'tearDown' to stop the complaining the JS compiler
+  // does as of 2011-01-19.
+  var tearDown = function(instance) {
+    var tearDownMethod = instance && instance['tearDown'];
+    return tearDownMethod && tearDownMethod.apply(instance);
+  };
+
   return function() {
     // Run the test, making sure we run the tearDown method, if any, regardless
     // of whether an error is thrown.
+    var result;
     try {
       var instance = new ctor();
-      instance[propertyName]();
+      result = instance[propertyName]();
     } finally {
-      // NOTE(jacobsa): We quote 'tearDown' to stop the complaining the JS
-      // compiler does as of 2011-01-19.
-      var tearDown = instance && instance['tearDown'];
-      tearDown && tearDown.apply(instance);
+      if (!gjstest.internal.isThenable(result)) {
+        tearDown(instance);
+      }
+    }
+
+    // If the test is asynchronous, tear down once it has settled.
+    if (!gjstest.internal.isThenable(result)) {
+      return;
     }
+
+    return Promise.resolve(result).then(
+        function() { return tearDown(instance); },
+        function(error) {
+          return Promise.resolve(tearDown(instance)).then(function() {
+            throw error;
+          });
+        });
   };
 };
 
+/**
+ * Return a function that calls the suite-level hook of the supplied name on
+ * ctor, or null if ctor has no such hook.
+ *
+ * @param {!Function} ctor
+ * @param {string} hookName
+ * @return {?function(): *}
+ *
+ * @private
+ */
+gjstest.internal.makeSuiteHookFunction_ = function(ctor, hookName) {
+  if (!(ctor[hookName] instanceof Function)) {
+    return null;
+  }
+
+  return function() {
+    return ctor[hookName]();
+  };
+};
+
+/**
+ * Is the supplied value a promise, or something that can be used like one?
+ *
+ * @param {*} value
+ * @return {boolean}
+ */
+gjstest.internal.isThenable = function(value) {
+  return value !== null &&
+      (typeof(value) == 'object' || typeof(value) == 'function') &&
+      typeof(value.then) == 'function';
+};
+
+/**
+ * Is the supplied name one that can't be used for a test method?
+ *
+ * @param {string} name
+ * @return {boolean}
+ *
+ * @private
+ */
+gjstest.internal.isReservedName_ = function(name) {
+  return /_$/.test(name) ||
+      name == 'tearDown' ||
+      name == 'setUpSuite' ||
+      name == 'tearDownSuite';
+};
+
+/**
+ * Return the names of the test methods of the supplied test suite class.
+ *
+ * @param {!Function} ctor
+ * @return {!Array.<string>}
+ *
+ * @private
+ */
+gjstest.internal.getTestMethodNames_ = function(ctor) {
+  // Consider each enumerable key belonging directly to the constructor's
+  // prototype.
+  var prototype = ctor.prototype;
+  return Object.keys(prototype).filter(function(key) {
+    // Skip this property if it's private or the name of a hook.
+    if (gjstest.internal.isReservedName_(key)) {
+      return false;
+    }
+
+    // Skip this property if it's not a function.
+    return prototype[key] instanceof Function;
+  });
+};
+
 /**
  * Given a constructor registered with registerTestSuite, return a map from full
  * test names (e.g. FooTest.doesBar) to functions that can be executed to run
@@ -194,27 +388,43 @@ gjstest.internal.makeTestFunction_ = function(ctor, propertyName) {
 gjstest.internal.getTestFunctions = function(ctor) {
   var result = {};
 
-  function addTestFunction(name) {
+  gjstest.internal.getTestMethodNames_(ctor).forEach(function(name) {
     // Compute the full name for the test, and create a function that performs
     // the appropriate test.
     var fullName = ctor.name + '.' + name;
     result[fullName] = gjstest.internal.makeTestFunction_(ctor, name);
-  }
+  });
 
-  // Consider each enumerable key belonging directly to the constructor's
-  // prototype.
-  Object.keys(ctor.prototype).forEach(function(key) {
-    // Skip this property if it's private or the tearDown method.
-    if (/_$/.test(key) || key == 'tearDown') {
-      return;
-    }
+  return result;
+};
 
-    // Skip this property if it's not a function.
-    if (!(ctor.prototype[key] instanceof Function)) {
-      return;
+/**
+ * Fill in the tests of each registered test suite and return the suites in
+ * order of registration. Test runners call this once, after all scripts have
+ * run, rather than enumerating each suite separately.
+ *
+ * @return {!Array.<!gjstest.internal.TestSuiteInfo>}
+ */
+gjstest.internal.listTestSuites = function() {
+  var result = [];
+
+  gjstest.internal.testSuites.forEach(function(info) {
+    var names = gjstest.internal.getTestMethodNames_(info.ctor);
+
+    info.testNames = [];
+    info.testFunctions = [];
+    for (var i = 0; i < names.length; ++i) {
+      info.testNames.push(info.name + '.' + names[i]);
+      info.testFunctions.push(
+          gjstest.internal.makeTestFunction_(info.ctor, names[i]));
     }
 
-    addTestFunction(key);
+    info.setUpSuite =
+        gjstest.internal.makeSuiteHookFunction_(info.ctor, 'setUpSuite');
+    info.tearDownSuite =
+        gjstest.internal.makeSuiteHookFunction_(info.ctor, 'tearDownSuite');
+
+    result.push(info);
   });
 
   return result;
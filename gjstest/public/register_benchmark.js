@@ -0,0 +1,53 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, measure how fast
+// test suites are registered and enumerated. Each test registers 100,000 tests
+// into an empty registry, the way a large generated test file might, and then
+// lists them as the test runner would.
+
+function RegisterBenchmark() {
+  this.originalTestSuites_ = gjstest.internal.testSuites;
+  gjstest.internal.testSuites = new Map;
+}
+registerTestSuite(RegisterBenchmark);
+
+RegisterBenchmark.prototype.tearDown = function() {
+  gjstest.internal.testSuites = this.originalTestSuites_;
+};
+
+var kNumTests = 100000;
+
+// Register the supplied number of suites, splitting kNumTests between them.
+function registerSuites(numSuites) {
+  var testsPerSuite = kNumTests / numSuites;
+  for (var i = 0; i < numSuites; ++i) {
+    var ctor = new Function('return function Suite' + i + '() {};')();
+    registerTestSuite(ctor);
+
+    for (var j = 0; j < testsPerSuite; ++j) {
+      ctor.prototype['test' + j] = function() {};
+    }
+  }
+
+  gjstest.internal.listTestSuites();
+}
+
+RegisterBenchmark.prototype.ManySmallSuites = function() {
+  registerSuites(kNumTests / 10);
+};
+
+RegisterBenchmark.prototype.OneLargeSuite = function() {
+  registerSuites(1);
+};
@@ -33,7 +33,7 @@ function RegisterTestSuiteTest() {
   // Make a copy of the real object; we will replace it later. Then clear it for
   // the duration of this test.
   this.originalTestConstructors_ = gjstest.internal.testSuites;
-  gjstest.internal.testSuites = [];
+  gjstest.internal.testSuites = new Map;
 }
 registerTestSuite(RegisterTestSuiteTest);
 
@@ -54,17 +54,30 @@ RegisterTestSuiteTest.prototype.StoresConstructors = function() {
   registerTestSuite(TestSuite1);
   registerTestSuite(TestSuite2);
 
-  expectThat(gjstest.internal.testSuites,
+  expectThat(Array.from(gjstest.internal.testSuites.keys()),
              elementsAre([TestSuite1, TestSuite2]));
 };
 
+RegisterTestSuiteTest.prototype.StoresSuiteInfo = function() {
+  function TestSuite() {}
+  registerTestSuite(TestSuite);
+
+  var info = gjstest.internal.testSuites.get(TestSuite);
+  expectEq(TestSuite, info.ctor);
+  expectEq('TestSuite', info.name);
+  expectEq('register_test.js', info.stackFrame.fileName);
+  expectEq(63, info.stackFrame.lineNumber);
+  expectThat(info.testNames, elementsAre([]));
+  expectThat(info.testFunctions, elementsAre([]));
+};
+
 RegisterTestSuiteTest.prototype.AlreadyRegistered = function() {
   function TestSuite() {}
 
   expectThat(function() {
     registerTestSuite(TestSuite);
     registerTestSuite(TestSuite);
-  }, throwsError(/already registered.*TestSuite/));
+  }, throwsError(/already registered.*TestSuite.*register_test\.js:\d+/));
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -75,7 +88,7 @@ function AddTestTest() {
   // Make a copy of the real object; we will replace it later. Then clear it for
   // the duration of this test.
   this.originalTestConstructors_ = gjstest.internal.testSuites;
-  gjstest.internal.testSuites = [];
+  gjstest.internal.testSuites = new Map;
 
   // Register a fake test suite for use in our tests.
   this.someSuite_ = function SomeSuite() {};
@@ -147,6 +160,18 @@ AddTestTest.prototype.TestFuncNameIstearDown = function() {
   }, throwsError(/Error.*Illegal.*name.*tearDown/));
 };
 
+AddTestTest.prototype.TestFuncNameIsSuiteHook = function() {
+  var someSuite = this.someSuite_;
+
+  expectThat(function() {
+    addTest(someSuite, function setUpSuite() {});
+  }, throwsError(/Error.*Illegal.*name.*setUpSuite/));
+
+  expectThat(function() {
+    addTest(someSuite, function tearDownSuite() {});
+  }, throwsError(/Error.*Illegal.*name.*tearDownSuite/));
+};
+
 AddTestTest.prototype.TestFuncNameAlreadyPresentFromBareRegistration =
     function() {
   var someSuite = this.someSuite_;
@@ -235,6 +260,16 @@ GetTestFunctionsTest.prototype.IgnoresTearDown = function() {
   expectThat(getEnumerableKeys(result), elementsAre(['TestSuite.someName']));
 };
 
+GetTestFunctionsTest.prototype.IgnoresSuiteHooks = function() {
+  function TestSuite() {}
+  TestSuite.prototype.someName = function() {};
+  TestSuite.prototype.setUpSuite = function() {};
+  TestSuite.prototype.tearDownSuite = function() {};
+
+  var result = gjstest.internal.getTestFunctions(TestSuite);
+  expectThat(getEnumerableKeys(result), elementsAre(['TestSuite.someName']));
+};
+
 GetTestFunctionsTest.prototype.IgnoresInheritedFunctions = function() {
   function ParentSuite() {}
   ParentSuite.prototype.overridden = function() {};
@@ -340,3 +375,174 @@ GetTestFunctionsTest.prototype.ErrorInConstructor = function() {
   expectThat(testFunctions['TestSuite.someName'],
              throwsError(/Error: taco/));
 };
+
+GetTestFunctionsTest.prototype.AsyncTestTearsDownAfterSettling =
+    async function() {
+  var events = [];
+  var finishTest;
+
+  function TestSuite() {}
+  TestSuite.prototype.tearDown = function() { events.push('tearDown'); };
+  TestSuite.prototype.someName = function() {
+    events.push('started');
+    return new Promise(function(resolve) { finishTest = resolve; });
+  };
+
+  // The test function should return a promise without tearing down yet.
+  var testFunctions = gjstest.internal.getTestFunctions(TestSuite);
+  var result = testFunctions['TestSuite.someName']();
+
+  expectTrue(gjstest.internal.isThenable(result));
+  expectThat(events, elementsAre(['started']));
+
+  // Once the test's promise settles, tearDown should be run.
+  events.push('settling');
+  finishTest();
+  await result;
+
+  expectThat(events, elementsAre(['started', 'settling', 'tearDown']));
+};
+
+GetTestFunctionsTest.prototype.AsyncTestRejectsAfterTearingDown =
+    async function() {
+  var events = [];
+
+  function TestSuite() {}
+  TestSuite.prototype.tearDown = async function() {
+    await null;
+    events.push('tearDown');
+  };
+
+  TestSuite.prototype.someName = async function() {
+    throw new Error('taco');
+  };
+
+  var testFunctions = gjstest.internal.getTestFunctions(TestSuite);
+
+  var error = null;
+  try {
+    await testFunctions['TestSuite.someName']();
+  } catch (e) {
+    error = e;
+  }
+
+  expectThat(events, elementsAre(['tearDown']));
+  expectEq('taco', error.message);
+};
+
+GetTestFunctionsTest.prototype.IsThenable = function() {
+  expectTrue(gjstest.internal.isThenable(Promise.resolve()));
+  expectTrue(gjstest.internal.isThenable({then: function() {}}));
+
+  expectFalse(gjstest.internal.isThenable(null));
+  expectFalse(gjstest.internal.isThenable(undefined));
+  expectFalse(gjstest.internal.isThenable({then: 'taco'}));
+  expectFalse(gjstest.internal.isThenable('then'));
+};
+
+////////////////////////////////////////////////////////////////////////
+// listTestSuites
+////////////////////////////////////////////////////////////////////////
+
+function ListTestSuitesTest() {
+  this.originalTestConstructors_ = gjstest.internal.testSuites;
+  gjstest.internal.testSuites = new Map;
+}
+registerTestSuite(ListTestSuitesTest);
+
+ListTestSuitesTest.prototype.tearDown = function() {
+  gjstest.internal.testSuites = this.originalTestConstructors_;
+};
+
+ListTestSuitesTest.prototype.NoSuites = function() {
+  expectThat(gjstest.internal.listTestSuites(), elementsAre([]));
+};
+
+ListTestSuitesTest.prototype.SuitesAndTests = function() {
+  function TestSuite1() {}
+  registerTestSuite(TestSuite1);
+  TestSuite1.prototype.someName = function() {};
+  TestSuite1.prototype.ignoredName_ = function() {};
+  TestSuite1.prototype.tearDown = function() {};
+
+  function TestSuite2() {}
+  registerTestSuite(TestSuite2);
+
+  // Tests added after registration should be included.
+  function TestSuite3() {}
+  registerTestSuite(TestSuite3);
+  addTest(TestSuite3, function taco() {});
+  TestSuite3.prototype.burrito = function() {};
+
+  var suites = gjstest.internal.listTestSuites();
+  expectThat(suites, elementsAre([_, _, _]));
+
+  expectEq(TestSuite1, suites[0].ctor);
+  expectThat(suites[0].testNames, elementsAre(['TestSuite1.someName']));
+  expectThat(suites[0].testFunctions, elementsAre([_]));
+
+  expectEq(TestSuite2, suites[1].ctor);
+  expectThat(suites[1].testNames, elementsAre([]));
+  expectThat(suites[1].testFunctions, elementsAre([]));
+
+  expectEq(TestSuite3, suites[2].ctor);
+  expectThat(suites[2].testNames,
+             elementsAre(['TestSuite3.taco', 'TestSuite3.burrito']));
+  expectThat(suites[2].testFunctions, elementsAre([_, _]));
+};
+
+ListTestSuitesTest.prototype.TestFunctionsRunTests = function() {
+  var ran = null;
+
+  function TestSuite() {}
+  registerTestSuite(TestSuite);
+  TestSuite.prototype.someName = function() { ran = this; };
+
+  gjstest.internal.listTestSuites()[0].testFunctions[0]();
+  expectTrue(ran instanceof TestSuite);
+};
+
+ListTestSuitesTest.prototype.ListsTestsAddedSinceLastCall = function() {
+  function TestSuite() {}
+  registerTestSuite(TestSuite);
+  TestSuite.prototype.taco = function() {};
+
+  gjstest.internal.listTestSuites();
+  TestSuite.prototype.burrito = function() {};
+
+  var suites = gjstest.internal.listTestSuites();
+  expectThat(suites[0].testNames,
+             elementsAre(['TestSuite.taco', 'TestSuite.burrito']));
+};
+
+ListTestSuitesTest.prototype.NoSuiteHooks = function() {
+  function TestSuite() {}
+  registerTestSuite(TestSuite);
+  TestSuite.setUpSuite = 'taco';
+
+  var suites = gjstest.internal.listTestSuites();
+  expectEq(null, suites[0].setUpSuite);
+  expectEq(null, suites[0].tearDownSuite);
+};
+
+ListTestSuitesTest.prototype.SuiteHooks = function() {
+  var log = [];
+
+  function TestSuite() {}
+  registerTestSuite(TestSuite);
+
+  // Hooks may be added after registration.
+  TestSuite.setUpSuite = function() { log.push(['setUp', this]); };
+  TestSuite.tearDownSuite = function() { log.push(['tearDown', this]); };
+
+  var suites = gjstest.internal.listTestSuites();
+  expectThat(suites[0].testNames, elementsAre([]));
+
+  suites[0].setUpSuite();
+  suites[0].tearDownSuite();
+
+  expectThat(log, recursivelyEquals([
+    ['setUp', TestSuite],
+    ['tearDown', TestSuite],
+  ]));
+};
@@ -34,11 +34,22 @@
  * @return {!string}
  */
 gjstest.stringify = function(obj) {
-  return gjstest.internal.stringifyToDepth(obj, 5);
+  var natives = gjstest.internal.natives;
+  var result = natives ?
+      natives.stringifyToDepth(obj, 5) :
+      gjstest.internal.stringifyToDepth(obj, 5);
+
+  ++gjstest.internal.stats.stringifyCalls;
+  gjstest.internal.stats.stringifyChars += result.length;
+
+  return result;
 };
 
 
 /**
+ * The JS implementation of gjstest.stringify, used where the native one
+ * isn't available. The two must produce identical output.
+ *
  * @param {*} obj
  * @param {number} depth Depth to which objects should be expanded.
  * @return {!string}
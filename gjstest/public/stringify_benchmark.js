@@ -0,0 +1,66 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Tests whose running times, as recorded in the XML report, measure how long
+// gjstest.stringify takes to describe large values. Each value is rebuilt for
+// every call so that it starts out unmarked, as values under test do.
+
+function StringifyBenchmark() { }
+registerTestSuite(StringifyBenchmark);
+
+function buildNestedObject(depth) {
+  if (depth == 0) {
+    return { number: 1, string: 'taco', array: [1, 2, 3] };
+  }
+
+  var result = {};
+  for (var i = 0; i < 10; ++i) {
+    result['key' + i] = buildNestedObject(depth - 1);
+  }
+
+  return result;
+}
+
+function buildLargeArray() {
+  var result = [];
+  for (var i = 0; i < 10000; ++i) {
+    result.push({ index: i, name: 'element' });
+  }
+
+  return result;
+}
+
+StringifyBenchmark.prototype.LargeNestedObject = function() {
+  for (var i = 0; i < 50; ++i) {
+    stringify(buildNestedObject(4));
+  }
+};
+
+StringifyBenchmark.prototype.LargeNestedObjectJsFallback = function() {
+  for (var i = 0; i < 50; ++i) {
+    gjstest.internal.stringifyToDepth(buildNestedObject(4), 5);
+  }
+};
+
+StringifyBenchmark.prototype.LargeArray = function() {
+  for (var i = 0; i < 200; ++i) {
+    stringify(buildLargeArray());
+  }
+};
+
+StringifyBenchmark.prototype.LargeArrayJsFallback = function() {
+  for (var i = 0; i < 200; ++i) {
+    gjstest.internal.stringifyToDepth(buildLargeArray(), 5);
+  }
+};
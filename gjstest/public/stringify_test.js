@@ -193,3 +193,61 @@ StringifyTest.prototype.Inheritance = function() {
   expectEq(child.d, 4);
   expectEq('{ a: 1 }', stringify(child));
 };
+
+StringifyTest.prototype.NativeImplementationMatchesJs = function() {
+  var natives = gjstest.internal.natives;
+  if (!natives) {
+    return;
+  }
+
+  function grabArgs() { return arguments; }
+  function Parent() {}
+  function Child() {}
+  Child.prototype = new Parent;
+  Child.prototype.inherited = 1;
+
+  var child = new Child;
+  child.own = [child, Child.prototype];
+
+  var cyclic = { foo: [1, 2] };
+  cyclic.bar = { baz: cyclic, qux: cyclic.foo };
+
+  var frozenChild = Object.freeze({ taco: 'burrito' });
+  var frozenParent = Object.freeze({ a: frozenChild, b: frozenChild });
+
+  var sparse = [];
+  sparse[3] = 'foo';
+  sparse[40] = 'bar';
+  sparse.length = 45;
+
+  var longArray = [];
+  var wide = {};
+  for (var i = 0; i < 60; ++i) {
+    longArray.push(i % 2 ? { index: i } : [i]);
+    wide['key' + i] = i;
+  }
+
+  var deep = [];
+  var obj = deep;
+  for (var i = 0; i < 10; ++i) {
+    obj.push({ level: i, next: [] });
+    obj = obj[0].next;
+  }
+
+  var values = [
+    null, undefined, 0, -1.5, NaN, true, '', 'taco\nburrito\n',
+    '[object Object]', '[object Arguments]', /foo.*bar/, new Error('taco'),
+    new Date(0), function() {}, function fooBar (  a ,b,  c  ) {},
+    { toString: function() { return 'function taco( a ,b\n) {'; } },
+    { toString: function() { return 'function burrito(a, b = 2) {}'; } },
+    [], [[], {}], grabArgs(1, 'a', [2]), child, cyclic, frozenChild,
+    frozenParent, sparse, longArray, wide, deep,
+    [frozenParent, cyclic, cyclic.bar, cyclic.foo], Object.create(longArray)
+  ];
+
+  values.forEach(function(value) {
+    expectEq(
+        gjstest.internal.stringifyToDepth(value, 5),
+        natives.stringifyToDepth(value, 5));
+  });
+};
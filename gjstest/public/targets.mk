@@ -15,6 +15,17 @@ $(eval $(call compiled_js_library, \
         gjstest/public/stringify \
 ))
 
+$(eval $(call compiled_js_library, \
+    gjstest/public/clock, \
+        gjstest/internal/js/namespace \
+))
+
+$(eval $(call compiled_js_library, \
+    gjstest/public/fixtures, \
+        gjstest/internal/js/namespace \
+        gjstest/public/stringify \
+))
+
 $(eval $(call compiled_js_library, \
     gjstest/public/logging, \
         gjstest/internal/js/namespace \
@@ -42,11 +53,19 @@ $(eval $(call compiled_js_library, \
 $(eval $(call compiled_js_library, \
     gjstest/public/register, \
         gjstest/internal/js/namespace \
+        gjstest/internal/js/stack_frame \
+        gjstest/internal/js/stack_utils \
 ))
 
 $(eval $(call compiled_js_library, \
     gjstest/public/stringify, \
         gjstest/internal/js/namespace \
+        gjstest/internal/js/stats \
+))
+
+$(eval $(call compiled_js_library, \
+    gjstest/public/test_data, \
+        gjstest/internal/js/namespace \
 ))
 
 ######################################################
@@ -54,6 +73,20 @@ $(eval $(call compiled_js_library, \
 ######################################################
 
 $(eval $(call js_test,gjstest/public/actions))
+$(eval $(call js_test,gjstest/public/clock))
+$(eval $(call js_test,gjstest/public/fixtures))
+$(eval $(call js_test,gjstest/public/matcher_types))
 $(eval $(call js_test,gjstest/public/mocking))
 $(eval $(call js_test,gjstest/public/register))
 $(eval $(call js_test,gjstest/public/stringify))
+$(eval $(call js_test,gjstest/public/test_data))
+
+######################################################
+# Benchmarks
+######################################################
+
+$(eval $(call js_benchmark,gjstest/public/assertions))
+$(eval $(call js_benchmark,gjstest/public/fixtures))
+$(eval $(call js_benchmark,gjstest/public/mocking))
+$(eval $(call js_benchmark,gjstest/public/register))
+$(eval $(call js_benchmark,gjstest/public/stringify))
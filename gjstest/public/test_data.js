@@ -0,0 +1,123 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Functions for reading test data files, which let tests keep large fixtures
+// out of their JS source. Paths are relative to the directory given to the
+// gjstest binary with --test_data_dir, which for tests run with the Makefile is
+// the directory containing the test. They must not be absolute or contain
+// '..' components. These functions are only available under the gjstest
+// binary.
+
+/**
+ * Return the contents of the supplied test data file, decoded as UTF-8. Files
+ * that are pure ASCII aren't copied into the JS heap.
+ *
+ * @param {string} path
+ * @return {string}
+ */
+gjstest.readFile = function(path) {
+  return gjstest.internal.getTestDataNatives_().readFile(String(path));
+};
+
+/**
+ * Return an ArrayBuffer backed directly by a mapping of the supplied test data
+ * file, without copying it. The buffer may be modified without affecting the
+ * file or other buffers for it.
+ *
+ * @param {string} path
+ * @return {!ArrayBuffer}
+ */
+gjstest.mapFile = function(path) {
+  return gjstest.internal.getTestDataNatives_().mapFile(String(path));
+};
+
+/**
+ * Return an iterator over the lines of the supplied test data file, decoded as
+ * UTF-8, without reading the whole file into strings. Use it as follows:
+ *
+ *     for (var line of readLines('big_fixture.txt')) {
+ *       ...
+ *     }
+ *
+ * Lines may be terminated by '\n' or '\r\n', and the terminators aren't
+ * included. A final line without a terminator is included if it isn't empty.
+ *
+ * @param {string} path
+ * @return {!Iterator.<string>}
+ */
+gjstest.readLines = function(path) {
+  return new gjstest.internal.LineIterator(gjstest.mapFile(path));
+};
+
+////////////////////////////////////////////////////////////////////////
+// Implementation details
+////////////////////////////////////////////////////////////////////////
+
+/**
+ * Return the natives object, throwing an error if there isn't one.
+ *
+ * @return {!Object}
+ * @private
+ */
+gjstest.internal.getTestDataNatives_ = function() {
+  var natives = gjstest.internal.natives;
+  if (!natives) {
+    throw new Error(
+        'Test data files are only available under the gjstest binary.');
+  }
+
+  return natives;
+};
+
+/**
+ * An iterator over the lines of UTF-8 text in an array buffer.
+ *
+ * @param {!ArrayBuffer} buffer
+ * @constructor
+ */
+gjstest.internal.LineIterator = function(buffer) {
+  this.buffer_ = buffer;
+  this.bytes_ = new Uint8Array(buffer);
+  this.offset_ = 0;
+};
+
+gjstest.internal.LineIterator.prototype[Symbol.iterator] = function() {
+  return this;
+};
+
+/**
+ * @return {{done: boolean, value: (string|undefined)}}
+ */
+gjstest.internal.LineIterator.prototype.next = function() {
+  var bytes = this.bytes_;
+  var begin = this.offset_;
+  if (begin >= bytes.length) {
+    return {done: true, value: undefined};
+  }
+
+  // Find the end of the line, which is the end of the buffer if there's no
+  // terminator.
+  var newline = bytes.indexOf(0x0a, begin);
+  var end = newline == -1 ? bytes.length : newline;
+  this.offset_ = end + 1;
+
+  if (end > begin && bytes[end - 1] == 0x0d) {
+    --end;
+  }
+
+  return {
+    done: false,
+    value: gjstest.internal.natives.decodeUtf8(this.buffer_, begin, end),
+  };
+};
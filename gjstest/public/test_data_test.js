@@ -0,0 +1,121 @@
+// Copyright 2012 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The files used here are in the testdata directory next to this file, which
+// is the test data directory when the test is run with the Makefile.
+
+function TestDataTest() {}
+registerTestSuite(TestDataTest);
+
+TestDataTest.prototype.NotUnderGjstestBinary = function() {
+  if (gjstest.internal.natives) return;
+
+  expectThat(function() { readFile('testdata/ascii.txt'); },
+             throwsError(/only available under the gjstest binary/));
+  expectThat(function() { mapFile('testdata/ascii.txt'); },
+             throwsError(/only available under the gjstest binary/));
+  expectThat(function() { readLines('testdata/ascii.txt'); },
+             throwsError(/only available under the gjstest binary/));
+};
+
+TestDataTest.prototype.ReadFile = function() {
+  if (!gjstest.internal.natives) return;
+
+  expectEq('ascii text\n', readFile('testdata/ascii.txt'));
+  expectEq('', readFile('testdata/empty.txt'));
+  expectEq('taco\r\nburrito\n\nenchilada é\nqueso',
+           readFile('testdata/lines.txt'));
+};
+
+TestDataTest.prototype.MapFile = function() {
+  if (!gjstest.internal.natives) return;
+
+  var buffer = mapFile('testdata/ascii.txt');
+  expectTrue(buffer instanceof ArrayBuffer);
+  expectEq(11, buffer.byteLength);
+
+  var bytes = new Uint8Array(buffer);
+  expectEq('a'.charCodeAt(0), bytes[0]);
+  expectEq('\n'.charCodeAt(0), bytes[10]);
+
+  expectEq(0, mapFile('testdata/empty.txt').byteLength);
+};
+
+TestDataTest.prototype.MappingsAreCopiedOnWrite = function() {
+  if (!gjstest.internal.natives) return;
+
+  var bytes1 = new Uint8Array(mapFile('testdata/ascii.txt'));
+  var bytes2 = new Uint8Array(mapFile('testdata/ascii.txt'));
+  bytes1[0] = 'A'.charCodeAt(0);
+
+  expectEq('a'.charCodeAt(0), bytes2[0]);
+  expectEq('ascii text\n', readFile('testdata/ascii.txt'));
+};
+
+TestDataTest.prototype.ReadLines = function() {
+  if (!gjstest.internal.natives) return;
+
+  var lines = [];
+  for (var line of readLines('testdata/lines.txt')) {
+    lines.push(line);
+  }
+
+  expectThat(lines,
+             elementsAre(['taco', 'burrito', '', 'enchilada é', 'queso']));
+
+  expectThat(Array.from(readLines('testdata/ascii.txt')),
+             elementsAre(['ascii text']));
+  expectThat(Array.from(readLines('testdata/empty.txt')), elementsAre([]));
+};
+
+TestDataTest.prototype.DecodeUtf8RejectsBadArguments = function() {
+  if (!gjstest.internal.natives) return;
+
+  var decodeUtf8 = gjstest.internal.natives.decodeUtf8;
+  var buffer = new Uint8Array([0x74, 0x61, 0x63, 0x6f]).buffer;
+  expectEq('ac', decodeUtf8(buffer, 1, 3));
+
+  expectThat(function() { decodeUtf8(new Uint8Array(buffer), 0, 1); },
+             throwsError(/Only ArrayBuffers can be decoded/));
+  expectThat(function() { decodeUtf8(buffer, 3, 1); },
+             throwsError(/outside of the buffer/));
+  expectThat(function() { decodeUtf8(buffer, 0, 5); },
+             throwsError(/outside of the buffer/));
+  expectThat(function() { gjstest.internal.natives.deserializeValue('taco'); },
+             throwsError(/must be ArrayBuffers/));
+};
+
+TestDataTest.prototype.MissingFile = function() {
+  if (!gjstest.internal.natives) return;
+
+  expectThat(function() { readFile('testdata/taco.txt'); },
+             throwsError(/Error opening .*testdata\/taco.txt/));
+  expectThat(function() { mapFile('testdata/taco.txt'); },
+             throwsError(/Error opening .*testdata\/taco.txt/));
+};
+
+TestDataTest.prototype.PathsOutsideDirectory = function() {
+  if (!gjstest.internal.natives) return;
+
+  var paths = ['', '/etc/passwd', '../public/testdata/ascii.txt',
+               'testdata/../../public/testdata/ascii.txt', 'testdata/..'];
+
+  for (var i = 0; i < paths.length; ++i) {
+    var path = paths[i];
+    expectThat(function() { readFile(path); },
+               throwsError(/relative and within the directory/));
+    expectThat(function() { mapFile(path); },
+               throwsError(/relative and within the directory/));
+  }
+};
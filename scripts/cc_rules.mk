@@ -161,3 +161,35 @@ $(1).out : $(1).bin scripts/cc_test_run.sh
 CC_TESTS += $(1).out
 
 endef
+
+# Define a C++ benchmark, a binary that writes a JSON report of its results.
+#
+# Arg 1:
+#     Name of the benchmark, including a path. It is assumed that the relevant
+#     source file is $(1).cc, and that there is no header files. The binary
+#     must accept an --output_file flag saying where to write the report.
+#
+# Arg 2:
+#     Space-separated list of dependencies, also defined with this rule. The
+#     benchmark is allowed to pull in (name).h for each of these dependencies.
+#
+# Arg 3:
+#     Extra flags for g++, if any.
+#
+# Arg 4:
+#     Extra flags for the benchmark when it is run, if any.
+#
+CC_BENCHMARKS =
+
+define cc_benchmark
+
+# Create a binary for the benchmark.
+$(eval $(call cc_binary,$(1),$(2),$(3)))
+
+# Create a rule that will run the benchmark and write out its report.
+$(1).json : $(1).bin
+	./$(strip $(1)).bin --output_file=$(strip $(1)).json $(4)
+
+CC_BENCHMARKS += $(1).json
+
+endef
@@ -70,8 +70,29 @@ $(eval $(call js_library,$(1)_test,$(1)))
 # use_global_namespace deps target, because the shell script tests it for
 # duplicates.
 $(1)_test.out : $(1)_test.deps scripts/js_test_run.sh gjstest/internal/js/use_global_namespace.deps gjstest/internal/cpp/gjstest.bin share
-	./scripts/js_test_run.sh $(1)_test
+	./scripts/js_test_run.sh test $(1)_test
 
 JS_TESTS += $(1)_test.out
 
 endef
+
+# Define a JS benchmark: a file of tests, each of which does something expensive
+# enough that the time it takes is worth tracking.
+#
+# Arg 1:
+#     The name of the library to benchmark, including a path. It is assumed
+#     that the relevant file is $(1)_benchmark.js.
+#
+define js_benchmark
+
+# Create a library target for the benchmark.
+$(eval $(call js_library,$(1)_benchmark,$(1)))
+
+# Create a rule that will run the benchmark and write out an XML report with
+# the time taken by each of its tests.
+$(1)_benchmark.xml : $(1)_benchmark.deps scripts/js_test_run.sh gjstest/internal/js/use_global_namespace.deps gjstest/internal/cpp/gjstest.bin share
+	./scripts/js_test_run.sh benchmark $(1)_benchmark
+
+JS_BENCHMARKS += $(1)_benchmark.xml
+
+endef
@@ -1,23 +1,41 @@
 #!/bin/bash
 #
-# Run gjstest for a test target.
+# Run gjstest for a test or benchmark target.
 #
 # Usage:
 #
-#     ./js_test_run.sh foo/target
+#     ./js_test_run.sh test foo/target
+#     ./js_test_run.sh benchmark foo/target
 #
-# The file foo/target.deps must already exist.
+# The file foo/target.deps must already exist. A test writes foo/target.out
+# once it passes; a benchmark writes an XML report that includes the time
+# taken by each test to foo/target.xml.
 
-if [[ $# -ne 1 ]]; then
-  echo "Usage: $0 TARGET"
+if [[ $# -ne 2 ]]; then
+  echo "Usage: $0 test|benchmark TARGET"
   exit 1
 fi
 
-TARGET=$1
-shift
+MODE=$1
+TARGET=$2
+shift 2
 
 DEPS_FILE="$TARGET.deps"
-OUTPUT_FILE="$TARGET.out"
+
+case "$MODE" in
+  test)
+    OUTPUT_FILE="$TARGET.out"
+    EXTRA_FLAGS=()
+    ;;
+  benchmark)
+    OUTPUT_FILE="$TARGET.xml"
+    EXTRA_FLAGS=("--xml_output_file=$OUTPUT_FILE")
+    ;;
+  *)
+    echo "Unknown mode: $MODE"
+    exit 1
+    ;;
+esac
 
 # Build an appropriate invocation.
 JS_FILES=
@@ -35,7 +53,13 @@ JOINED_JS_FILES=$(printf ",%s" "${JS_FILES[@]}")
 JOINED_JS_FILES=${JOINED_JS_FILES:1}
 
 set -x
-gjstest/internal/cpp/gjstest.bin --data_dir=share/gjstest "--js_files=$JOINED_JS_FILES" || exit 1
+gjstest/internal/cpp/gjstest.bin \
+    --data_dir=share/gjstest \
+    "--test_data_dir=$(dirname $TARGET)" \
+    "--js_files=$JOINED_JS_FILES" \
+    "${EXTRA_FLAGS[@]}" || exit 1
 set +x
 
-echo "ok" > $OUTPUT_FILE
+if [[ "$MODE" == test ]]; then
+  echo "ok" > $OUTPUT_FILE
+fi